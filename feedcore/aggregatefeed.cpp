@@ -5,6 +5,7 @@
 
 #include "aggregatefeed.h"
 #include "article.h"
+#include "updatepacer.h"
 using namespace FeedCore;
 
 class AggregateFeed::Updater : public Feed::Updater
@@ -20,7 +21,7 @@ public:
         if (auto *af = qobject_cast<AggregateFeed *>(feed())) {
             // TODO need to pass the pending update timestamp
             for (auto *subfeed : std::as_const(af->m_feeds)) {
-                subfeed->updater()->start(updateStartTime());
+                subfeed->updater()->startPaced(af->m_updatePacer, updateStartTime());
             }
             finish();
         }
@@ -28,6 +29,9 @@ public:
 
     void abort() final
     {
+        if (cancelPending()) {
+            return;
+        }
         if (auto *af = qobject_cast<AggregateFeed *>(feed())) {
             for (auto *subfeed : std::as_const(af->m_active)) {
                 subfeed->updater()->abort();
@@ -112,6 +116,11 @@ void AggregateFeed::syncFeedStatus(Feed *sender)
     setFeedActive(sender, sender->status() == LoadStatus::Updating);
 }
 
+void AggregateFeed::setUpdatePacer(UpdatePacer *pacer)
+{
+    m_updatePacer = pacer;
+}
+
 void AggregateFeed::setIdleStatus(LoadStatus status)
 {
     // the status to use when no feeds are updating.
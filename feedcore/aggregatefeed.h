@@ -4,6 +4,7 @@
  */
 #pragma once
 #include "feed.h"
+#include <QPointer>
 #include <QSet>
 
 namespace FeedCore
@@ -23,12 +24,14 @@ protected:
     void addFeed(Feed *feed);
     void removeFeed(Feed *feed);
     void setIdleStatus(FeedCore::Feed::LoadStatus status);
+    void setUpdatePacer(FeedCore::UpdatePacer *pacer);
 
 private:
     class Updater;
     QSet<Feed *> m_feeds;
     QSet<Feed *> m_active;
     Updater *m_updater{nullptr};
+    QPointer<UpdatePacer> m_updatePacer;
     LoadStatus m_idleStatus{Feed::Idle};
     void onUnreadCountChanged(int delta);
     void onArticleAdded(const ArticleRef &article);
@@ -7,7 +7,9 @@
 #include "context.h"
 #include "feed.h"
 #include "readability/readability.h"
+#include "readability/readabilityprefetchscheduler.h"
 #include "readability/readabilityresult.h"
+#include "readability/readablecontentcache.h"
 #include <QLocale>
 
 using namespace FeedCore;
@@ -63,6 +65,21 @@ void Article::setUrl(const QUrl &url)
     }
 }
 
+void Article::loadReadableContent(Readability *readability)
+{
+    // another article may have already fetched the same page
+    QFuture<ReadableContentCache::Entry> cached = ReadableContentCache::lookup(url());
+    Future::safeThen(cached, this, [this, readability = QPointer<Readability>(readability)](auto &fut) {
+        const ReadableContentCache::Entry &entry = fut.result();
+        if (entry.isFresh()) {
+            emit gotContent(entry.content, ReadableContent);
+            cacheReadableContent(entry.content);
+            return;
+        }
+        reloadReadableContent(readability);
+    });
+}
+
 void Article::reloadReadableContent(Readability *readability)
 {
     if (readability == nullptr) {
@@ -70,7 +87,7 @@ void Article::reloadReadableContent(Readability *readability)
         return;
     }
 
-    ReadabilityResult *result = readability->fetch(url());
+    ReadabilityResult *result = readability->fetch(url(), Readability::InteractivePriority);
     QObject::connect(result, &ReadabilityResult::finished, this, [this](auto content) {
         emit gotContent(content, ReadableContent);
         cacheReadableContent(content);
@@ -95,7 +112,7 @@ void Article::requestReadableContent(Readability *readability, bool forceReload)
     QFuture<QString> fut = getCachedReadableContent();
     if (fut.isCanceled()) {
         // no cache
-        reloadReadableContent(readability);
+        loadReadableContent(readability);
         return;
     }
 
@@ -106,12 +123,15 @@ void Article::requestReadableContent(Readability *readability, bool forceReload)
         }
 
         // cache miss
-        reloadReadableContent(readability);
+        loadReadableContent(readability);
     });
 }
 
 void Article::requestReadableContent(Context *context, bool forceReload)
 {
+    if (auto *scheduler = context->prefetchScheduler()) {
+        scheduler->noteFeedOpened(feed());
+    }
     requestReadableContent(context->getReadability(), forceReload);
 }
 
@@ -119,6 +139,11 @@ void Article::cacheReadableContent(const QString & /* readableContent */)
 {
 }
 
+QFuture<QString> Article::getContent()
+{
+    return QFuture<QString>();
+}
+
 QFuture<QString> Article::getCachedReadableContent()
 {
     return QFuture<QString>();
@@ -72,6 +72,16 @@ public:
      */
     Q_INVOKABLE virtual void requestContent() = 0;
 
+    /**
+     * Get the content of the article without emitting gotContent.
+     *
+     * This is for work that happens in the background, such as prefetching, which
+     * shouldn't be delivered to pages that are showing the article.  The default
+     * implementation returns a canceled future, for articles that can only deliver
+     * their content through requestContent().
+     */
+    virtual QFuture<QString> getContent();
+
     /**
      * Requests the content of the article's linked web page.
      *
@@ -164,6 +174,7 @@ private:
     bool m_starred{false};
 
     void setDefaultTitle();
+    void loadReadableContent(FeedCore::Readability *readability);
     void reloadReadableContent(FeedCore::Readability *readability);
 };
 }
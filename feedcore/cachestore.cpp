@@ -0,0 +1,248 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "cachestore.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <vector>
+using namespace FeedCore;
+
+/* the index is split into this many independently locked shards */
+static constexpr const int kShardCount = 16;
+
+/* eviction removes entries until the cache is at this percentage of its maximum size */
+static constexpr const int kEvictionTargetPercent = 90;
+
+/* length of a hex-encoded SHA-1 key */
+static constexpr const int kKeyLength = 40;
+
+static const QLatin1String kMetaDataSuffix(".meta");
+
+namespace
+{
+struct CacheEntry {
+    qint64 size{0};
+    qint64 lastAccess{0};
+};
+
+struct CacheShard {
+    QMutex mutex;
+    QHash<QByteArray, CacheEntry> index;
+
+    // held while the files are read or written, separately from the index
+    QMutex fileMutex;
+};
+}
+
+struct CacheStore::PrivData {
+    QString directory;
+    std::array<CacheShard, kShardCount> shards;
+    std::atomic<qint64> size{0};
+    std::atomic<qint64> maximumSize{0};
+    std::atomic<bool> evicting{false};
+    std::atomic<qint64> clock{0};
+
+    CacheShard &shardForKey(const QByteArray &key);
+    void loadIndex();
+    qint64 tick();
+};
+
+CacheStore::CacheStore(const QString &directory, qint64 maximumSize)
+    : d{std::make_unique<PrivData>()}
+{
+    d->directory = directory.endsWith(QLatin1Char('/')) ? directory : directory + QLatin1Char('/');
+    d->maximumSize = maximumSize;
+    d->loadIndex();
+}
+
+CacheStore::~CacheStore() = default;
+
+QByteArray CacheStore::keyForUrl(const QUrl &url)
+{
+    return QCryptographicHash::hash(url.toEncoded(), QCryptographicHash::Sha1).toHex();
+}
+
+QString CacheStore::pathForKey(const QByteArray &key) const
+{
+    return d->directory + QLatin1String(key.left(2)) + QLatin1Char('/') + QLatin1String(key);
+}
+
+QString CacheStore::metaDataPathForKey(const QByteArray &key) const
+{
+    return pathForKey(key) + kMetaDataSuffix;
+}
+
+bool CacheStore::removeFiles(const QByteArray &key) const
+{
+    QFile::remove(metaDataPathForKey(key));
+    return QFile::remove(pathForKey(key));
+}
+
+qint64 CacheStore::PrivData::tick()
+{
+    // strictly increasing, so that accesses within the same millisecond are still ordered
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    qint64 last = clock;
+    qint64 next = 0;
+    do {
+        next = std::max(now, last + 1);
+    } while (!clock.compare_exchange_weak(last, next));
+    return next;
+}
+
+CacheShard &CacheStore::PrivData::shardForKey(const QByteArray &key)
+{
+    return shards.at(qHash(key) % kShardCount);
+}
+
+QMutex &CacheStore::fileLock(const QByteArray &key)
+{
+    return d->shardForKey(key).fileMutex;
+}
+
+void CacheStore::PrivData::loadIndex()
+{
+    QDirIterator it(directory, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo &info = it.fileInfo();
+        QByteArray key = info.fileName().toLatin1();
+        if (key.size() == kKeyLength + kMetaDataSuffix.size() && key.endsWith(kMetaDataSuffix.data())) {
+            key.chop(kMetaDataSuffix.size());
+        }
+
+        // temporary files from a write that was interrupted
+        if (key.size() != kKeyLength) {
+            QFile::remove(info.filePath());
+            continue;
+        }
+        CacheShard &shard = shardForKey(key);
+        CacheEntry &entry = shard.index[key];
+        entry.size += info.size();
+        entry.lastAccess = std::max(entry.lastAccess, info.lastModified().toMSecsSinceEpoch());
+        clock = std::max<qint64>(clock, entry.lastAccess);
+        size += info.size();
+    }
+}
+
+bool CacheStore::contains(const QByteArray &key)
+{
+    CacheShard &shard = d->shardForKey(key);
+    QMutexLocker lock(&shard.mutex);
+    return shard.index.contains(key);
+}
+
+void CacheStore::touch(const QByteArray &key)
+{
+    CacheShard &shard = d->shardForKey(key);
+    QMutexLocker lock(&shard.mutex);
+    const auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        it->lastAccess = d->tick();
+    }
+}
+
+void CacheStore::add(const QByteArray &key, qint64 size)
+{
+    CacheShard &shard = d->shardForKey(key);
+    QMutexLocker lock(&shard.mutex);
+    CacheEntry &entry = shard.index[key];
+    d->size += size - entry.size;
+    entry.size = size;
+    entry.lastAccess = d->tick();
+}
+
+bool CacheStore::drop(const QByteArray &key)
+{
+    CacheShard &shard = d->shardForKey(key);
+    QMutexLocker lock(&shard.mutex);
+    const auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        return false;
+    }
+    d->size -= it->size;
+    shard.index.erase(it);
+    return true;
+}
+
+void CacheStore::dropAll()
+{
+    for (CacheShard &shard : d->shards) {
+        QMutexLocker lock(&shard.mutex);
+        for (const auto &entry : std::as_const(shard.index)) {
+            d->size -= entry.size;
+        }
+        shard.index.clear();
+    }
+
+    // nothing else holds more than one of these at a time, so taking them all can't deadlock
+    for (CacheShard &shard : d->shards) {
+        shard.fileMutex.lock();
+    }
+    QDir(d->directory).removeRecursively();
+    for (CacheShard &shard : d->shards) {
+        shard.fileMutex.unlock();
+    }
+}
+
+void CacheStore::evictIfNeeded()
+{
+    const qint64 maximum = d->maximumSize;
+    if (d->size <= maximum || d->evicting.exchange(true)) {
+        return;
+    }
+
+    // snapshot the index one shard at a time, so that lookups are never blocked for long
+    struct Candidate {
+        qint64 lastAccess;
+        QByteArray key;
+    };
+    std::vector<Candidate> candidates;
+    for (CacheShard &shard : d->shards) {
+        QMutexLocker lock(&shard.mutex);
+        for (auto it = shard.index.cbegin(); it != shard.index.cend(); ++it) {
+            candidates.push_back({it->lastAccess, it.key()});
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+        return a.lastAccess < b.lastAccess;
+    });
+
+    const qint64 target = maximum / 100 * kEvictionTargetPercent;
+    for (const Candidate &candidate : candidates) {
+        if (d->size <= target) {
+            break;
+        }
+        if (drop(candidate.key)) {
+            QMutexLocker lock(&fileLock(candidate.key));
+            removeFiles(candidate.key);
+        }
+    }
+    d->evicting = false;
+}
+
+qint64 CacheStore::size() const
+{
+    return d->size;
+}
+
+qint64 CacheStore::maximumSize() const
+{
+    return d->maximumSize;
+}
+
+void CacheStore::setMaximumSize(qint64 maximumSize)
+{
+    d->maximumSize = maximumSize;
+    evictIfNeeded();
+}
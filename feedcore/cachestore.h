@@ -0,0 +1,75 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <QUrl>
+#include <memory>
+
+namespace FeedCore
+{
+
+/**
+ * The index of an on-disk cache directory
+ *
+ * Each entry is a file named for its key, and optionally a metadata file next to it,
+ * that the owner of the store reads and writes itself.  Keeping the metadata separate
+ * lets it be replaced without rewriting the entry.  The store keeps track of the size and last use of each entry,
+ * and evicts the least recently used entries once the directory grows past
+ * maximumSize().  It is safe to use from several threads at once: the index is split
+ * into shards with their own locks, and no lock is held while evicting files.
+ */
+class CacheStore
+{
+public:
+    CacheStore(const QString &directory, qint64 maximumSize);
+    ~CacheStore();
+
+    static QByteArray keyForUrl(const QUrl &url);
+    QString pathForKey(const QByteArray &key) const;
+    QString metaDataPathForKey(const QByteArray &key) const;
+
+    bool contains(const QByteArray &key);
+    void touch(const QByteArray &key);
+
+    /**
+     * Record that the files for /key/ have been written with /size/ bytes in total.
+     */
+    void add(const QByteArray &key, qint64 size);
+
+    /**
+     * Forget about /key/, returning false if it wasn't in the index.  The caller
+     * removes the files with removeFiles().
+     */
+    bool drop(const QByteArray &key);
+
+    /**
+     * Remove the entry and metadata files for /key/, returning false if there was no entry file.
+     * The caller holds fileLock().
+     */
+    bool removeFiles(const QByteArray &key) const;
+
+    /**
+     * The lock that is held while the files for /key/ are read or written, so that the
+     * metadata of one write is never read with the entry of another.  Keys in the same
+     * shard share a lock, so it must not be held while taking the lock for another key,
+     * or while calling evictIfNeeded() or dropAll().
+     */
+    QMutex &fileLock(const QByteArray &key);
+    void dropAll();
+
+    void evictIfNeeded();
+    qint64 size() const;
+    qint64 maximumSize() const;
+    void setMaximumSize(qint64 maximumSize);
+
+private:
+    struct PrivData;
+    std::unique_ptr<PrivData> d;
+};
+
+}
@@ -8,6 +8,7 @@ CategoryFeed::CategoryFeed(FeedCore::Context *ctx, const QString &category, QObj
     : AggregateFeed(parent)
 {
     setName(category);
+    setUpdatePacer(ctx->updatePacer());
     const QSet<Feed *> categories = ctx->getCategoryFeeds(category);
     for (auto *f : categories) {
         addFeed(f);
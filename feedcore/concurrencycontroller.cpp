@@ -0,0 +1,117 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "concurrencycontroller.h"
+#include <algorithm>
+using namespace FeedCore;
+
+/* each window has at least this many samples, or half of the limit if that's larger */
+static constexpr const int kMinWindowSamples = 8;
+
+/* the limit grows by this many slots after a healthy window */
+static constexpr const int kIncreaseStep = 2;
+
+/* the limit is multiplied by this after an overloaded window */
+static constexpr const double kDecreaseFactor = 0.75;
+
+/* more congestion failures than this percentage of a window means overload */
+static constexpr const int kMaxCongestedPercent = 10;
+
+/* latency above this multiple of the baseline means overload */
+static constexpr const double kLatencyTolerance = 2.0;
+
+/* a drop in throughput below this fraction of the previous window means overload */
+static constexpr const double kThroughputTolerance = 0.9;
+
+/* how fast the latency baseline follows latencies that are worse than the baseline */
+static constexpr const double kBaselineDrift = 0.05;
+
+int ConcurrencyController::limit() const
+{
+    return m_limit;
+}
+
+int ConcurrencyController::minimum() const
+{
+    return m_minimum;
+}
+
+void ConcurrencyController::setMinimum(int minimum)
+{
+    m_minimum = std::max(1, minimum);
+    m_maximum = std::max(m_maximum, m_minimum);
+    m_limit = std::clamp(m_limit, m_minimum, m_maximum);
+}
+
+int ConcurrencyController::maximum() const
+{
+    return m_maximum;
+}
+
+void ConcurrencyController::setMaximum(int maximum)
+{
+    m_maximum = std::max(1, maximum);
+    m_minimum = std::min(m_minimum, m_maximum);
+    m_limit = std::clamp(m_limit, m_minimum, m_maximum);
+}
+
+void ConcurrencyController::recordResponse(qint64 latency, qint64 bytes, bool limited, qint64 timestamp)
+{
+    m_latencyTotal += latency;
+    m_latencySamples++;
+    m_bytes += bytes;
+    addSample(limited, timestamp);
+}
+
+void ConcurrencyController::recordCongestion(bool limited, qint64 timestamp)
+{
+    m_congested++;
+    addSample(limited, timestamp);
+}
+
+void ConcurrencyController::addSample(bool limited, qint64 timestamp)
+{
+    if (m_windowStart < 0) {
+        m_windowStart = timestamp;
+    }
+    m_samples++;
+    m_limited = m_limited || limited;
+    if (m_samples >= std::max(kMinWindowSamples, m_limit / 2)) {
+        adjust(timestamp);
+    }
+}
+
+void ConcurrencyController::adjust(qint64 timestamp)
+{
+    const double throughput = m_bytes * 1000.0 / std::max<qint64>(1, timestamp - m_windowStart);
+    bool overloaded = m_congested * 100 > m_samples * kMaxCongestedPercent;
+    if (m_latencySamples > 0) {
+        const double latency = static_cast<double>(m_latencyTotal) / m_latencySamples;
+        if (m_baselineLatency <= 0 || latency < m_baselineLatency) {
+            m_baselineLatency = latency;
+        } else {
+            overloaded = overloaded || latency > m_baselineLatency * kLatencyTolerance;
+            m_baselineLatency += (latency - m_baselineLatency) * kBaselineDrift;
+        }
+    }
+    overloaded = overloaded || (m_lastWasIncrease && throughput < m_lastThroughput * kThroughputTolerance);
+
+    if (overloaded) {
+        m_limit = std::max(m_minimum, static_cast<int>(m_limit * kDecreaseFactor));
+        m_lastWasIncrease = false;
+    } else if (m_limited && m_limit < m_maximum) {
+        // only grow when requests are actually waiting for a slot
+        m_limit = std::min(m_maximum, m_limit + kIncreaseStep);
+        m_lastWasIncrease = true;
+    } else {
+        m_lastWasIncrease = false;
+    }
+
+    m_lastThroughput = throughput;
+    m_windowStart = -1;
+    m_samples = m_congested = m_latencySamples = 0;
+    m_latencyTotal = m_bytes = 0;
+    m_limited = false;
+}
@@ -0,0 +1,71 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+#include <QtGlobal>
+
+namespace FeedCore
+{
+/**
+ * Chooses how many requests NetworkAccessManager runs at once
+ *
+ * The limit follows an additive-increase/multiplicative-decrease rule. Responses are
+ * collected into sample windows; at the end of each window the limit shrinks by a
+ * quarter if the network looks overloaded, and otherwise grows by a few slots if
+ * requests had to wait for one. The network looks overloaded when:
+ *  - many requests failed with timeouts or dropped connections, or
+ *  - the time to the response headers rose well above the best that we've seen, or
+ *  - throughput dropped after the previous increase.
+ *
+ * Timestamps are msecs from an arbitrary monotonic clock.
+ */
+class ConcurrencyController
+{
+public:
+    static constexpr const int kDefaultMinimum = 4;
+    static constexpr const int kDefaultMaximum = 256;
+    static constexpr const int kInitialLimit = 32;
+
+    int limit() const;
+
+    int minimum() const;
+    void setMinimum(int minimum);
+    int maximum() const;
+    void setMaximum(int maximum);
+
+    /**
+     * Record a response that arrived /latency/ msecs after the request was started.
+     *
+     * /limited/ is whether other requests were waiting for a slot when it finished.
+     */
+    void recordResponse(qint64 latency, qint64 bytes, bool limited, qint64 timestamp);
+
+    /**
+     * Record a request that failed in a way that suggests the network is overloaded.
+     */
+    void recordCongestion(bool limited, qint64 timestamp);
+
+private:
+    int m_limit{kInitialLimit};
+    int m_minimum{kDefaultMinimum};
+    int m_maximum{kDefaultMaximum};
+
+    // the current sample window
+    qint64 m_windowStart{-1};
+    int m_samples{0};
+    int m_congested{0};
+    int m_latencySamples{0};
+    qint64 m_latencyTotal{0};
+    qint64 m_bytes{0};
+    bool m_limited{false};
+
+    double m_baselineLatency{0};
+    double m_lastThroughput{0};
+    bool m_lastWasIncrease{false};
+
+    void addSample(bool limited, qint64 timestamp);
+    void adjust(qint64 timestamp);
+};
+}
@@ -12,11 +12,16 @@
 #include "opmlreader.h"
 #include "provisionalfeed.h"
 #include "readability/readabilityprefetchrule.h"
+#include "readability/readabilityprefetchscheduler.h"
 #include "scheduler.h"
 #include "storage.h"
+#include "updatepacer.h"
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QJsonDocument>
 #include <QNetworkInformation>
+#include <QSaveFile>
 #include <QSet>
 
 #ifdef QReadable_FOUND
@@ -52,14 +57,25 @@ struct Context::PrivData {
     qint64 updateInterval{0};
     qint64 expireAge{0};
     Scheduler *updateScheduler;
+    UpdatePacer *updatePacer;
     Readability *readability{nullptr};
     QFlags<ContextFlags> flags;
     QWeakPointer<AllItemsFeed> allItemsFeed{nullptr};
     std::unique_ptr<AutomationEngine> automationEngine;
     QPointer<AbstractAutomationRule> prefetchContentRule{nullptr};
+    QPointer<ReadabilityPrefetchScheduler> prefetchScheduler{nullptr};
+
+    // the bulk update in progress
+    QSet<Feed *> refreshPending;
+    QList<UpdateStats> refreshStats;
+    QElapsedTimer refreshTimer;
+
+    QJsonObject lastRefreshStats;
+    QString refreshStatsFile;
 
     PrivData(Storage *storage, Context *parent);
     void configureUpdates(Feed *feed, const QDateTime &timestamp = QDateTime::currentDateTime()) const;
+    void adaptUpdateInterval(Feed *feed) const;
     void configureExpiration(Feed *feed) const;
 };
 
@@ -86,8 +102,10 @@ Context::PrivData::PrivData(Storage *storage, Context *parent)
     : parent(parent)
     , storage(storage)
     , updateScheduler(new Scheduler(parent))
+    , updatePacer(new UpdatePacer(storage, parent))
 {
     storage->setParent(parent);
+    updateScheduler->setUpdatePacer(updatePacer);
 }
 
 void Context::PrivData::configureUpdates(Feed *feed, const QDateTime &timestamp) const
@@ -97,6 +115,9 @@ void Context::PrivData::configureUpdates(Feed *feed, const QDateTime &timestamp)
     if (updateMode == Feed::InheritUpdateMode) {
         feed->setUpdateInterval(updateInterval);
         shouldSchedule = flags.testFlag(FeedsScheduledByDefault);
+    } else if (updateMode == Feed::AdaptiveUpdateMode) {
+        adaptUpdateInterval(feed);
+        shouldSchedule = true;
     } else {
         shouldSchedule = (updateMode != Feed::DisableUpdateMode);
     }
@@ -108,6 +129,17 @@ void Context::PrivData::configureUpdates(Feed *feed, const QDateTime &timestamp)
     }
 }
 
+void Context::PrivData::adaptUpdateInterval(Feed *feed) const
+{
+    QFuture<QDateTime> q = feed->getPublicationDates(Scheduler::kAdaptiveSampleSize);
+    Future::safeThen(q, feed, [feed](auto &q) {
+        // the mode might have changed while we were waiting
+        if (feed->updateMode() == Feed::AdaptiveUpdateMode) {
+            feed->setUpdateInterval(Scheduler::adaptiveUpdateInterval(Future::safeResults(q)));
+        }
+    });
+}
+
 void Context::PrivData::configureExpiration(Feed *feed) const
 {
     auto expireMode{feed->expireMode()};
@@ -355,6 +387,11 @@ Readability *Context::getReadability()
     return d->readability;
 }
 
+ReadabilityPrefetchScheduler *Context::prefetchScheduler()
+{
+    return d->prefetchScheduler;
+}
+
 AutomationEngine *Context::automationEngine()
 {
     if (d->automationEngine == nullptr) {
@@ -363,6 +400,11 @@ AutomationEngine *Context::automationEngine()
     return d->automationEngine.get();
 }
 
+UpdatePacer *Context::updatePacer()
+{
+    return d->updatePacer;
+}
+
 bool Context::feedListComplete()
 {
     return d->flags.testFlag(PrivData::FeedListComplete);
@@ -410,10 +452,22 @@ void Context::registerFeeds(const QList<Feed *> &feeds)
         d->configureUpdates(feed, timestamp);
         QObject::connect(feed, &QObject::destroyed, this, [this, feed] {
             d->feeds.remove(feed);
+            if (d->refreshPending.remove(feed) && d->refreshPending.isEmpty()) {
+                finishRefresh();
+            }
+        });
+        QObject::connect(feed, &Feed::statusChanged, this, [this, feed] {
+            onFeedStatusChanged(feed);
         });
         QObject::connect(feed, &Feed::updateModeChanged, this, [this, feed] {
             d->configureUpdates(feed);
         });
+        QObject::connect(feed, &Feed::lastUpdateChanged, this, [this, feed] {
+            // new articles may have changed the publishing rate
+            if (feed->updateMode() == Feed::AdaptiveUpdateMode) {
+                d->adaptUpdateInterval(feed);
+            }
+        });
         QObject::connect(feed, &Feed::expireModeChanged, this, [this, feed] {
             d->configureExpiration(feed);
         });
@@ -434,9 +488,61 @@ void Context::startUpdatesForAllFeeds()
 {
     const auto &timestamp = QDateTime::currentDateTime();
     const auto &feeds = d->feeds;
+    if (d->refreshPending.isEmpty()) {
+        d->refreshStats.clear();
+        d->refreshTimer.start();
+    }
+    d->refreshPending.unite(feeds);
     for (Feed *const entry : feeds) {
-        entry->updater()->start(timestamp);
+        entry->updater()->startPaced(d->updatePacer, timestamp);
     }
+
+    // with no feeds, there's nothing to wait for
+    if (feeds.isEmpty() && d->refreshPending.isEmpty()) {
+        finishRefresh();
+    }
+}
+
+void Context::onFeedStatusChanged(Feed *feed)
+{
+    if (feed->status() == Feed::Updating || !d->refreshPending.remove(feed)) {
+        return;
+    }
+    d->refreshStats << feed->updater()->stats();
+    if (d->refreshPending.isEmpty()) {
+        finishRefresh();
+    }
+}
+
+void Context::finishRefresh()
+{
+    d->lastRefreshStats = UpdateStats::summarize(d->refreshStats, d->refreshTimer.elapsed());
+    d->refreshStats.clear();
+    if (!d->refreshStatsFile.isEmpty()) {
+        QSaveFile file(d->refreshStatsFile);
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(QJsonDocument(d->lastRefreshStats).toJson());
+            file.commit();
+        } else {
+            qWarning() << "could not write update stats to" << d->refreshStatsFile;
+        }
+    }
+    emit refreshFinished();
+}
+
+const QJsonObject &Context::lastRefreshStats() const
+{
+    return d->lastRefreshStats;
+}
+
+const QString &Context::refreshStatsFile() const
+{
+    return d->refreshStatsFile;
+}
+
+void Context::setRefreshStatsFile(const QString &path)
+{
+    d->refreshStatsFile = path;
 }
 
 bool Context::prefetchContent() const
@@ -451,7 +557,8 @@ void Context::setPrefetchContent(bool newPrefetchContent)
     }
     if (newPrefetchContent) {
         if (d->prefetchContentRule == nullptr) {
-            d->prefetchContentRule = new ReadabilityPrefetchRule(getReadability(), this);
+            d->prefetchScheduler = new ReadabilityPrefetchScheduler(getReadability(), allItemsFeed(), this);
+            d->prefetchContentRule = new ReadabilityPrefetchRule(d->prefetchScheduler, this);
             automationEngine()->addAutomationRule(d->prefetchContentRule);
         }
     } else {
@@ -459,6 +566,7 @@ void Context::setPrefetchContent(bool newPrefetchContent)
             engine->removeAutomationRule(d->prefetchContentRule);
             d->prefetchContentRule = nullptr;
         }
+        delete d->prefetchScheduler;
     }
     emit prefetchContentChanged();
 }
@@ -467,6 +575,7 @@ AllItemsFeed::AllItemsFeed(Context *context, QObject *parent)
     : AggregateFeed(parent)
     , m_context{context}
 {
+    setUpdatePacer(context->updatePacer());
     if (!m_context->feedListComplete()) {
         setIdleStatus(Feed::Loading);
         QObject::connect(m_context, &Context::feedListCompleteChanged, this, &AllItemsFeed::onLoadComplete, Qt::SingleShotConnection);
@@ -6,6 +6,7 @@
 #pragma once
 #include "aggregatefeed.h"
 #include "future.h"
+#include <QJsonObject>
 #include <QObject>
 #include <QUrl>
 #include <Syndication/Feed>
@@ -17,7 +18,9 @@ class Storage;
 class Feed;
 class ProvisionalFeed;
 class Readability;
+class ReadabilityPrefetchScheduler;
 class AutomationEngine;
+class UpdatePacer;
 
 class Context;
 
@@ -211,8 +214,36 @@ public:
      */
     Readability *getReadability();
 
+    /**
+     * The scheduler for readable content prefetches, or null if prefetchContent is disabled.
+     */
+    ReadabilityPrefetchScheduler *prefetchScheduler();
+
     AutomationEngine *automationEngine();
 
+    /**
+     * The pacer that spreads out bulk updates of the feeds in this context.
+     *
+     * Use this to adjust the launch window and backlog limit.
+     */
+    UpdatePacer *updatePacer();
+
+    /**
+     * Measurements from the last bulk update started with requestUpdate().
+     *
+     * The result has the totals for each phase of the update pipeline and the
+     * stats for each feed (see UpdateStats::summarize), or is empty if no bulk
+     * update has finished yet.  Stats for individual updates are available from
+     * Feed::Updater::stats().
+     */
+    const QJsonObject &lastRefreshStats() const;
+
+    /**
+     * If set, lastRefreshStats() is written to this file as JSON at the end of each bulk update.
+     */
+    const QString &refreshStatsFile() const;
+    void setRefreshStatsFile(const QString &path);
+
     bool defaultUpdateEnabled() const;
     void setDefaultUpdateEnabled(bool defaultUpdateEnabled);
     qint64 defaultUpdateInterval();
@@ -245,6 +276,11 @@ signals:
      */
     void firstRun();
 
+    /**
+     * Emitted when every feed in a bulk update started with requestUpdate() has finished.
+     */
+    void refreshFinished();
+
 private:
     struct PrivData;
     std::unique_ptr<PrivData> d;
@@ -252,5 +288,7 @@ private:
     void registerFeeds(const QList<Feed *> &feeds);
     void setFeedListComplete(bool feedListComplete);
     void startUpdatesForAllFeeds();
+    void onFeedStatusChanged(Feed *feed);
+    void finishRefresh();
 };
 }
@@ -4,6 +4,9 @@
  */
 
 #include "feed.h"
+#include "updatepacer.h"
+#include <QElapsedTimer>
+#include <QPointer>
 #include <QTimer>
 using namespace FeedCore;
 
@@ -21,6 +24,11 @@ struct Feed::PrivData {
     UpdateMode expireMode{InheritUpdateMode};
     qint64 expireAge{0};
     QDateTime lastUpdate;
+    int failureCount{0};
+    QDateTime retryTime;
+    UpdateHints updateHints;
+    QUrl redirectUrl;
+    int redirectCount{0};
     int flags{0};
 };
 
@@ -149,6 +157,64 @@ void Feed::setLastUpdate(const QDateTime &lastUpdate)
     }
 }
 
+int Feed::failureCount() const
+{
+    return d->failureCount;
+}
+
+void Feed::setFailureCount(int failureCount)
+{
+    if (d->failureCount != failureCount) {
+        d->failureCount = failureCount;
+        emit failureCountChanged();
+    }
+}
+
+const QDateTime &Feed::retryTime() const
+{
+    return d->retryTime;
+}
+
+void Feed::setRetryTime(const QDateTime &retryTime)
+{
+    if (d->retryTime != retryTime) {
+        d->retryTime = retryTime;
+        emit retryTimeChanged();
+    }
+}
+
+const UpdateHints &Feed::updateHints() const
+{
+    return d->updateHints;
+}
+
+void Feed::setUpdateHints(const UpdateHints &updateHints)
+{
+    if (d->updateHints != updateHints) {
+        d->updateHints = updateHints;
+        emit updateHintsChanged();
+    }
+}
+
+const QUrl &Feed::redirectUrl() const
+{
+    return d->redirectUrl;
+}
+
+int Feed::redirectCount() const
+{
+    return d->redirectCount;
+}
+
+void Feed::setRedirect(const QUrl &redirectUrl, int redirectCount)
+{
+    if (d->redirectUrl != redirectUrl || d->redirectCount != redirectCount) {
+        d->redirectUrl = redirectUrl;
+        d->redirectCount = redirectCount;
+        emit redirectChanged();
+    }
+}
+
 Feed::UpdateMode Feed::updateMode()
 {
     return d->updateMode;
@@ -234,6 +300,12 @@ bool Feed::editable()
     return false;
 }
 
+QFuture<QDateTime> Feed::getPublicationDates(int limit)
+{
+    Q_UNUSED(limit);
+    return Future::yield<QDateTime>(this, [](auto &) {});
+}
+
 void Feed::requestDelete()
 {
     emit deleteRequested();
@@ -255,7 +327,11 @@ void Feed::setCategory(const QString &category)
 struct Feed::Updater::PrivData {
     Feed *feed;
     QDateTime updateStartTime;
+    QDateTime retryAfter;
     QString errorMsg;
+    QPointer<UpdatePacer> pacer;
+    UpdateStats stats;
+    QElapsedTimer statsTimer;
     bool active{false};
     explicit PrivData(Feed *feed)
         : feed(feed){};
@@ -267,17 +343,89 @@ Feed::Updater::Updater(Feed *feed, QObject *parent)
 {
 }
 
-Feed::Updater::~Updater() = default;
+Feed::Updater::~Updater()
+{
+    if (d->pacer) {
+        d->pacer->remove(this);
+    }
+}
 
 void Feed::Updater::start(const QDateTime &timestamp)
 {
     d->updateStartTime = timestamp;
-    if (d->feed->status() != LoadStatus::Updating) {
+    if (d->pacer) {
+        // an explicit start jumps the queue
+        d->pacer->remove(this);
+        launch();
+    } else if (d->feed->status() != LoadStatus::Updating) {
+        beginStats();
         d->feed->setStatus(LoadStatus::Updating);
         run();
     }
 }
 
+void Feed::Updater::startPaced(UpdatePacer *pacer, const QDateTime &timestamp)
+{
+    if (pacer == nullptr) {
+        start(timestamp);
+        return;
+    }
+    d->updateStartTime = timestamp;
+    if (d->feed->status() != LoadStatus::Updating) {
+        d->pacer = pacer;
+        beginStats();
+        d->feed->setStatus(LoadStatus::Updating);
+        pacer->enqueue(this);
+    }
+}
+
+void Feed::Updater::launch()
+{
+    d->pacer = nullptr;
+    d->stats.pendingMsecs = d->statsTimer.elapsed();
+    run();
+}
+
+void Feed::Updater::beginStats()
+{
+    d->stats = UpdateStats();
+    d->statsTimer.start();
+}
+
+void Feed::Updater::endStats(bool succeeded)
+{
+    d->stats.feedName = d->feed->name();
+    d->stats.url = d->feed->url();
+    d->stats.succeeded = succeeded;
+    d->stats.totalMsecs = d->statsTimer.isValid() ? d->statsTimer.elapsed() : 0;
+}
+
+const UpdateStats &Feed::Updater::stats() const
+{
+    return d->stats;
+}
+
+UpdateStats &Feed::Updater::mutableStats()
+{
+    return d->stats;
+}
+
+bool Feed::Updater::cancelPending()
+{
+    if (d->pacer.isNull()) {
+        return false;
+    }
+    d->pacer->remove(this);
+    d->pacer = nullptr;
+    aborted();
+    return true;
+}
+
+void Feed::Updater::abort()
+{
+    cancelPending();
+}
+
 QString Feed::Updater::error()
 {
     return d->errorMsg;
@@ -293,22 +441,56 @@ const QDateTime &Feed::Updater::updateStartTime()
     return d->updateStartTime;
 }
 
+const QDateTime &Feed::Updater::retryAfter()
+{
+    return d->retryAfter;
+}
+
 void Feed::Updater::finish()
 {
+    d->retryAfter = QDateTime();
     d->feed->setLastUpdate(d->updateStartTime);
+    d->feed->setFailureCount(0);
+    d->feed->setRetryTime(QDateTime());
+    endStats(true);
     d->feed->setStatus(LoadStatus::Idle);
     cleanup();
 }
 
-void Feed::Updater::setError(const QString &errorMsg)
+/* retry delays double with each consecutive failure, up to this limit (unless the update interval is longer) */
+static constexpr const qint64 kMaxRetryDelay = 24 * 60 * 60;
+
+/* stop doubling after this many failures; the delay has hit the limit long before then */
+static constexpr const int kMaxBackoffExponent = 20;
+
+static qint64 retryDelay(qint64 updateInterval, int failureCount)
+{
+    const qint64 baseDelay = qMax<qint64>(updateInterval, 1);
+    const int exponent = qBound(0, failureCount - 1, kMaxBackoffExponent);
+    return qMax(baseDelay, qMin(baseDelay << exponent, kMaxRetryDelay));
+}
+
+void Feed::Updater::setError(const QString &errorMsg, const QDateTime &retryAfter)
 {
     d->errorMsg = errorMsg;
+    d->retryAfter = retryAfter;
+
+    const int failureCount = d->feed->failureCount() + 1;
+    const QDateTime &attemptTime = d->updateStartTime.isValid() ? d->updateStartTime : QDateTime::currentDateTime();
+    QDateTime retryTime = attemptTime.addSecs(retryDelay(d->feed->updateInterval(), failureCount));
+    if (retryAfter.isValid() && retryAfter > retryTime) {
+        retryTime = retryAfter;
+    }
+    d->feed->setFailureCount(failureCount);
+    d->feed->setRetryTime(retryTime);
+    endStats(false);
     d->feed->setStatus(LoadStatus::Error);
     cleanup();
 }
 
 void Feed::Updater::aborted()
 {
+    endStats(false);
     d->feed->setStatus(LoadStatus::Idle);
     cleanup();
 }
@@ -6,6 +6,8 @@
 #pragma once
 #include "articleref.h"
 #include "future.h"
+#include "updatehints.h"
+#include "updatestats.h"
 #include <QDateTime>
 #include <QObject>
 #include <QUrl>
@@ -14,6 +16,8 @@
 
 namespace FeedCore
 {
+class UpdatePacer;
+
 /**
  * Abstract class for stored feeds.
  */
@@ -61,6 +65,16 @@ class Feed : public QObject
      */
     Q_PROPERTY(QDateTime lastUpdate READ lastUpdate NOTIFY lastUpdateChanged)
 
+    /**
+     * The number of consecutive updates that have failed.  This is reset when an update succeeds.
+     */
+    Q_PROPERTY(int failureCount READ failureCount NOTIFY failureCountChanged)
+
+    /**
+     * After a failed update, the earliest time when the update should be retried.
+     */
+    Q_PROPERTY(QDateTime retryTime READ retryTime NOTIFY retryTimeChanged)
+
     /**
      * Mode for determining when to automatically update the feed
      */
@@ -70,6 +84,7 @@ class Feed : public QObject
      * How often to update the feed.
      *
      * This is normally set by the context unless updateMode is set to OverrideUpdateMode.
+     * In AdaptiveUpdateMode, the context derives it from the feed's publication history.
      */
     Q_PROPERTY(int updateInterval READ updateInterval WRITE setUpdateInterval NOTIFY updateIntervalChanged)
 
@@ -120,6 +135,7 @@ public:
         InheritUpdateMode, /** < Use update parameters provided by the context */
         OverrideUpdateMode, /** < Use update parameters specified by the feed */
         DisableUpdateMode, /** < Disable automatic updates */
+        AdaptiveUpdateMode, /** < Choose the update interval based on how often the feed publishes */
     };
     Q_ENUM(UpdateMode)
 
@@ -138,6 +154,15 @@ public:
      */
     virtual QFuture<ArticleRef> getArticles(bool unreadFilter) = 0;
 
+    /**
+     * Returns a future representing the publication dates of the newest /limit/ articles
+     * associated with this feed, newest first.
+     *
+     * This is used to estimate how often the feed publishes.  The default implementation
+     * returns no dates.
+     */
+    virtual QFuture<QDateTime> getPublicationDates(int limit);
+
     virtual Updater *updater() = 0;
 
     virtual bool editable();
@@ -170,6 +195,25 @@ public:
     LoadStatus status() const;
     const QDateTime &lastUpdate();
     void setLastUpdate(const QDateTime &lastUpdate);
+    int failureCount() const;
+    void setFailureCount(int failureCount);
+    const QDateTime &retryTime() const;
+    void setRetryTime(const QDateTime &retryTime);
+
+    /**
+     * Scheduling hints sent with the last successful update
+     */
+    const UpdateHints &updateHints() const;
+    void setUpdateHints(const UpdateHints &updateHints);
+
+    /**
+     * The target of a permanent redirect that was followed by recent updates, and the number
+     * of consecutive updates that followed it.  Once the count reaches
+     * UpdatableFeed::permanentRedirectThreshold(), the url is changed to the target.
+     */
+    const QUrl &redirectUrl() const;
+    int redirectCount() const;
+    void setRedirect(const QUrl &redirectUrl, int redirectCount);
     UpdateMode updateMode();
     void setUpdateMode(UpdateMode updateMode);
     qint64 updateInterval();
@@ -210,6 +254,10 @@ signals:
     void unreadCountChanged(int delta);
     void statusChanged();
     void lastUpdateChanged();
+    void failureCountChanged();
+    void retryTimeChanged();
+    void updateHintsChanged();
+    void redirectChanged();
     void updateModeChanged();
     void updateIntervalChanged();
     void expireModeChanged();
@@ -244,9 +292,11 @@ public:
     /**
      * Implemented by derived classes to abort the update.
      *
-     * The implementation should call aborted() if the abort is successful.
+     * The implementation should call aborted() if the abort is successful. The base
+     * implementation withdraws an update that is still waiting in an UpdatePacer;
+     * derived classes should do the same by calling cancelPending().
      */
-    Q_INVOKABLE virtual void abort(){};
+    Q_INVOKABLE virtual void abort();
 
     /**
      * Begin an update.
@@ -255,6 +305,14 @@ public:
      */
     Q_INVOKABLE void start(const QDateTime &timestamp = QDateTime::currentDateTime());
 
+    /**
+     * Begin an update when /pacer/ allows it.
+     *
+     * The feed status and update time are set immediately, but run() is deferred until the pacer
+     * launches the update. If /pacer/ is null, this is the same as start().
+     */
+    void startPaced(FeedCore::UpdatePacer *pacer, const QDateTime &timestamp = QDateTime::currentDateTime());
+
     /**
      * The last error reported by the implementation.
      *
@@ -273,6 +331,17 @@ public:
      */
     const QDateTime &updateStartTime();
 
+    /**
+     * If the last update failed with a retry time requested by the server, that time,
+     * otherwise an invalid QDateTime.
+     */
+    const QDateTime &retryAfter();
+
+    /**
+     * Measurements for the update in progress, or for the last update if none is in progress
+     */
+    const UpdateStats &stats() const;
+
 protected:
     /**
      * Called by implemetations when an update completes successfuly.
@@ -283,17 +352,37 @@ protected:
 
     /**
      * Called by implementations when an update fails with an error
+     *
+     * This increments the feed's failure count and sets its retry time, backing off
+     * exponentially with each consecutive failure. If the server asked us to wait until
+     * /retryAfter/, the retry time will not be earlier than that.
      */
-    void setError(const QString &errorMsg);
+    void setError(const QString &errorMsg, const QDateTime &retryAfter = QDateTime());
 
     /**
      *  Called by implementations when an update is aborted
      */
     void aborted();
 
+    /**
+     * Withdraw an update that was started with startPaced() and has not been launched yet.
+     *
+     * Returns true if there was such an update.
+     */
+    bool cancelPending();
+
+    /**
+     * Used by implementations to record measurements for the update in progress
+     */
+    UpdateStats &mutableStats();
+
 private:
     struct PrivData;
     std::unique_ptr<PrivData> d;
+    void launch();
+    void beginStats();
+    void endStats(bool succeeded);
+    friend UpdatePacer;
 
     /**
      * Implemented by derived classes to perform the update.
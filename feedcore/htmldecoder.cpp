@@ -0,0 +1,94 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "htmldecoder.h"
+#include <QRegularExpression>
+#include <QStringDecoder>
+using namespace FeedCore;
+
+/* how far into the document to look for a <meta> charset declaration (same as the HTML prescan) */
+static constexpr const int kPrescanLength = 1024;
+
+static const QByteArray kUtf8Bom("\xEF\xBB\xBF");
+
+static bool isUtf8(const QByteArray &charset)
+{
+    return charset.isEmpty() || charset == "utf-8" || charset == "utf8" || charset == "unicode-1-1-utf-8";
+}
+
+/* labels that browsers treat as windows-1252, which Latin-1 covers apart from a few punctuation marks */
+static bool isLatin1(const QByteArray &charset)
+{
+    return charset == "windows-1252" || charset == "cp1252" || charset == "iso-8859-1" || charset == "iso8859-1" || charset == "latin1"
+        || charset == "l1" || charset == "us-ascii" || charset == "ascii";
+}
+
+static QByteArray charsetParameter(const QString &text, const QRegularExpression &pattern)
+{
+    const QRegularExpressionMatch &match = pattern.match(text);
+    return match.hasMatch() ? match.captured(1).toLatin1().toLower() : QByteArray();
+}
+
+static QStringDecoder decoderFor(const QByteArray &charset)
+{
+    if (isUtf8(charset)) {
+        return QStringDecoder(QStringConverter::Utf8);
+    }
+    QStringDecoder decoder(charset.constData());
+    if (!decoder.isValid() && isLatin1(charset)) {
+        decoder = QStringDecoder(QStringConverter::Latin1);
+    }
+    return decoder;
+}
+
+QByteArray HtmlDecoder::charset(const QByteArray &html, const QByteArray &contentType)
+{
+    if (html.startsWith(kUtf8Bom)) {
+        return "utf-8";
+    }
+    if (html.startsWith("\xFE\xFF")) {
+        return "utf-16be";
+    }
+    if (html.startsWith("\xFF\xFE")) {
+        return "utf-16le";
+    }
+
+    static const QRegularExpression headerPattern(R"(charset\s*=\s*["']?([A-Za-z0-9_.:+-]+))", QRegularExpression::CaseInsensitiveOption);
+    const QByteArray &declared = charsetParameter(QString::fromLatin1(contentType), headerPattern);
+    if (!declared.isEmpty()) {
+        return declared;
+    }
+
+    // covers both <meta charset="..."> and <meta http-equiv="Content-Type" content="text/html; charset=...">
+    static const QRegularExpression metaPattern(R"(<meta\s[^>]*?charset\s*=\s*["']?\s*([A-Za-z0-9_.:+-]+))", QRegularExpression::CaseInsensitiveOption);
+    const QByteArray &meta = charsetParameter(QString::fromLatin1(html.left(kPrescanLength)), metaPattern);
+
+    // a document that could be read far enough to find the tag isn't UTF-16
+    if (meta.startsWith("utf-16")) {
+        return "utf-8";
+    }
+    return meta;
+}
+
+QByteArray HtmlDecoder::toUtf8(const QByteArray &html, const QByteArray &contentType)
+{
+    const QByteArray &documentCharset = charset(html, contentType);
+    if (isUtf8(documentCharset)) {
+        return html.startsWith(kUtf8Bom) ? html.mid(kUtf8Bom.size()) : html;
+    }
+    QStringDecoder decoder = decoderFor(documentCharset);
+    if (!decoder.isValid()) {
+        return html;
+    }
+    return QString(decoder(html)).toUtf8();
+}
+
+QString HtmlDecoder::toString(const QByteArray &html, const QByteArray &contentType)
+{
+    QStringDecoder decoder = decoderFor(charset(html, contentType));
+    if (!decoder.isValid()) {
+        decoder = QStringDecoder(QStringConverter::Utf8);
+    }
+    return decoder(html);
+}
@@ -0,0 +1,42 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+namespace FeedCore
+{
+
+/**
+ * Decodes HTML documents in the character set they were sent in
+ *
+ * The charset comes from a byte order mark, the Content-Type header of the response,
+ * or a <meta> tag near the start of the document, in that order, and defaults to
+ * UTF-8.  Documents that are already UTF-8 are passed through without copying, so the
+ * bytes from the network can go straight to the gumbo parser.
+ */
+class HtmlDecoder
+{
+public:
+    /**
+     * The charset of /html/, in lower case, or an empty array if none was declared.
+     *
+     * /contentType/ is the value of the Content-Type header, if there was one.
+     */
+    static QByteArray charset(const QByteArray &html, const QByteArray &contentType = QByteArray());
+
+    /**
+     * /html/ as UTF-8.  This is /html/ itself if it was already UTF-8 or its charset isn't supported.
+     */
+    static QByteArray toUtf8(const QByteArray &html, const QByteArray &contentType = QByteArray());
+
+    /**
+     * /html/ decoded to a string.
+     */
+    static QString toString(const QByteArray &html, const QByteArray &contentType = QByteArray());
+};
+
+}
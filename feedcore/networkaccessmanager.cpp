@@ -4,28 +4,42 @@
  */
 
 #include "networkaccessmanager.h"
+#include "concurrencycontroller.h"
 #include "sharedcache.h"
+#include <QElapsedTimer>
+#include <QHash>
 #include <QNetworkReply>
+#include <QPointer>
 #include <QStack>
+#include <algorithm>
+#include <cstring>
 using namespace FeedCore;
 
 /* This is an (incomlete) proxy for QNetworkReply that gives us something
  * to return to the caller when we queue a request for later.
  *
  * The network access manager calls start() with the actual reply when
- * the request gets dequeued.
+ * the request gets dequeued. If the caller asked for a handoff with
+ * whenStarted(), the actual reply goes straight to the caller and the
+ * proxy is discarded; otherwise the proxy forwards the actual reply.
  */
 class NetworkAccessManager::DeferredNetworkReply : public QNetworkReply
 {
     QNetworkReply *m_reply{nullptr};
     NetworkAccessManager *m_nam;
+    QPointer<QObject> m_handoffContext;
+    std::function<void(QNetworkReply *)> m_handoff;
 
 public:
     explicit DeferredNetworkReply(NetworkAccessManager *parent);
     ~DeferredNetworkReply();
     void start(QNetworkReply *reply);
+    bool isStarted() const;
+    void setHandoff(QObject *context, const std::function<void(QNetworkReply *)> &callback);
+    void handOff(QNetworkReply *reply);
 
     qint64 readData(char *data, qint64 max) override;
+    qint64 bytesAvailable() const override;
     void abort() override;
     bool isSequential() const override;
     void forwardSignals();
@@ -33,25 +47,86 @@ public:
     void forwardHeaders();
 };
 
+/* A reply for a request that is coalesced with an identical request that is
+ * already in flight. It receives a copy of the headers and a shared copy
+ * of the body when the request that it follows finishes.
+ */
+class NetworkAccessManager::SharedReply : public QNetworkReply
+{
+    NetworkAccessManager *m_nam;
+    QByteArray m_body;
+    qint64 m_offset{0};
+
+public:
+    SharedReply(NetworkAccessManager *parent, QNetworkAccessManager::Operation op, const QNetworkRequest &request);
+    void deliver(QNetworkReply *source, const QByteArray &body);
+
+    qint64 readData(char *data, qint64 max) override;
+    qint64 bytesAvailable() const override;
+    void abort() override;
+    bool isSequential() const override;
+
+private:
+    void finish(QNetworkReply::NetworkError error, const QString &errorString);
+};
+
+/* A GET request that other callers can share */
+struct NetworkAccessManager::Flight {
+    QByteArray key;
+    QNetworkRequest request;
+
+    // the reply returned to the first caller, which may be deferred
+    QNetworkReply *leader{nullptr};
+
+    // the real reply, once the request has started
+    QPointer<QNetworkReply> source;
+
+    QList<QPointer<SharedReply>> followers;
+
+    // whether this was restarted for the followers after the first caller gave up
+    bool restarted{false};
+
+    bool hasFollowers() const;
+};
+
 struct NetworkAccessManager::WaitingRequest {
     QNetworkAccessManager::Operation op{QNetworkAccessManager::GetOperation};
     QNetworkRequest req{};
     QIODevice *outgoingData{nullptr};
     DeferredNetworkReply *repl{nullptr};
+    QByteArray flightKey{};
+};
+
+struct NetworkAccessManager::ActiveRequest {
+    QString host;
+    qint64 startedAt{0};
+    qint64 headersAt{-1};
+    qint64 bytes{0};
 };
 
 struct NetworkAccessManager::PrivData {
     NetworkAccessManager *parent;
     int connectionCount{0};
     QStack<WaitingRequest> waitingRequests;
+    QHash<QString, int> hostConnectionCounts;
+    int maxConnectionsPerHost{kDefaultMaxConnectionsPerHost};
+    ConcurrencyController controller;
+    QElapsedTimer clock;
+    QHash<QByteArray, std::shared_ptr<Flight>> flights;
 
     explicit PrivData(NetworkAccessManager *parent)
         : parent(parent)
     {
+        clock.start();
     }
+    bool canStart(const QNetworkRequest &request) const;
     void startWaiting();
     QNetworkReply *makeRealReply(const WaitingRequest &wr);
+    void finishRequest(QNetworkReply *reply, const ActiveRequest &active);
     void removeWaiting(DeferredNetworkReply *reply);
+    void watchFlight(const std::shared_ptr<Flight> &flight, QNetworkReply *source);
+    void completeFlight(const std::shared_ptr<Flight> &flight, QNetworkReply *source);
+    void abandonFlight(const std::shared_ptr<Flight> &flight);
 };
 
 NetworkAccessManager::DeferredNetworkReply::DeferredNetworkReply(NetworkAccessManager *parent)
@@ -70,6 +145,12 @@ NetworkAccessManager::DeferredNetworkReply::~DeferredNetworkReply()
 
 void NetworkAccessManager::DeferredNetworkReply::start(QNetworkReply *reply)
 {
+    if (m_handoff) {
+        handOff(reply);
+        deleteLater();
+        return;
+    }
+
     m_reply = reply;
     setOperation(reply->operation());
     setRequest(reply->request());
@@ -85,6 +166,30 @@ void NetworkAccessManager::DeferredNetworkReply::start(QNetworkReply *reply)
     });
 }
 
+bool NetworkAccessManager::DeferredNetworkReply::isStarted() const
+{
+    return m_reply != nullptr;
+}
+
+void NetworkAccessManager::DeferredNetworkReply::setHandoff(QObject *context, const std::function<void(QNetworkReply *)> &callback)
+{
+    m_handoffContext = context;
+    m_handoff = callback;
+}
+
+void NetworkAccessManager::DeferredNetworkReply::handOff(QNetworkReply *reply)
+{
+    const auto callback = std::move(m_handoff);
+    m_handoff = nullptr;
+    if (!m_handoffContext.isNull()) {
+        callback(reply);
+    } else if (reply != this) {
+        // nobody is waiting for this reply anymore
+        reply->abort();
+        reply->deleteLater();
+    }
+}
+
 qint64 NetworkAccessManager::DeferredNetworkReply::readData(char *data, qint64 max)
 {
     if (m_reply == nullptr || !m_reply->isOpen()) {
@@ -96,7 +201,11 @@ qint64 NetworkAccessManager::DeferredNetworkReply::readData(char *data, qint64 m
 void NetworkAccessManager::DeferredNetworkReply::abort()
 {
     if (m_reply == nullptr) {
+        if (m_handoff) {
+            handOff(this);
+        }
         setError(QNetworkReply::OperationCanceledError, "");
+        setFinished(true);
         emit finished();
         m_nam->d->removeWaiting(this);
         return;
@@ -104,6 +213,15 @@ void NetworkAccessManager::DeferredNetworkReply::abort()
     m_reply->abort();
 }
 
+qint64 NetworkAccessManager::DeferredNetworkReply::bytesAvailable() const
+{
+    // lets readAll() allocate its result in one go
+    if (m_reply == nullptr || !m_reply->isOpen()) {
+        return QNetworkReply::bytesAvailable();
+    }
+    return m_reply->bytesAvailable() + QNetworkReply::bytesAvailable();
+}
+
 bool NetworkAccessManager::DeferredNetworkReply::isSequential() const
 {
     if (m_reply == nullptr) {
@@ -120,6 +238,11 @@ void NetworkAccessManager::DeferredNetworkReply::forwardSignals()
         setError(code, m_reply->errorString());
     });
     QObject::connect(m_reply, &QNetworkReply::metaDataChanged, this, &DeferredNetworkReply::forwardHeaders);
+
+    // progress signals, for update instrumentation
+    QObject::connect(m_reply, &QNetworkReply::socketStartedConnecting, this, &QNetworkReply::socketStartedConnecting);
+    QObject::connect(m_reply, &QNetworkReply::encrypted, this, &QNetworkReply::encrypted);
+    QObject::connect(m_reply, &QNetworkReply::requestSent, this, &QNetworkReply::requestSent);
 }
 
 void NetworkAccessManager::DeferredNetworkReply::forwardAttribute(QNetworkRequest::Attribute attr)
@@ -129,10 +252,10 @@ void NetworkAccessManager::DeferredNetworkReply::forwardAttribute(QNetworkReques
 
 void NetworkAccessManager::DeferredNetworkReply::forwardHeaders()
 {
-    // this is *slow* but I don't see a way to get only the ones that changed
-    const QList<QByteArray> headers = m_reply->rawHeaderList();
-    for (const QByteArray &headerName : headers) {
-        setRawHeader(headerName, m_reply->rawHeader(headerName));
+    // there's no way to share the header list, so copy it in a single pass
+    const auto &headers = m_reply->rawHeaderPairs();
+    for (const auto &header : headers) {
+        setRawHeader(header.first, header.second);
     }
 
     forwardAttribute(QNetworkRequest::CacheLoadControlAttribute);
@@ -140,10 +263,103 @@ void NetworkAccessManager::DeferredNetworkReply::forwardHeaders()
     forwardAttribute(QNetworkRequest::HttpStatusCodeAttribute);
     forwardAttribute(QNetworkRequest::RedirectionTargetAttribute);
     forwardAttribute(QNetworkRequest::SourceIsFromCacheAttribute);
+    emit metaDataChanged();
+}
+
+NetworkAccessManager::SharedReply::SharedReply(NetworkAccessManager *parent, QNetworkAccessManager::Operation op, const QNetworkRequest &request)
+    : QNetworkReply(parent)
+    , m_nam(parent)
+{
+    setOperation(op);
+    setRequest(request);
+    setUrl(request.url());
+    setOpenMode(ReadOnly | Unbuffered);
+}
+
+void NetworkAccessManager::SharedReply::deliver(QNetworkReply *source, const QByteArray &body)
+{
+    setUrl(source->url());
+    const auto &headers = source->rawHeaderPairs();
+    for (const auto &header : headers) {
+        setRawHeader(header.first, header.second);
+    }
+    const QNetworkRequest::Attribute attributes[] = {QNetworkRequest::HttpStatusCodeAttribute,
+                                                     QNetworkRequest::HttpReasonPhraseAttribute,
+                                                     QNetworkRequest::RedirectionTargetAttribute,
+                                                     QNetworkRequest::SourceIsFromCacheAttribute};
+    for (const auto attribute : attributes) {
+        setAttribute(attribute, source->attribute(attribute));
+    }
+    emit metaDataChanged();
+
+    m_body = body;
+    if (!m_body.isEmpty()) {
+        emit readyRead();
+        emit downloadProgress(m_body.size(), m_body.size());
+    }
+    finish(source->error(), source->errorString());
+}
+
+void NetworkAccessManager::SharedReply::finish(QNetworkReply::NetworkError error, const QString &errorString)
+{
+    if (error != NoError) {
+        setError(error, errorString);
+        emit errorOccurred(error);
+    }
+    setFinished(true);
+    emit finished();
+    if (m_nam->autoDeleteReplies() || request().attribute(QNetworkRequest::AutoDeleteReplyOnFinishAttribute).toBool()) {
+        deleteLater();
+    }
+}
+
+qint64 NetworkAccessManager::SharedReply::readData(char *data, qint64 max)
+{
+    const qint64 count = std::min(max, m_body.size() - m_offset);
+    if (count <= 0) {
+        return isFinished() ? -1 : 0;
+    }
+    std::memcpy(data, m_body.constData() + m_offset, count);
+    m_offset += count;
+    return count;
+}
+
+qint64 NetworkAccessManager::SharedReply::bytesAvailable() const
+{
+    return m_body.size() - m_offset + QNetworkReply::bytesAvailable();
+}
+
+void NetworkAccessManager::SharedReply::abort()
+{
+    if (!isFinished()) {
+        finish(OperationCanceledError, QStringLiteral("Operation canceled"));
+    }
+}
+
+bool NetworkAccessManager::SharedReply::isSequential() const
+{
+    return true;
+}
+
+bool NetworkAccessManager::Flight::hasFollowers() const
+{
+    return std::any_of(followers.cbegin(), followers.cend(), [](const QPointer<SharedReply> &follower) {
+        return !follower.isNull() && !follower->isFinished();
+    });
 }
 
 static std::unique_ptr<NetworkAccessManager> networkAccessManagerInstance;
 
+void NetworkAccessManager::whenStarted(QNetworkReply *reply, QObject *context, const std::function<void(QNetworkReply *)> &callback)
+{
+    auto *deferred = dynamic_cast<DeferredNetworkReply *>(reply);
+    if (deferred == nullptr || deferred->isStarted() || deferred->isFinished()) {
+        callback(reply);
+        return;
+    }
+    deferred->setHandoff(context, callback);
+}
+
 NetworkAccessManager *NetworkAccessManager::instance()
 {
     if (auto instance = networkAccessManagerInstance.get()) {
@@ -186,6 +402,33 @@ static void setDefaultHeader(QNetworkRequest &req, QNetworkRequest::KnownHeaders
     }
 }
 
+/* requests with the same key can share a reply */
+static QByteArray flightKey(const QNetworkRequest &request)
+{
+    const QUrl &url = request.url();
+    if (url.scheme() != QLatin1String("http") && url.scheme() != QLatin1String("https")) {
+        return QByteArray();
+    }
+
+    // followers get the body when the request finishes, which a streaming reader has already consumed
+    if (request.attribute(NetworkAccessManager::StreamingAttribute).toBool()) {
+        return QByteArray();
+    }
+    QByteArray key = url.toEncoded();
+    QList<QByteArray> headers = request.rawHeaderList();
+    std::sort(headers.begin(), headers.end());
+    for (const QByteArray &header : std::as_const(headers)) {
+        key += '\n' + header + ": " + request.rawHeader(header);
+    }
+    const QNetworkRequest::Attribute attributes[] = {QNetworkRequest::CacheLoadControlAttribute,
+                                                     QNetworkRequest::RedirectPolicyAttribute,
+                                                     QNetworkRequest::CacheSaveControlAttribute};
+    for (const auto attribute : attributes) {
+        key += '\n' + request.attribute(attribute).toByteArray();
+    }
+    return key;
+}
+
 QNetworkReply *FeedCore::NetworkAccessManager::createRequest(QNetworkAccessManager::Operation op, const QNetworkRequest &request, QIODevice *outgoingData)
 {
     QNetworkRequest newRequest(request);
@@ -197,47 +440,253 @@ QNetworkReply *FeedCore::NetworkAccessManager::createRequest(QNetworkAccessManag
     // from a lot of different servers in rapid succession.
     newRequest.setRawHeader("Connection", "close");
 
-    if (d->connectionCount < kMaxSimultaneousLoads) {
-        return d->makeRealReply({op, newRequest, outgoingData});
+    const QByteArray &key = (op == GetOperation && outgoingData == nullptr) ? flightKey(newRequest) : QByteArray();
+    if (!key.isEmpty()) {
+        if (const auto &flight = d->flights.value(key)) {
+            auto *follower = new SharedReply(this, op, newRequest);
+            flight->followers << follower;
+            return follower;
+        }
     }
-    auto *proxyReply = new DeferredNetworkReply(this);
-    d->waitingRequests.push({op, newRequest, outgoingData, proxyReply});
-    return proxyReply;
+
+    QNetworkReply *reply{nullptr};
+    if (d->canStart(newRequest)) {
+        reply = d->makeRealReply({op, newRequest, outgoingData});
+    } else {
+        auto *proxyReply = new DeferredNetworkReply(this);
+        d->waitingRequests.push({op, newRequest, outgoingData, proxyReply, key});
+        reply = proxyReply;
+    }
+
+    if (!key.isEmpty()) {
+        auto flight = std::make_shared<Flight>();
+        flight->key = key;
+        flight->request = newRequest;
+        flight->leader = reply;
+        d->flights.insert(key, flight);
+        if (dynamic_cast<DeferredNetworkReply *>(reply) == nullptr) {
+            d->watchFlight(flight, reply);
+        }
+    }
+    return reply;
+}
+
+QNetworkReply *NetworkAccessManager::startRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData)
+{
+    return QNetworkAccessManager::createRequest(op, request, outgoingData);
+}
+
+bool NetworkAccessManager::allowsStreaming() const
+{
+    return true;
+}
+
+int NetworkAccessManager::concurrencyLimit() const
+{
+    return d->controller.limit();
+}
+
+int NetworkAccessManager::minimumConcurrency() const
+{
+    return d->controller.minimum();
+}
+
+void NetworkAccessManager::setMinimumConcurrency(int minimum)
+{
+    d->controller.setMinimum(minimum);
+    d->startWaiting();
+}
+
+int NetworkAccessManager::maximumConcurrency() const
+{
+    return d->controller.maximum();
+}
+
+void NetworkAccessManager::setMaximumConcurrency(int maximum)
+{
+    d->controller.setMaximum(maximum);
+    d->startWaiting();
+}
+
+int NetworkAccessManager::maxConnectionsPerHost() const
+{
+    return d->maxConnectionsPerHost;
 }
 
-void NetworkAccessManager::onFinished()
+void NetworkAccessManager::setMaxConnectionsPerHost(int maxConnectionsPerHost)
 {
-    d->connectionCount--;
+    d->maxConnectionsPerHost = std::max(1, maxConnectionsPerHost);
     d->startWaiting();
 }
 
+int NetworkAccessManager::activeRequestCount() const
+{
+    return d->connectionCount;
+}
+
+int NetworkAccessManager::queueDepth() const
+{
+    return static_cast<int>(d->waitingRequests.size());
+}
+
+bool NetworkAccessManager::PrivData::canStart(const QNetworkRequest &request) const
+{
+    return connectionCount < controller.limit() && hostConnectionCounts.value(request.url().host()) < maxConnectionsPerHost;
+}
+
 void NetworkAccessManager::PrivData::startWaiting()
 {
-    while (connectionCount < NetworkAccessManager::kMaxSimultaneousLoads && !waitingRequests.isEmpty()) {
-        makeRealReply(waitingRequests.pop());
+    // the most recent requests go first; skip requests to hosts that are already busy
+    qsizetype i = waitingRequests.size() - 1;
+    while (i >= 0 && connectionCount < controller.limit()) {
+        if (!canStart(waitingRequests.at(i).req)) {
+            --i;
+            continue;
+        }
+        makeRealReply(waitingRequests.takeAt(i));
+
+        // starting a request can run callbacks that change the queue
+        i = std::min(i, waitingRequests.size()) - 1;
     }
 }
 
 QNetworkReply *NetworkAccessManager::PrivData::makeRealReply(const WaitingRequest &wr)
 {
-    QNetworkReply *realReply = parent->QNetworkAccessManager::createRequest(wr.op, wr.req, wr.outgoingData);
-    QObject::connect(realReply, &QNetworkReply::finished, parent, &NetworkAccessManager::onFinished);
+    auto active = std::make_shared<ActiveRequest>();
+    active->host = wr.req.url().host();
+    active->startedAt = clock.elapsed();
+    hostConnectionCounts[active->host]++;
+    connectionCount++;
+
+    QNetworkReply *realReply = parent->startRequest(wr.op, wr.req, wr.outgoingData);
+    QObject::connect(realReply, &QNetworkReply::metaDataChanged, parent, [this, active] {
+        if (active->headersAt < 0) {
+            active->headersAt = clock.elapsed();
+        }
+    });
+    QObject::connect(realReply, &QNetworkReply::downloadProgress, parent, [active](qint64 bytesReceived) {
+        active->bytes = bytesReceived;
+    });
+    QObject::connect(realReply, &QNetworkReply::finished, parent, [this, realReply, active] {
+        finishRequest(realReply, *active);
+    });
+    if (!wr.flightKey.isEmpty()) {
+        const auto &flight = flights.value(wr.flightKey);
+        if (flight && flight->leader == wr.repl) {
+            watchFlight(flight, realReply);
+        }
+    }
     if (wr.repl != nullptr) {
         wr.repl->start(realReply);
     }
-    connectionCount++;
     return realReply;
 }
 
+static bool isCongestionError(QNetworkReply::NetworkError error)
+{
+    switch (error) {
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::UnknownNetworkError:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void NetworkAccessManager::PrivData::finishRequest(QNetworkReply *reply, const ActiveRequest &active)
+{
+    connectionCount--;
+    if (--hostConnectionCounts[active.host] <= 0) {
+        hostConnectionCounts.remove(active.host);
+    }
+
+    // cached responses and other failures say nothing about the network
+    const bool limited = !waitingRequests.isEmpty();
+    const qint64 now = clock.elapsed();
+    if (isCongestionError(reply->error())) {
+        controller.recordCongestion(limited, now);
+    } else if (active.headersAt >= 0 && reply->error() == QNetworkReply::NoError
+               && !reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool()) {
+        controller.recordResponse(active.headersAt - active.startedAt, active.bytes, limited, now);
+    }
+    startWaiting();
+}
+
 void NetworkAccessManager::PrivData::removeWaiting(DeferredNetworkReply *reply)
 {
     QList<WaitingRequest>::const_iterator it = std::find_if(waitingRequests.begin(), waitingRequests.end(), [reply](const WaitingRequest &wr) {
         return wr.repl == reply;
     });
     if (it != waitingRequests.end()) {
+        const auto &flight = flights.value(it->flightKey);
         waitingRequests.erase(it);
+        if (flight && flight->leader == reply) {
+            abandonFlight(flight);
+        }
         if (parent->autoDeleteReplies() || reply->request().attribute(QNetworkRequest::AutoDeleteReplyOnFinishAttribute).toBool()) {
             reply->deleteLater();
         }
     }
 }
+
+void NetworkAccessManager::PrivData::watchFlight(const std::shared_ptr<Flight> &flight, QNetworkReply *source)
+{
+    flight->source = source;
+    QObject::connect(source, &QNetworkReply::finished, parent, [this, flight, source] {
+        completeFlight(flight, source);
+    });
+
+    // the caller may delete its reply without waiting for it to finish
+    QObject::connect(source, &QObject::destroyed, parent, [this, flight] {
+        if (flights.value(flight->key) == flight) {
+            abandonFlight(flight);
+        }
+    });
+}
+
+void NetworkAccessManager::PrivData::completeFlight(const std::shared_ptr<Flight> &flight, QNetworkReply *source)
+{
+    if (flights.value(flight->key) != flight) {
+        return;
+    }
+
+    // the first caller gave up, but the others still want the response
+    if (source->error() == QNetworkReply::OperationCanceledError && !flight->restarted) {
+        abandonFlight(flight);
+        return;
+    }
+
+    flights.remove(flight->key);
+    if (!flight->hasFollowers()) {
+        return;
+    }
+
+    // this runs before the first caller sees finished(), so the whole body is still buffered
+    const QByteArray body = source->peek(source->bytesAvailable());
+    for (const auto &follower : std::as_const(flight->followers)) {
+        if (!follower.isNull() && !follower->isFinished()) {
+            follower->deliver(source, body);
+        }
+    }
+}
+
+void NetworkAccessManager::PrivData::abandonFlight(const std::shared_ptr<Flight> &flight)
+{
+    if (flights.value(flight->key) == flight) {
+        flights.remove(flight->key);
+    }
+    if (!flight->hasFollowers()) {
+        return;
+    }
+
+    // start over on behalf of the followers, with a reply that nobody else reads
+    QNetworkReply *reply = parent->createRequest(QNetworkAccessManager::GetOperation, flight->request, nullptr);
+    QObject::connect(reply, &QNetworkReply::finished, reply, &QObject::deleteLater);
+    if (const auto &next = flights.value(flight->key)) {
+        next->restarted = next->restarted || next->leader == reply;
+        next->followers += flight->followers;
+    }
+}
@@ -5,6 +5,7 @@
 
 #pragma once
 #include <QNetworkAccessManager>
+#include <functional>
 #include <memory>
 
 namespace FeedCore
@@ -14,10 +15,23 @@ namespace FeedCore
  * A specialized QNetworkAccessManager for bulk updates
  *
  * This class supports queuing connections when many resources
- * are requested simultaneously. Once the connection limit is
- * hit, it will begin returning DeferredNetworkReply instances,
+ * are requested simultaneously. The number of simultaneous
+ * requests adapts to the observed throughput, latency and error
+ * rate (see ConcurrencyController), and is also limited for each
+ * host. Once a limit is hit, it will begin returning
+ * DeferredNetworkReply instances,
  * which will proxy an underlying QNetworkReply when a connection
- * slot becomes available.
+ * slot becomes available. Callers that can switch to the underlying
+ * reply once it starts should use whenStarted(), which avoids the cost
+ * of proxying headers and body data.
+ *
+ * Concurrent GET requests for the same url with the same headers
+ * share a single underlying request. Every caller after the first
+ * gets a SharedReply that receives the headers and the complete body
+ * when the shared request finishes, so the first caller must not read
+ * from its reply before it finishes. Requests with StreamingAttribute
+ * set are never shared, so their replies can be read as the body
+ * arrives.
  *
  * \warning DeferredNetworkReply does not implement every feature
  * of the QNetworkReply API. Test before using features that
@@ -34,12 +48,78 @@ public:
     ~NetworkAccessManager();
     QNetworkReply *createRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData) override;
 
+    /**
+     * Call /callback/ with the reply that will deliver the response for /reply/.
+     *
+     * If /reply/ is a deferred reply that hasn't started yet, the callback is called with
+     * the real reply once a connection slot becomes available; the deferred reply is
+     * deleted and the caller takes its place as the user of the real reply. Otherwise, or
+     * if the request is aborted before it starts, the callback is called with /reply/.
+     *
+     * The callback is not called if /context/ is destroyed first.
+     */
+    static void whenStarted(QNetworkReply *reply, QObject *context, const std::function<void(QNetworkReply *)> &callback);
+
+    static constexpr const int kDefaultMaxConnectionsPerHost = 6;
+
+    /**
+     * Set this request attribute to true for requests whose reply will be read before it finishes.
+     */
+    static constexpr const QNetworkRequest::Attribute StreamingAttribute = QNetworkRequest::User;
+
+    /**
+     * Whether replies may be read before they finish.
+     *
+     * The default implementation returns true. Subclasses that need the whole body when
+     * the reply finishes should override this to return false.
+     */
+    virtual bool allowsStreaming() const;
+
+    /**
+     * The number of requests that may currently run at once.
+     *
+     * This changes as requests finish, staying between minimumConcurrency() and
+     * maximumConcurrency().
+     */
+    int concurrencyLimit() const;
+    int minimumConcurrency() const;
+    void setMinimumConcurrency(int minimum);
+    int maximumConcurrency() const;
+    void setMaximumConcurrency(int maximum);
+
+    /**
+     * The number of requests to a single host that may run at once.
+     */
+    int maxConnectionsPerHost() const;
+    void setMaxConnectionsPerHost(int maxConnectionsPerHost);
+
+    /**
+     * The number of requests that are running.
+     */
+    int activeRequestCount() const;
+
+    /**
+     * The number of requests waiting for a slot.
+     */
+    int queueDepth() const;
+
+protected:
+    /**
+     * Start a request once a connection slot is available.
+     *
+     * The default implementation passes the request to QNetworkAccessManager. Subclasses
+     * can override this to serve requests from somewhere else while keeping the queueing
+     * behavior; the returned reply must emit finished() exactly once.
+     */
+    virtual QNetworkReply *startRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData);
+
 private:
-    static constexpr const int kMaxSimultaneousLoads = 128;
     struct PrivData;
     class DeferredNetworkReply;
     struct WaitingRequest;
+    struct ActiveRequest;
+    struct Flight;
+    class SharedReply;
     std::unique_ptr<PrivData> d;
-    void onFinished();
 };
 }
@@ -0,0 +1,333 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "networkreplay.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QTimer>
+#include <algorithm>
+#include <cstring>
+using namespace FeedCore;
+
+/* bodies are delivered in chunks at this interval when the bandwidth is limited */
+static constexpr const int kTickMsecs = 10;
+
+static bool writeFile(const QString &path, const QByteArray &data)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(data);
+    return file.commit();
+}
+
+NetworkCorpus::NetworkCorpus(const QString &directory)
+    : m_directory(directory)
+{
+}
+
+const QString &NetworkCorpus::directory() const
+{
+    return m_directory;
+}
+
+QString NetworkCorpus::pathForUrl(const QUrl &requestUrl) const
+{
+    return QDir(m_directory).filePath(QCryptographicHash::hash(requestUrl.toEncoded(), QCryptographicHash::Sha1).toHex());
+}
+
+bool NetworkCorpus::save(const QUrl &requestUrl, const RecordedResponse &response) const
+{
+    if (!QDir().mkpath(m_directory)) {
+        return false;
+    }
+
+    // header values are arbitrary bytes, so store them as latin1 to round-trip them exactly
+    QJsonArray headers;
+    for (const auto &header : response.headers) {
+        headers.append(QJsonArray{QString::fromLatin1(header.first), QString::fromLatin1(header.second)});
+    }
+    const QJsonObject metaData{{"request", requestUrl.toString()},
+                               {"url", response.url.toString()},
+                               {"status", response.statusCode},
+                               {"error", static_cast<int>(response.error)},
+                               {"errorString", response.errorString},
+                               {"headers", headers}};
+
+    // the metadata goes last, so an entry without it is never used
+    const QString &path = pathForUrl(requestUrl);
+    return writeFile(path + QLatin1String(".body"), response.body) && writeFile(path + QLatin1String(".json"), QJsonDocument(metaData).toJson());
+}
+
+std::optional<RecordedResponse> NetworkCorpus::load(const QUrl &requestUrl) const
+{
+    const QString &path = pathForUrl(requestUrl);
+    QFile metaDataFile(path + QLatin1String(".json"));
+    QFile bodyFile(path + QLatin1String(".body"));
+    if (!metaDataFile.open(QIODevice::ReadOnly) || !bodyFile.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+    const QJsonObject &metaData = QJsonDocument::fromJson(metaDataFile.readAll()).object();
+    if (QUrl(metaData.value("request").toString()) != requestUrl) {
+        return std::nullopt;
+    }
+
+    RecordedResponse response;
+    response.url = QUrl(metaData.value("url").toString());
+    response.statusCode = metaData.value("status").toInt();
+    response.error = static_cast<QNetworkReply::NetworkError>(metaData.value("error").toInt());
+    response.errorString = metaData.value("errorString").toString();
+    const QJsonArray &headers = metaData.value("headers").toArray();
+    for (const QJsonValue &header : headers) {
+        const QJsonArray &pair = header.toArray();
+        response.headers.append({pair.at(0).toString().toLatin1(), pair.at(1).toString().toLatin1()});
+    }
+    response.body = bodyFile.readAll();
+    return response;
+}
+
+QList<QUrl> NetworkCorpus::urls() const
+{
+    QList<QUrl> result;
+    const QStringList &entries = QDir(m_directory).entryList({QStringLiteral("*.json")}, QDir::Files, QDir::Name);
+    for (const QString &entry : entries) {
+        QFile file(QDir(m_directory).filePath(entry));
+        if (file.open(QIODevice::ReadOnly)) {
+            result << QUrl(QJsonDocument::fromJson(file.readAll()).object().value("request").toString());
+        }
+    }
+    return result;
+}
+
+RecordingNetworkAccessManager::RecordingNetworkAccessManager(const QString &directory, QAbstractNetworkCache *cache, QObject *parent)
+    : NetworkAccessManager(cache, parent)
+    , m_corpus(directory)
+{
+}
+
+bool RecordingNetworkAccessManager::allowsStreaming() const
+{
+    return false;
+}
+
+QNetworkReply *RecordingNetworkAccessManager::startRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData)
+{
+    QNetworkReply *reply = NetworkAccessManager::startRequest(op, request, outgoingData);
+    if (op != GetOperation) {
+        return reply;
+    }
+
+    // connected before anyone else can read the body
+    QObject::connect(reply, &QNetworkReply::finished, this, [this, reply] {
+        if (reply->error() == QNetworkReply::OperationCanceledError) {
+            return;
+        }
+        RecordedResponse response;
+        response.url = reply->url();
+        response.statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        response.error = reply->error();
+        response.errorString = reply->errorString();
+        response.body = reply->peek(reply->bytesAvailable());
+
+        // the body has already been decompressed, so these no longer describe it
+        const auto &headers = reply->rawHeaderPairs();
+        for (const auto &header : headers) {
+            if (header.first.compare("Content-Encoding", Qt::CaseInsensitive) != 0 && header.first.compare("Content-Length", Qt::CaseInsensitive) != 0) {
+                response.headers.append(header);
+            }
+        }
+
+        if (!m_corpus.save(reply->request().url(), response)) {
+            qWarning() << "could not record response for" << reply->request().url() << "in" << m_corpus.directory();
+        }
+    });
+    return reply;
+}
+
+namespace
+{
+class ReplayReply : public QNetworkReply
+{
+public:
+    ReplayReply(QNetworkAccessManager::Operation op,
+                const QNetworkRequest &request,
+                std::optional<RecordedResponse> response,
+                int latency,
+                qint64 bandwidth,
+                QNetworkAccessManager *manager);
+    void abort() override;
+    qint64 bytesAvailable() const override;
+    bool isSequential() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+
+private:
+    QNetworkAccessManager *m_manager;
+    std::optional<RecordedResponse> m_response;
+    qint64 m_chunkSize{0};
+    qint64 m_received{0};
+    qint64 m_offset{0};
+    QTimer m_timer;
+    bool m_done{false};
+
+    void receiveHeaders();
+    void receiveBody();
+    void finishReply(QNetworkReply::NetworkError error, const QString &errorString);
+};
+}
+
+ReplayReply::ReplayReply(QNetworkAccessManager::Operation op,
+                         const QNetworkRequest &request,
+                         std::optional<RecordedResponse> response,
+                         int latency,
+                         qint64 bandwidth,
+                         QNetworkAccessManager *manager)
+    : QNetworkReply(manager)
+    , m_manager(manager)
+    , m_response(std::move(response))
+    , m_chunkSize(bandwidth > 0 ? std::max<qint64>(1, bandwidth * kTickMsecs / 1000) : 0)
+{
+    setOperation(op);
+    setRequest(request);
+    setUrl(request.url());
+    QIODevice::open(ReadOnly | Unbuffered);
+    QObject::connect(&m_timer, &QTimer::timeout, this, &ReplayReply::receiveBody);
+    QTimer::singleShot(0, this, [this] {
+        if (!m_done) {
+            emit requestSent();
+        }
+    });
+    QTimer::singleShot(latency, this, &ReplayReply::receiveHeaders);
+}
+
+void ReplayReply::receiveHeaders()
+{
+    if (m_done) {
+        return;
+    }
+    if (!m_response) {
+        setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 404);
+        emit metaDataChanged();
+        finishReply(ContentNotFoundError, QStringLiteral("%1 is not in the replay corpus").arg(url().toString()));
+        return;
+    }
+
+    if (m_response->url.isValid() && m_response->url != url()) {
+        emit redirected(m_response->url);
+        setUrl(m_response->url);
+    }
+    for (const auto &header : std::as_const(m_response->headers)) {
+        setRawHeader(header.first, header.second);
+    }
+    if (m_response->statusCode != 0) {
+        setAttribute(QNetworkRequest::HttpStatusCodeAttribute, m_response->statusCode);
+    }
+    emit metaDataChanged();
+
+    if (m_chunkSize > 0 && !m_response->body.isEmpty()) {
+        m_timer.start(kTickMsecs);
+        return;
+    }
+    m_received = m_response->body.size();
+    if (m_received > 0) {
+        emit readyRead();
+        emit downloadProgress(m_received, m_received);
+    }
+    finishReply(m_response->error, m_response->errorString);
+}
+
+void ReplayReply::receiveBody()
+{
+    const qint64 size = m_response->body.size();
+    m_received = std::min(size, m_received + m_chunkSize);
+    emit readyRead();
+    emit downloadProgress(m_received, size);
+    if (m_received == size) {
+        m_timer.stop();
+        finishReply(m_response->error, m_response->errorString);
+    }
+}
+
+void ReplayReply::finishReply(QNetworkReply::NetworkError error, const QString &errorString)
+{
+    m_done = true;
+    if (error != NoError) {
+        setError(error, errorString);
+        emit errorOccurred(error);
+    }
+    setFinished(true);
+    emit finished();
+    if (m_manager->autoDeleteReplies() || request().attribute(QNetworkRequest::AutoDeleteReplyOnFinishAttribute).toBool()) {
+        deleteLater();
+    }
+}
+
+void ReplayReply::abort()
+{
+    if (m_done) {
+        return;
+    }
+    m_timer.stop();
+    finishReply(OperationCanceledError, QStringLiteral("Operation canceled"));
+}
+
+qint64 ReplayReply::bytesAvailable() const
+{
+    return m_received - m_offset + QNetworkReply::bytesAvailable();
+}
+
+bool ReplayReply::isSequential() const
+{
+    return true;
+}
+
+qint64 ReplayReply::readData(char *data, qint64 maxSize)
+{
+    const qint64 count = std::min(maxSize, m_received - m_offset);
+    if (count <= 0) {
+        return m_done ? -1 : 0;
+    }
+    std::memcpy(data, m_response->body.constData() + m_offset, count);
+    m_offset += count;
+    return count;
+}
+
+ReplayNetworkAccessManager::ReplayNetworkAccessManager(const QString &directory, QObject *parent)
+    : NetworkAccessManager(parent)
+    , m_corpus(directory)
+{
+}
+
+int ReplayNetworkAccessManager::latency() const
+{
+    return m_latency;
+}
+
+void ReplayNetworkAccessManager::setLatency(int latency)
+{
+    m_latency = latency;
+}
+
+qint64 ReplayNetworkAccessManager::bandwidth() const
+{
+    return m_bandwidth;
+}
+
+void ReplayNetworkAccessManager::setBandwidth(qint64 bandwidth)
+{
+    m_bandwidth = bandwidth;
+}
+
+QNetworkReply *ReplayNetworkAccessManager::startRequest(Operation op, const QNetworkRequest &request, QIODevice * /* outgoingData */)
+{
+    return new ReplayReply(op, request, m_corpus.load(request.url()), m_latency, m_bandwidth, this);
+}
@@ -0,0 +1,103 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+#include "networkaccessmanager.h"
+#include <QNetworkReply>
+#include <optional>
+
+namespace FeedCore
+{
+
+/**
+ * A response stored in a NetworkCorpus
+ */
+struct RecordedResponse {
+    QUrl url; /** < the final url, after any redirects */
+    int statusCode{0};
+    QList<QNetworkReply::RawHeaderPair> headers;
+    QNetworkReply::NetworkError error{QNetworkReply::NoError};
+    QString errorString;
+    QByteArray body;
+};
+
+/**
+ * A directory of recorded responses, keyed by request url
+ *
+ * Each response is stored as a JSON file with the status and headers, and a
+ * separate file with the body, so that a corpus can be inspected and edited by hand.
+ */
+class NetworkCorpus
+{
+public:
+    explicit NetworkCorpus(const QString &directory);
+
+    const QString &directory() const;
+    bool save(const QUrl &requestUrl, const RecordedResponse &response) const;
+    std::optional<RecordedResponse> load(const QUrl &requestUrl) const;
+
+    /**
+     * The request urls of every response in the corpus.
+     */
+    QList<QUrl> urls() const;
+
+private:
+    QString m_directory;
+    QString pathForUrl(const QUrl &requestUrl) const;
+};
+
+/**
+ * A network access manager that saves every GET response to a NetworkCorpus
+ *
+ * The body is captured when the reply finishes, so the caller must not read from the
+ * reply before then, and streaming is not allowed.
+ */
+class RecordingNetworkAccessManager : public NetworkAccessManager
+{
+public:
+    explicit RecordingNetworkAccessManager(const QString &directory, QAbstractNetworkCache *cache = nullptr, QObject *parent = nullptr);
+    bool allowsStreaming() const override;
+
+protected:
+    QNetworkReply *startRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData) override;
+
+private:
+    NetworkCorpus m_corpus;
+};
+
+/**
+ * A network access manager that serves responses from a NetworkCorpus instead of the network
+ *
+ * Requests for urls that are not in the corpus fail with ContentNotFoundError. The
+ * connection limit and request queue of NetworkAccessManager still apply, and latency and
+ * bandwidth can be simulated, so a replayed update behaves like a real one without
+ * depending on the network.
+ */
+class ReplayNetworkAccessManager : public NetworkAccessManager
+{
+public:
+    explicit ReplayNetworkAccessManager(const QString &directory, QObject *parent = nullptr);
+
+    /**
+     * The delay (in msecs) between sending the request and receiving the response headers.
+     */
+    int latency() const;
+    void setLatency(int latency);
+
+    /**
+     * The rate (in bytes per second) at which each response body is delivered, or 0 to deliver it at once.
+     */
+    qint64 bandwidth() const;
+    void setBandwidth(qint64 bandwidth);
+
+protected:
+    QNetworkReply *startRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData) override;
+
+private:
+    NetworkCorpus m_corpus;
+    int m_latency{0};
+    qint64 m_bandwidth{0};
+};
+}
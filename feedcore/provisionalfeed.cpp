@@ -16,6 +16,7 @@ class ProvisionalFeed::ArticleImpl : public Article
 public:
     explicit ArticleImpl(const Syndication::ItemPtr &item, Feed *feed, QObject *parent = nullptr);
     void requestContent() final;
+    QFuture<QString> getContent() final;
     void setRead(bool /*isRead*/) final{};
     void setStarred(bool /*isStarred*/) final{};
 
@@ -75,6 +76,12 @@ QFuture<void> ProvisionalFeed::updateSourceArticle(const Syndication::ItemPtr &)
     return QtFuture::makeReadyVoidFuture();
 }
 
+bool ProvisionalFeed::acceptsPartialUpdates() const
+{
+    // the preview shows exactly the articles in the last update
+    return false;
+}
+
 Feed *ProvisionalFeed::targetFeed() const
 {
     return m_targetFeed;
@@ -104,6 +111,12 @@ void ProvisionalFeed::ArticleImpl::requestContent()
     emit gotContent(content.isEmpty() ? m_item->description() : content);
 }
 
+QFuture<QString> ProvisionalFeed::ArticleImpl::getContent()
+{
+    QString content{m_item->content()};
+    return QtFuture::makeReadyValueFuture(content.isEmpty() ? m_item->description() : content);
+}
+
 ProvisionalFeed::ArticleImpl::ArticleImpl(const Syndication::ItemPtr &item, Feed *feed, QObject *parent)
     : Article(feed, parent)
     , m_item(item)
@@ -99,5 +99,6 @@ private:
     QFuture<void> updateFromSource(const Syndication::FeedPtr &feed) final;
     QFuture<void> updateSourceArticle(const Syndication::ItemPtr & /*article*/) final;
     void expire(const QDateTime & /*olderThan*/) final{};
+    bool acceptsPartialUpdates() const final;
 };
 }
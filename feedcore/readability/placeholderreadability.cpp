@@ -6,7 +6,7 @@ namespace FeedCore
 
 PlaceholderReadability::PlaceholderReadability() = default;
 
-ReadabilityResult *PlaceholderReadability::fetch(const QUrl &url)
+ReadabilityResult *PlaceholderReadability::fetch(const QUrl &url, Priority priority)
 {
     auto *result = new ReadabilityResult;
     QMetaObject::invokeMethod(
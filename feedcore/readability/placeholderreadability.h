@@ -9,7 +9,7 @@ class PlaceholderReadability : public FeedCore::Readability
 {
 public:
     PlaceholderReadability();
-    ReadabilityResult *fetch(const QUrl &url) override;
+    ReadabilityResult *fetch(const QUrl &url, Priority priority) override;
 };
 
 } // namespace FeedCore
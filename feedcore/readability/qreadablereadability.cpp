@@ -4,13 +4,19 @@
  */
 
 #include "qreadablereadability.h"
+#include "future.h"
+#include "htmldecoder.h"
 #include "networkaccessmanager.h"
 #include "readabilityresult.h"
+#include "readablecontentcache.h"
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QNetworkReply>
 #include <QPointer>
+#include <QQueue>
 #include <QString>
 #include <QThread>
+#include <algorithm>
 
 #include <qreadable/readable.h>
 
@@ -20,17 +26,45 @@ static constexpr const char *kBrowserUserAgent = "Mozilla/5.0 (X11; Ubuntu; Linu
 
 class QReadableReadability::Result : public ReadabilityResult
 {
-    QNetworkReply *m_reply;
+    QNetworkReply *m_reply{nullptr};
     QReadableReadability *m_parent;
+    Priority m_priority;
+    ReadableContentCache::Entry m_entry;
 
 public:
-    Result(QReadableReadability *parent, QNetworkReply *reply)
+    Result(QReadableReadability *parent, const QNetworkRequest &request, Priority priority)
         : ReadabilityResult(parent)
-        , m_reply{reply}
         , m_parent{parent}
+        , m_priority{priority}
     {
-        reply->setParent(this);
-        QObject::connect(reply, &QNetworkReply::finished, this, &Result::onNetworkReplyFinished);
+        // ask the server whether the page has changed since the cached content was made from it
+        QFuture<ReadableContentCache::Entry> cached = ReadableContentCache::validators(request.url());
+        Future::safeThen(cached, this, [this, request](auto &fut) {
+            m_entry = fut.result();
+            QNetworkRequest req(request);
+            if (m_entry.isValid() && (!m_entry.etag.isEmpty() || !m_entry.lastModified.isEmpty())) {
+                if (!m_entry.etag.isEmpty()) {
+                    req.setRawHeader("If-None-Match", m_entry.etag);
+                }
+                if (!m_entry.lastModified.isEmpty()) {
+                    req.setRawHeader("If-Modified-Since", m_entry.lastModified);
+                }
+                // otherwise the network cache would answer a 304 with the whole page
+                req.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+            }
+            watch(NetworkAccessManager::instance()->get(req));
+        });
+    }
+
+    void watch(QNetworkReply *reply)
+    {
+        m_reply = reply;
+        m_reply->setParent(this);
+        NetworkAccessManager::whenStarted(reply, this, [this](QNetworkReply *startedReply) {
+            m_reply = startedReply;
+            m_reply->setParent(this);
+            QObject::connect(m_reply, &QNetworkReply::finished, this, &Result::onNetworkReplyFinished);
+        });
     }
 
     void onNetworkReplyFinished()
@@ -41,14 +75,51 @@ public:
             deleteLater();
             return;
         }
-        QByteArray data = m_reply->readAll();
-        QString rawHtml(data);
-        m_parent->parse(rawHtml, m_reply->url(), this);
+
+        const bool isRevalidated = m_reply->request().hasRawHeader("If-None-Match") || m_reply->request().hasRawHeader("If-Modified-Since");
+        m_entry.url = m_reply->request().url();
+        m_entry.fetched = QDateTime::currentDateTime();
+        if (m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304 /* Not Modified */ && isRevalidated) {
+            QFuture<ReadableContentCache::Entry> cached = ReadableContentCache::lookup(m_entry.url);
+            Future::safeThen(cached, this, [this](auto &fut) {
+                onGotCachedContent(fut.result().content);
+            });
+            return;
+        }
+        m_entry.etag = m_reply->rawHeader("ETag");
+        m_entry.lastModified = m_reply->rawHeader("Last-Modified");
+
+        // decoded on the worker, in the charset that the page was sent in
+        const QByteArray html = m_reply->readAll();
+        m_bytes = html.size();
+        m_parent->parse(html, m_reply->rawHeader("Content-Type"), m_reply->url(), this, m_priority);
     }
 
-    // NB: Executes on worker thread
-    void onGotReadabilityResult(const QString &readableHtml)
+    void onGotCachedContent(const QString &content)
     {
+        if (content.isEmpty()) {
+            // evicted since the validators were read, so ask for the whole page
+            QNetworkRequest req = m_reply->request();
+            req.setRawHeader("If-None-Match", QByteArray());
+            req.setRawHeader("If-Modified-Since", QByteArray());
+            req.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::PreferNetwork);
+            m_reply->deleteLater();
+            watch(NetworkAccessManager::instance()->get(req));
+            return;
+        }
+        m_entry.content = content;
+        ReadableContentCache::revalidate(m_entry);
+        emit finished(content);
+        deleteLater();
+    }
+
+    void onGotReadabilityResult(const QString &readableHtml, qint64 parseMsecs)
+    {
+        m_parseMsecs = parseMsecs;
+        if (!readableHtml.isEmpty()) {
+            m_entry.content = readableHtml;
+            ReadableContentCache::insert(m_entry);
+        }
         emit finished(readableHtml);
         deleteLater();
     }
@@ -59,47 +130,130 @@ class QReadableReadability::Worker : public QObject
     QReadable::Readable *m_readable{nullptr};
 
 public:
-    void parse(const QString &rawHtml, const QUrl &url, Result *result)
+    // NB: Executes on worker thread
+    QString parse(const QByteArray &html, const QByteArray &contentType, const QUrl &url)
     {
         if (m_readable == nullptr) {
             m_readable = new QReadable::Readable(this);
         }
-        QString readableHtml = m_readable->parse(rawHtml, url);
-        QMetaObject::invokeMethod(result, [result, readableHtml] {
-            result->onGotReadabilityResult(readableHtml);
-        });
+        return m_readable->parse(HtmlDecoder::toString(html, contentType), url);
     }
 };
 
-QReadableReadability::QReadableReadability()
-    : m_thread{new QThread(this)}
-    , m_worker{new Worker()}
+struct QReadableReadability::PrivData {
+    struct Job {
+        QByteArray html;
+        QByteArray contentType;
+        QUrl url;
+        QPointer<Result> result;
+    };
+
+    struct Lane {
+        QThread *thread{nullptr};
+        Worker *worker{nullptr};
+        bool interactiveOnly{false};
+        bool busy{false};
+    };
+
+    QList<Lane> lanes;
+    QQueue<Job> interactiveJobs;
+    QQueue<Job> backgroundJobs;
+
+    void addLane(QReadableReadability *parent, QThread::Priority priority, bool interactiveOnly);
+    bool takeJob(const Lane &lane, Job &job);
+};
+
+void QReadableReadability::PrivData::addLane(QReadableReadability *parent, QThread::Priority priority, bool interactiveOnly)
+{
+    Lane lane{new QThread(parent), new Worker(), interactiveOnly};
+    lane.thread->start();
+    lane.thread->setPriority(priority);
+    lane.worker->moveToThread(lane.thread);
+    QObject::connect(lane.thread, &QThread::finished, lane.worker, &QObject::deleteLater);
+    lanes << lane;
+}
+
+/* the next job for /lane/, skipping jobs whose result has been deleted */
+bool QReadableReadability::PrivData::takeJob(const Lane &lane, Job &job)
 {
-    m_thread->start();
-    m_thread->setPriority(QThread::LowestPriority);
-    m_worker->moveToThread(m_thread);
-    QObject::connect(m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    for (QQueue<Job> *queue : {&interactiveJobs, &backgroundJobs}) {
+        if (queue == &backgroundJobs && lane.interactiveOnly) {
+            return false;
+        }
+        while (!queue->isEmpty()) {
+            job = queue->dequeue();
+            if (!job.result.isNull()) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+QReadableReadability::QReadableReadability(int backgroundWorkers)
+    : d{std::make_unique<PrivData>()}
+{
+    if (backgroundWorkers <= 0) {
+        // leave a core for the interactive worker and the UI
+        backgroundWorkers = std::max(1, QThread::idealThreadCount() - 1);
+    }
+    d->addLane(this, QThread::HighPriority, true);
+    for (int i = 0; i < backgroundWorkers; ++i) {
+        d->addLane(this, QThread::LowestPriority, false);
+    }
 }
 
 QReadableReadability::~QReadableReadability()
 {
-    m_thread->quit();
-    m_thread->wait();
+    for (const auto &lane : std::as_const(d->lanes)) {
+        lane.thread->quit();
+    }
+    for (const auto &lane : std::as_const(d->lanes)) {
+        lane.thread->wait();
+    }
 }
 
-ReadabilityResult *QReadableReadability::fetch(const QUrl &url)
+ReadabilityResult *QReadableReadability::fetch(const QUrl &url, Priority priority)
 {
-    auto *nam = NetworkAccessManager::instance();
     QNetworkRequest req(url);
     req.setRawHeader("Accept", "text/html");
     req.setHeader(QNetworkRequest::UserAgentHeader, kBrowserUserAgent);
-    auto *reply = nam->get(req);
-    return new Result(this, reply);
+    if (priority == InteractivePriority) {
+        req.setPriority(QNetworkRequest::HighPriority);
+    }
+
+    // the request is sent once the validators have been read from the cache
+    return new Result(this, req, priority);
 }
 
-void QReadableReadability::parse(const QString &rawHtml, const QUrl &url, Result *result)
+void QReadableReadability::parse(const QByteArray &html, const QByteArray &contentType, const QUrl &url, Result *result, Priority priority)
 {
-    QMetaObject::invokeMethod(m_worker, [worker = m_worker, rawHtml, url, result] {
-        worker->parse(rawHtml, url, result);
-    });
+    auto &queue = priority == InteractivePriority ? d->interactiveJobs : d->backgroundJobs;
+    queue.enqueue({html, contentType, url, result});
+    dispatch();
+}
+
+void QReadableReadability::dispatch()
+{
+    for (qsizetype i = 0; i < d->lanes.size(); ++i) {
+        PrivData::Lane &lane = d->lanes[i];
+        PrivData::Job job;
+        if (lane.busy || !d->takeJob(lane, job)) {
+            continue;
+        }
+        lane.busy = true;
+        QMetaObject::invokeMethod(lane.worker, [this, i, worker = lane.worker, job] {
+            QElapsedTimer parseTimer;
+            parseTimer.start();
+            const QString readableHtml = worker->parse(job.html, job.contentType, job.url);
+            const qint64 parseMsecs = parseTimer.elapsed();
+            QMetaObject::invokeMethod(this, [this, i, result = job.result, readableHtml, parseMsecs] {
+                d->lanes[i].busy = false;
+                if (result) {
+                    result->onGotReadabilityResult(readableHtml, parseMsecs);
+                }
+                dispatch();
+            });
+        });
+    }
 }
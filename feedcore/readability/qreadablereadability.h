@@ -5,6 +5,7 @@
 #pragma once
 
 #include "readability.h"
+#include <memory>
 
 namespace QReadable
 {
@@ -14,18 +15,33 @@ class Readable;
 namespace FeedCore
 {
 
+/**
+ * Readability implementation using QReadable
+ *
+ * Pages are parsed on a pool of low-priority worker threads, each with its own
+ * QReadable::Readable. One more worker, at high priority, only parses pages for
+ * interactive requests, so an article that the user opens never waits behind
+ * prefetches. Interactive requests also go ahead of any queued prefetches on
+ * the other workers. Pages are passed to the workers as they were downloaded, and
+ * decoded there in the charset they were sent in.
+ */
 class QReadableReadability : public Readability
 {
 public:
-    QReadableReadability();
+    /**
+     * /backgroundWorkers/ is the number of workers for prefetching, or 0 to use one
+     * less than the number of cores.
+     */
+    explicit QReadableReadability(int backgroundWorkers = 0);
     virtual ~QReadableReadability();
-    ReadabilityResult *fetch(const QUrl &url) override;
+    ReadabilityResult *fetch(const QUrl &url, Priority priority) override;
 
 private:
     class Worker;
     class Result;
-    QThread *m_thread{nullptr};
-    Worker *m_worker{nullptr};
-    void parse(const QString &rawHtml, const QUrl &url, Result *result);
+    struct PrivData;
+    std::unique_ptr<PrivData> d;
+    void parse(const QByteArray &html, const QByteArray &contentType, const QUrl &url, Result *result, Priority priority);
+    void dispatch();
 };
 }
@@ -15,8 +15,13 @@ class Readability : public QObject
 {
     Q_OBJECT
 public:
+    enum Priority {
+        BackgroundPriority, /** < prefetching content that nobody is waiting for */
+        InteractivePriority, /** < the user is waiting for the content */
+    };
+
     virtual ~Readability() = default;
 
-    virtual ReadabilityResult *fetch(const QUrl &url) = 0;
+    virtual ReadabilityResult *fetch(const QUrl &url, Priority priority) = 0;
 };
 }
@@ -5,16 +5,14 @@
 #include "readabilityprefetchrule.h"
 #include "article.h"
 #include "feed.h"
-#include "readability.h"
-#include "readabilityresult.h"
+#include "readabilityprefetchscheduler.h"
 #include <QFlags>
-#include <QPromise>
 
 using namespace FeedCore;
 
-ReadabilityPrefetchRule::ReadabilityPrefetchRule(Readability *readability, QObject *parent)
+ReadabilityPrefetchRule::ReadabilityPrefetchRule(ReadabilityPrefetchScheduler *scheduler, QObject *parent)
     : AbstractAutomationRule(parent)
-    , m_readability(readability)
+    , m_scheduler(scheduler)
 {
 }
 
@@ -31,26 +29,8 @@ bool ReadabilityPrefetchRule::matches(const ArticleRef &article)
 QFuture<void> ReadabilityPrefetchRule::beginPerformAction(const ArticleRef &article)
 {
     // make sure we still match when it's time to run
-    if (!matches(article)) {
-        return QtFuture::makeReadyVoidFuture();
+    if (matches(article)) {
+        m_scheduler->enqueue(article);
     }
-
-    auto *promise = new QPromise<void>();
-    promise->start();
-
-    ReadabilityResult *result = m_readability->fetch(article->url());
-
-    QObject::connect(result, &ReadabilityResult::finished, result, [article, promise](const QString &content) {
-        article->cacheReadableContent(content);
-        promise->finish();
-        delete promise;
-    });
-
-    QObject::connect(result, &ReadabilityResult::error, result, [promise, article]() {
-        qDebug() << "Readability content fetch failed for " << article->url();
-        promise->finish();
-        delete promise;
-    });
-
-    return promise->future();
+    return QtFuture::makeReadyVoidFuture();
 }
@@ -9,20 +9,24 @@
 
 namespace FeedCore
 {
-class Readability;
-class ReadabilityResult;
+class ReadabilityPrefetchScheduler;
 
+/**
+ * Hands new articles from feeds that use readable content to a ReadabilityPrefetchScheduler
+ *
+ * The action finishes as soon as the article is queued; the scheduler decides when to fetch it.
+ */
 class ReadabilityPrefetchRule : public AbstractAutomationRule
 {
     Q_OBJECT
 
 public:
-    explicit ReadabilityPrefetchRule(Readability *readability, QObject *parent = nullptr);
+    explicit ReadabilityPrefetchRule(ReadabilityPrefetchScheduler *scheduler, QObject *parent = nullptr);
     bool matches(const ArticleRef &article) override;
     QFuture<void> beginPerformAction(const ArticleRef &article) override;
 
 private:
-    Readability *m_readability;
+    ReadabilityPrefetchScheduler *m_scheduler;
 };
 
 } // namespace FeedCore
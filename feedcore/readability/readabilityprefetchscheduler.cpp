@@ -0,0 +1,303 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "readabilityprefetchscheduler.h"
+#include "article.h"
+#include "feed.h"
+#include "future.h"
+#include "readability.h"
+#include "readabilityresult.h"
+#include "readablecontentcache.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFlags>
+#include <QHash>
+#include <QNetworkInformation>
+#include <QQueue>
+#include <QTimer>
+#include <algorithm>
+using namespace FeedCore;
+
+/* prefetches run at most this many at a time */
+static constexpr const int kMaxActivePrefetches = 2;
+
+/* when more articles than this are waiting, the oldest are dropped */
+static constexpr const int kMaxPending = 1000;
+
+static constexpr const qint64 kBudgetWindowMsecs = 60 * 60 * 1000;
+
+namespace
+{
+struct PrefetchCost {
+    qint64 time;
+    qint64 bytes;
+    qint64 parseMsecs;
+};
+}
+
+struct ReadabilityPrefetchScheduler::PrivData {
+    Readability *readability;
+    QSharedPointer<Feed> monitor;
+    QList<ArticleRef> pending;
+    QHash<Feed *, int> openCounts;
+    QQueue<PrefetchCost> costs;
+    QTimer wakeTimer;
+    QElapsedTimer idleTimer;
+    qint64 maxBytesPerHour{kDefaultMaxBytesPerHour};
+    qint64 maxParseMsecsPerHour{kDefaultMaxParseMsecsPerHour};
+    int settleDelay{kDefaultSettleDelay};
+    int active{0};
+
+    void expireCosts();
+    bool overBudget() const;
+    void wakeAfter(qint64 msecs);
+    ArticleRef takeNext();
+};
+
+static bool isMetered()
+{
+    const auto *info = QNetworkInformation::instance();
+    return info != nullptr && info->isMetered();
+}
+
+static bool wantsReadableContent(const ArticleRef &article)
+{
+    Feed *feed = article->feed();
+    return feed != nullptr && !article->isRead() && QFlags<Feed::FeedFlags>(feed->flags()).testFlag(Feed::UseReadableContentFlag);
+}
+
+void ReadabilityPrefetchScheduler::PrivData::expireCosts()
+{
+    const qint64 cutoff = QDateTime::currentMSecsSinceEpoch() - kBudgetWindowMsecs;
+    while (!costs.isEmpty() && costs.head().time <= cutoff) {
+        costs.dequeue();
+    }
+}
+
+bool ReadabilityPrefetchScheduler::PrivData::overBudget() const
+{
+    qint64 bytes{0};
+    qint64 parseMsecs{0};
+    for (const auto &cost : costs) {
+        bytes += cost.bytes;
+        parseMsecs += cost.parseMsecs;
+    }
+    return bytes >= maxBytesPerHour || parseMsecs >= maxParseMsecsPerHour;
+}
+
+void ReadabilityPrefetchScheduler::PrivData::wakeAfter(qint64 msecs)
+{
+    if (!wakeTimer.isActive() || wakeTimer.remainingTime() > msecs) {
+        wakeTimer.start(std::max<qint64>(0, msecs));
+    }
+}
+
+/* the waiting article that the user is most likely to read next */
+ArticleRef ReadabilityPrefetchScheduler::PrivData::takeNext()
+{
+    pending.removeIf([](const ArticleRef &article) {
+        return !wantsReadableContent(article);
+    });
+    if (pending.isEmpty()) {
+        return nullptr;
+    }
+    auto best = pending.begin();
+    int bestOpens = openCounts.value((*best)->feed());
+    for (auto it = std::next(best); it != pending.end(); ++it) {
+        const int opens = openCounts.value((*it)->feed());
+        if (opens > bestOpens || (opens == bestOpens && (*it)->date() > (*best)->date())) {
+            best = it;
+            bestOpens = opens;
+        }
+    }
+    ArticleRef result = *best;
+    pending.erase(best);
+    return result;
+}
+
+ReadabilityPrefetchScheduler::ReadabilityPrefetchScheduler(Readability *readability, const QSharedPointer<Feed> &updateMonitor, QObject *parent)
+    : QObject(parent)
+    , d{std::make_unique<PrivData>()}
+{
+    d->readability = readability;
+    d->monitor = updateMonitor;
+    d->wakeTimer.setSingleShot(true);
+    QObject::connect(&d->wakeTimer, &QTimer::timeout, this, &ReadabilityPrefetchScheduler::scheduleNext);
+    if (d->monitor) {
+        QObject::connect(d->monitor.get(), &Feed::statusChanged, this, &ReadabilityPrefetchScheduler::onMonitorStatusChanged);
+    }
+    if (auto *info = QNetworkInformation::instance()) {
+        QObject::connect(info, &QNetworkInformation::isMeteredChanged, this, &ReadabilityPrefetchScheduler::scheduleNext);
+    }
+    onMonitorStatusChanged();
+}
+
+ReadabilityPrefetchScheduler::~ReadabilityPrefetchScheduler() = default;
+
+void ReadabilityPrefetchScheduler::enqueue(const ArticleRef &article)
+{
+    if (d->pending.contains(article)) {
+        return;
+    }
+    d->pending << article;
+    if (d->pending.size() > kMaxPending) {
+        d->pending.removeFirst();
+    }
+    scheduleNext();
+}
+
+void ReadabilityPrefetchScheduler::noteFeedOpened(Feed *feed)
+{
+    if (feed != nullptr) {
+        d->openCounts[feed] += 1;
+    }
+}
+
+int ReadabilityPrefetchScheduler::pendingCount() const
+{
+    return static_cast<int>(d->pending.size());
+}
+
+qint64 ReadabilityPrefetchScheduler::maxBytesPerHour() const
+{
+    return d->maxBytesPerHour;
+}
+
+void ReadabilityPrefetchScheduler::setMaxBytesPerHour(qint64 maxBytesPerHour)
+{
+    d->maxBytesPerHour = maxBytesPerHour;
+    scheduleNext();
+}
+
+qint64 ReadabilityPrefetchScheduler::maxParseMsecsPerHour() const
+{
+    return d->maxParseMsecsPerHour;
+}
+
+void ReadabilityPrefetchScheduler::setMaxParseMsecsPerHour(qint64 maxParseMsecsPerHour)
+{
+    d->maxParseMsecsPerHour = maxParseMsecsPerHour;
+    scheduleNext();
+}
+
+int ReadabilityPrefetchScheduler::settleDelay() const
+{
+    return d->settleDelay;
+}
+
+void ReadabilityPrefetchScheduler::setSettleDelay(int settleDelay)
+{
+    d->settleDelay = settleDelay;
+    d->wakeTimer.stop();
+    scheduleNext();
+}
+
+qint64 ReadabilityPrefetchScheduler::bytesInLastHour() const
+{
+    d->expireCosts();
+    qint64 result{0};
+    for (const auto &cost : std::as_const(d->costs)) {
+        result += cost.bytes;
+    }
+    return result;
+}
+
+qint64 ReadabilityPrefetchScheduler::parseMsecsInLastHour() const
+{
+    d->expireCosts();
+    qint64 result{0};
+    for (const auto &cost : std::as_const(d->costs)) {
+        result += cost.parseMsecs;
+    }
+    return result;
+}
+
+void ReadabilityPrefetchScheduler::onMonitorStatusChanged()
+{
+    const auto status = d->monitor ? d->monitor->status() : Feed::Idle;
+    if (status == Feed::Updating || status == Feed::Loading) {
+        d->idleTimer.invalidate();
+        d->wakeTimer.stop();
+        return;
+    }
+    if (!d->idleTimer.isValid()) {
+        d->idleTimer.start();
+    }
+    scheduleNext();
+}
+
+void ReadabilityPrefetchScheduler::scheduleNext()
+{
+    while (!d->pending.isEmpty() && d->active < kMaxActivePrefetches) {
+        // wait for updates to settle; onMonitorStatusChanged restarts us
+        if (!d->idleTimer.isValid()) {
+            return;
+        }
+        if (d->idleTimer.elapsed() < d->settleDelay) {
+            d->wakeAfter(d->settleDelay - d->idleTimer.elapsed());
+            return;
+        }
+
+        // isMeteredChanged restarts us
+        if (isMetered()) {
+            return;
+        }
+
+        d->expireCosts();
+        if (d->overBudget()) {
+            // with a budget of zero there is nothing to wait for
+            if (d->costs.isEmpty()) {
+                return;
+            }
+            d->wakeAfter(d->costs.head().time + kBudgetWindowMsecs - QDateTime::currentMSecsSinceEpoch());
+            return;
+        }
+
+        const ArticleRef &article = d->takeNext();
+        if (article) {
+            prefetch(article);
+        }
+    }
+}
+
+void ReadabilityPrefetchScheduler::prefetch(const ArticleRef &article)
+{
+    // the page may have been fetched already for another article
+    d->active += 1;
+    QFuture<ReadableContentCache::Entry> cached = ReadableContentCache::lookup(article->url());
+    Future::safeThen(cached, this, [this, article](auto &fut) {
+        const ReadableContentCache::Entry &entry = fut.result();
+        if (entry.isFresh()) {
+            d->active -= 1;
+            article->cacheReadableContent(entry.content);
+            emit prefetched(article, entry.content);
+            scheduleNext();
+            return;
+        }
+        fetch(article);
+    });
+}
+
+void ReadabilityPrefetchScheduler::fetch(const ArticleRef &article)
+{
+    ReadabilityResult *result = d->readability->fetch(article->url(), Readability::BackgroundPriority);
+    auto recordCost = [this, result] {
+        d->costs.enqueue({QDateTime::currentMSecsSinceEpoch(), result->bytes(), result->parseMsecs()});
+        d->active -= 1;
+    };
+
+    QObject::connect(result, &ReadabilityResult::finished, this, [this, article, recordCost](const QString &content) {
+        recordCost();
+        article->cacheReadableContent(content);
+        emit prefetched(article, content);
+        scheduleNext();
+    });
+
+    QObject::connect(result, &ReadabilityResult::error, this, [this, article, recordCost] {
+        qDebug() << "Readability content fetch failed for " << article->url();
+        recordCost();
+        scheduleNext();
+    });
+}
@@ -0,0 +1,91 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#pragma once
+
+#include "articleref.h"
+#include <QObject>
+#include <QSharedPointer>
+#include <memory>
+
+namespace FeedCore
+{
+class Feed;
+class Readability;
+
+/**
+ * Fetches readable content for new articles in the background
+ *
+ * Prefetching every new article as it arrives competes with feed updates for the
+ * network, and can use a lot of data on a large subscription list.  The scheduler
+ * holds the articles back until the monitored feed (normally the context's
+ * allItemsFeed) has been idle for settleDelay() msecs, and then fetches them a few
+ * at a time, preferring unread articles from the feeds the user has opened most.
+ *
+ * The bytes downloaded and the time spent parsing over the last hour are capped,
+ * and nothing is fetched while the network is metered.  Articles that are still
+ * waiting when the budget runs out are fetched once older fetches have aged out of
+ * the window.
+ */
+class ReadabilityPrefetchScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr const qint64 kDefaultMaxBytesPerHour = 50 * 1024 * 1024;
+    static constexpr const qint64 kDefaultMaxParseMsecsPerHour = 60 * 1000;
+    static constexpr const int kDefaultSettleDelay = 5000;
+
+    ReadabilityPrefetchScheduler(Readability *readability, const QSharedPointer<Feed> &updateMonitor, QObject *parent = nullptr);
+    ~ReadabilityPrefetchScheduler();
+
+    /**
+     * Add /article/ to the articles waiting to be prefetched.
+     */
+    void enqueue(const ArticleRef &article);
+
+    /**
+     * Record that the user has read an article from /feed/.  Articles from feeds that
+     * are opened more often are prefetched first.
+     */
+    void noteFeedOpened(Feed *feed);
+
+    /**
+     * The number of articles waiting to be prefetched.
+     */
+    int pendingCount() const;
+
+    qint64 maxBytesPerHour() const;
+    void setMaxBytesPerHour(qint64 maxBytesPerHour);
+    qint64 maxParseMsecsPerHour() const;
+    void setMaxParseMsecsPerHour(qint64 maxParseMsecsPerHour);
+
+    /**
+     * How long (in msecs) the monitored feed must be idle before prefetching starts.
+     */
+    int settleDelay() const;
+    void setSettleDelay(int settleDelay);
+
+    /**
+     * The bytes downloaded and msecs spent parsing for prefetches in the last hour.
+     */
+    qint64 bytesInLastHour() const;
+    qint64 parseMsecsInLastHour() const;
+
+signals:
+    /**
+     * Emitted with the readable content of each article that has been prefetched.
+     */
+    void prefetched(const FeedCore::ArticleRef &article, const QString &content);
+
+private:
+    struct PrivData;
+    std::unique_ptr<PrivData> d;
+    void scheduleNext();
+    void prefetch(const ArticleRef &article);
+    void fetch(const ArticleRef &article);
+    void onMonitorStatusChanged();
+};
+
+}
@@ -11,8 +11,27 @@ class ReadabilityResult : public QObject
 {
     Q_OBJECT
 
+public:
+    /**
+     * The size of the page that was downloaded, once the result has finished.
+     */
+    qint64 bytes() const
+    {
+        return m_bytes;
+    }
+
+    /**
+     * The time (in msecs) spent extracting the content, once the result has finished.
+     */
+    qint64 parseMsecs() const
+    {
+        return m_parseMsecs;
+    }
+
 protected:
     using QObject::QObject;
+    qint64 m_bytes{0};
+    qint64 m_parseMsecs{0};
 
 signals:
     void finished(const QString &content);
@@ -0,0 +1,287 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#include "readablecontentcache.h"
+#include "cachestore.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QPromise>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <QUrlQuery>
+#include <memory>
+using namespace FeedCore;
+
+/* entries larger than this fraction of the maximum cache size are not stored */
+static constexpr const int kMaxEntryFraction = 8;
+
+static constexpr const quint32 kEntryMagic = 0x53594e52;
+static constexpr const qint32 kEntryVersion = 2;
+static constexpr const QDataStream::Version kStreamVersion = QDataStream::Qt_6_0;
+
+namespace
+{
+// one thread, so that each read sees the writes that were queued before it
+class CachePool : public QThreadPool
+{
+public:
+    CachePool()
+    {
+        setMaxThreadCount(1);
+    }
+};
+}
+
+static QThreadPool &cachePool()
+{
+    static CachePool instance;
+    return instance;
+}
+
+template<typename T, typename Func>
+static QFuture<T> runInCacheThread(Func func)
+{
+    auto promise = std::make_shared<QPromise<T>>();
+    QFuture<T> future = promise->future();
+    cachePool().start([promise, func] {
+        promise->start();
+        func(*promise);
+        promise->finish();
+    });
+    return future;
+}
+
+static CacheStore *readableStore()
+{
+    static auto *instance = new CacheStore(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/readable/"),
+                                           ReadableContentCache::kDefaultMaximumCacheSize);
+    return instance;
+}
+
+static bool isTrackingParameter(const QString &name)
+{
+    return name.startsWith(QLatin1String("utm_")) || name == QLatin1String("fbclid") || name == QLatin1String("gclid")
+        || name == QLatin1String("mc_cid") || name == QLatin1String("mc_eid");
+}
+
+static bool writeFile(const QString &path, const QByteArray &data)
+{
+    QDir().mkpath(path.left(path.lastIndexOf('/')));
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(data);
+    return file.commit();
+}
+
+static bool writeMetaData(const QString &path, const ReadableContentCache::Entry &entry, qint64 payloadSize)
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(kStreamVersion);
+    out << kEntryMagic << kEntryVersion << entry.url << entry.fetched << entry.etag << entry.lastModified << payloadSize;
+    return out.status() == QDataStream::Ok && writeFile(path, data);
+}
+
+static bool readMetaData(const QString &path, const QUrl &url, ReadableContentCache::Entry *entry, qint64 *payloadSize)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&file);
+    in.setVersion(kStreamVersion);
+    quint32 magic{0};
+    qint32 version{0};
+    in >> magic >> version;
+    if (magic != kEntryMagic || version != kEntryVersion) {
+        return false;
+    }
+    ReadableContentCache::Entry stored;
+    qint64 size{0};
+    in >> stored.url >> stored.fetched >> stored.etag >> stored.lastModified >> size;
+
+    // guard against hash collisions and truncated files
+    if (in.status() != QDataStream::Ok || stored.url != url) {
+        return false;
+    }
+    *entry = stored;
+    *payloadSize = size;
+    return true;
+}
+
+static bool readContent(const QString &path, qint64 payloadSize, QString *content)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || file.size() != payloadSize) {
+        return false;
+    }
+    const QByteArray &compressed = file.readAll();
+    const QByteArray &uncompressed = qUncompress(compressed);
+    if (uncompressed.isEmpty() && !compressed.isEmpty()) {
+        return false;
+    }
+    *content = QString::fromUtf8(uncompressed);
+    return true;
+}
+
+static void discard(const QByteArray &key)
+{
+    auto *store = readableStore();
+    store->drop(key);
+    QMutexLocker lock(&store->fileLock(key));
+    store->removeFiles(key);
+}
+
+bool ReadableContentCache::Entry::isValid() const
+{
+    return url.isValid() && fetched.isValid();
+}
+
+bool ReadableContentCache::Entry::isFresh() const
+{
+    return isValid() && fetched.daysTo(QDateTime::currentDateTime()) < kMaxAgeDays;
+}
+
+qint64 ReadableContentCache::maximumCacheSize()
+{
+    return readableStore()->maximumSize();
+}
+
+void ReadableContentCache::setMaximumCacheSize(qint64 size)
+{
+    readableStore()->setMaximumSize(size);
+}
+
+qint64 ReadableContentCache::cacheSize()
+{
+    return readableStore()->size();
+}
+
+QUrl ReadableContentCache::canonicalUrl(const QUrl &url)
+{
+    QUrl result = url.adjusted(QUrl::RemoveFragment | QUrl::NormalizePathSegments);
+    if (result.port() == 80 && result.scheme() == QLatin1String("http")) {
+        result.setPort(-1);
+    } else if (result.port() == 443 && result.scheme() == QLatin1String("https")) {
+        result.setPort(-1);
+    }
+    if (result.hasQuery()) {
+        QUrlQuery query(result);
+        const auto &items = query.queryItems(QUrl::FullyEncoded);
+        for (const auto &item : items) {
+            if (isTrackingParameter(item.first)) {
+                query.removeAllQueryItems(item.first);
+            }
+        }
+        result.setQuery(query.isEmpty() ? QString() : query.query(QUrl::FullyEncoded), QUrl::StrictMode);
+    }
+    return result;
+}
+
+QFuture<ReadableContentCache::Entry> ReadableContentCache::lookup(const QUrl &url)
+{
+    return runInCacheThread<Entry>([canonical = canonicalUrl(url)](QPromise<Entry> &promise) {
+        auto *store = readableStore();
+        const QByteArray &key = CacheStore::keyForUrl(canonical);
+        Entry result;
+        qint64 payloadSize{0};
+        if (!store->contains(key)) {
+            promise.addResult(Entry());
+            return;
+        }
+        if (!readMetaData(store->metaDataPathForKey(key), canonical, &result, &payloadSize)
+            || !readContent(store->pathForKey(key), payloadSize, &result.content)) {
+            discard(key);
+            promise.addResult(Entry());
+            return;
+        }
+        store->touch(key);
+        promise.addResult(result);
+    });
+}
+
+QFuture<ReadableContentCache::Entry> ReadableContentCache::validators(const QUrl &url)
+{
+    return runInCacheThread<Entry>([canonical = canonicalUrl(url)](QPromise<Entry> &promise) {
+        auto *store = readableStore();
+        const QByteArray &key = CacheStore::keyForUrl(canonical);
+        Entry result;
+        qint64 payloadSize{0};
+        if (!store->contains(key) || !readMetaData(store->metaDataPathForKey(key), canonical, &result, &payloadSize)) {
+            promise.addResult(Entry());
+            return;
+        }
+        promise.addResult(result);
+    });
+}
+
+QFuture<void> ReadableContentCache::insert(const Entry &entry)
+{
+    Entry canonicalEntry(entry);
+    canonicalEntry.url = canonicalUrl(entry.url);
+    return runInCacheThread<void>([canonicalEntry](QPromise<void> &) {
+        if (!canonicalEntry.isValid()) {
+            return;
+        }
+        auto *store = readableStore();
+        const QByteArray &key = CacheStore::keyForUrl(canonicalEntry.url);
+        const QByteArray &compressed = qCompress(canonicalEntry.content.toUtf8());
+        if (compressed.size() > store->maximumSize() / kMaxEntryFraction) {
+            discard(key);
+            return;
+        }
+
+        // the content first, so that metadata is never read for content that isn't there
+        const QString &metaDataPath = store->metaDataPathForKey(key);
+        if (!writeFile(store->pathForKey(key), compressed) || !writeMetaData(metaDataPath, canonicalEntry, compressed.size())) {
+            discard(key);
+            return;
+        }
+        store->add(key, compressed.size() + QFileInfo(metaDataPath).size());
+        store->evictIfNeeded();
+    });
+}
+
+QFuture<void> ReadableContentCache::revalidate(const Entry &entry)
+{
+    Entry canonicalEntry(entry);
+    canonicalEntry.url = canonicalUrl(entry.url);
+    return runInCacheThread<void>([canonicalEntry](QPromise<void> &) {
+        auto *store = readableStore();
+        const QByteArray &key = CacheStore::keyForUrl(canonicalEntry.url);
+        const QString &metaDataPath = store->metaDataPathForKey(key);
+        Entry stored;
+        qint64 payloadSize{0};
+        if (!canonicalEntry.isValid() || !store->contains(key) || !readMetaData(metaDataPath, canonicalEntry.url, &stored, &payloadSize)) {
+            return;
+        }
+        if (!writeMetaData(metaDataPath, canonicalEntry, payloadSize)) {
+            discard(key);
+            return;
+        }
+        store->add(key, payloadSize + QFileInfo(metaDataPath).size());
+    });
+}
+
+bool ReadableContentCache::remove(const QUrl &url)
+{
+    auto *store = readableStore();
+    const QByteArray &key = CacheStore::keyForUrl(canonicalUrl(url));
+    const bool dropped = store->drop(key);
+    QMutexLocker lock(&store->fileLock(key));
+    return store->removeFiles(key) || dropped;
+}
+
+QFuture<void> ReadableContentCache::clear()
+{
+    // queued with the writes, so that none of them land after the clear
+    return runInCacheThread<void>([](QPromise<void> &) {
+        readableStore()->dropAll();
+    });
+}
@@ -0,0 +1,88 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFuture>
+#include <QString>
+#include <QUrl>
+
+namespace FeedCore
+{
+
+/**
+ * A persistent cache of readable content, keyed by the canonical url of the page
+ *
+ * Articles also keep their own copy of their readable content, but that is lost when
+ * the article expires, and isn't shared with other articles that link to the same
+ * page. This cache sits in front of Readability so that a page is only fetched and
+ * parsed once. Each entry keeps the validators of the page it was made from, so that
+ * a reload can ask the server whether the page has changed instead of parsing it
+ * again.
+ *
+ * Entries are stored compressed, in their own directory with its own size limit,
+ * and the least recently used entries are evicted first.  The validators are kept in
+ * a small metadata file next to the content, so they can be read and updated without
+ * touching the content.  The files are read and written on a worker thread, in the
+ * order that the calls were made.
+ */
+class ReadableContentCache
+{
+public:
+    struct Entry {
+        QUrl url;
+        QDateTime fetched; /** < when the page was last fetched or revalidated */
+        QByteArray etag;
+        QByteArray lastModified;
+        QString content;
+
+        bool isValid() const;
+
+        /**
+         * Whether the entry can be used without asking the server if the page has changed.
+         */
+        bool isFresh() const;
+    };
+
+    static constexpr const qint64 kDefaultMaximumCacheSize = 50 * 1024 * 1024;
+    static constexpr const int kMaxAgeDays = 30;
+
+    /**
+     * The size (in bytes) that the cache is allowed to grow to before old entries are evicted.
+     */
+    static qint64 maximumCacheSize();
+    static void setMaximumCacheSize(qint64 size);
+    static qint64 cacheSize();
+
+    /**
+     * The url that identifies a page: without a fragment, a default port or tracking parameters.
+     */
+    static QUrl canonicalUrl(const QUrl &url);
+
+    /**
+     * The entry for /url/, or an invalid entry if there isn't one.
+     */
+    static QFuture<Entry> lookup(const QUrl &url);
+
+    /**
+     * The entry for /url/ without its content, or an invalid entry if there isn't one.
+     * Only the metadata is read.
+     */
+    static QFuture<Entry> validators(const QUrl &url);
+
+    static QFuture<void> insert(const Entry &entry);
+
+    /**
+     * Record that the page for /entry/ was revalidated, keeping the content that is
+     * already stored.  Only the metadata is rewritten.
+     */
+    static QFuture<void> revalidate(const Entry &entry);
+
+    static bool remove(const QUrl &url);
+    static QFuture<void> clear();
+};
+
+}
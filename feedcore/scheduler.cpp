@@ -5,49 +5,214 @@
 
 #include "scheduler.h"
 #include "feed.h"
-#include <QSet>
+#include "updatepacer.h"
+#include <QHash>
+#include <QPointer>
 #include <QTimer>
+#include <algorithm>
+#include <vector>
 
 namespace FeedCore
 {
+/* Upper bound on a single timer wait. The timer runs on a monotonic clock, so
+ * we wake up now and then to catch wall clock changes and system suspends. */
+static constexpr const qint64 kMaxTimerInterval = 15 * 60 * 1000;
+
+namespace
+{
+/* Binary min-heap of feeds ordered by their next update time (msecs since epoch).
+ * The position of each feed is indexed so that it can be moved or removed in O(log n). */
+class ScheduleQueue
+{
+public:
+    struct Entry {
+        qint64 due;
+        Feed *feed;
+    };
+
+    bool isEmpty() const
+    {
+        return m_heap.empty();
+    }
+
+    const Entry &top() const
+    {
+        return m_heap.front();
+    }
+
+    const std::vector<Entry> &entries() const
+    {
+        return m_heap;
+    }
+
+    void insert(Feed *feed, qint64 due)
+    {
+        const auto it = m_index.constFind(feed);
+        if (it != m_index.cend()) {
+            const size_t pos = *it;
+            m_heap[pos].due = due;
+            if (siftUp(pos) == pos) {
+                siftDown(pos);
+            }
+            return;
+        }
+        m_heap.push_back({due, feed});
+        m_index.insert(feed, m_heap.size() - 1);
+        siftUp(m_heap.size() - 1);
+    }
+
+    bool remove(Feed *feed)
+    {
+        const auto it = m_index.constFind(feed);
+        if (it == m_index.cend()) {
+            return false;
+        }
+        const size_t pos = *it;
+        const size_t last = m_heap.size() - 1;
+        m_index.erase(it);
+        if (pos != last) {
+            m_heap[pos] = m_heap[last];
+            m_index[m_heap[pos].feed] = pos;
+        }
+        m_heap.pop_back();
+        if (pos < m_heap.size() && siftUp(pos) == pos) {
+            siftDown(pos);
+        }
+        return true;
+    }
+
+    Feed *pop()
+    {
+        Feed *feed = top().feed;
+        remove(feed);
+        return feed;
+    }
+
+private:
+    std::vector<Entry> m_heap;
+    QHash<Feed *, size_t> m_index;
+
+    void swapEntries(size_t a, size_t b)
+    {
+        std::swap(m_heap[a], m_heap[b]);
+        m_index[m_heap[a].feed] = a;
+        m_index[m_heap[b].feed] = b;
+    }
+
+    size_t siftUp(size_t pos)
+    {
+        while (pos > 0) {
+            const size_t parent = (pos - 1) / 2;
+            if (m_heap[parent].due <= m_heap[pos].due) {
+                break;
+            }
+            swapEntries(pos, parent);
+            pos = parent;
+        }
+        return pos;
+    }
+
+    size_t siftDown(size_t pos)
+    {
+        const size_t count = m_heap.size();
+        for (;;) {
+            const size_t left = 2 * pos + 1;
+            const size_t right = left + 1;
+            size_t smallest = pos;
+            if (left < count && m_heap[left].due < m_heap[smallest].due) {
+                smallest = left;
+            }
+            if (right < count && m_heap[right].due < m_heap[smallest].due) {
+                smallest = right;
+            }
+            if (smallest == pos) {
+                return pos;
+            }
+            swapEntries(pos, smallest);
+            pos = smallest;
+        }
+    }
+};
+}
+
 struct Scheduler::PrivData {
-    QList<Feed *> schedule;
+    ScheduleQueue schedule;
     QTimer timer;
+    QPointer<UpdatePacer> pacer;
+    qint64 armedTime{0};
+    bool running{false};
 };
 
 Scheduler::Scheduler(QObject *parent)
     : QObject(parent)
     , d(std::make_unique<PrivData>())
 {
+    d->timer.setSingleShot(true);
+    d->timer.callOnTimeout(this, &Scheduler::updateStale);
 }
 
 Scheduler::~Scheduler() = default;
 
-static QDateTime nextUpdate(Feed *feed)
+static qint64 nextUpdate(Feed *feed)
 {
+    // after a failure, wait out the backoff period instead of the regular interval
+    if (feed->failureCount() > 0 && feed->retryTime().isValid()) {
+        return feed->retryTime().toMSecsSinceEpoch();
+    }
+
     const QDateTime &updateStartTime = feed->updater()->updateStartTime();
-    QDateTime lastUpdate{updateStartTime.isValid() ? updateStartTime : feed->lastUpdate()};
-    return lastUpdate.addSecs(feed->updateInterval());
+    const QDateTime &lastUpdate{updateStartTime.isValid() ? updateStartTime : feed->lastUpdate()};
+    if (!lastUpdate.isValid()) {
+        return 0;
+    }
+    const QDateTime updateTime = lastUpdate.addSecs(feed->updateInterval());
+
+    // an interval chosen by the user wins, otherwise respect what the publisher asked for
+    if (feed->updateMode() != Feed::InheritUpdateMode && feed->updateMode() != Feed::AdaptiveUpdateMode) {
+        return updateTime.toMSecsSinceEpoch();
+    }
+    const UpdateHints &hints = feed->updateHints();
+    const QDateTime &floor = hints.notBefore.isValid() && hints.notBefore > updateTime ? hints.notBefore : updateTime;
+    return hints.nextAllowedTime(floor).toMSecsSinceEpoch();
 }
 
-static bool needsUpdate(Feed *feed, const QDateTime &timestamp)
+static bool needsUpdate(qint64 updateTime, const QDateTime &timestamp)
 {
-    return nextUpdate(feed) < timestamp;
+    return updateTime <= timestamp.toMSecsSinceEpoch();
 }
 
-void insertIntoSchedule(QList<Feed *> &schedule, Feed *feed)
+void Scheduler::insertIntoSchedule(Feed *feed)
 {
     if (feed->updateMode() == Feed::DisableUpdateMode || feed->updateInterval() <= 0) {
+        removeFromSchedule(feed);
         return;
     }
-    const QDateTime &updateTime{nextUpdate(feed)};
-    for (auto i = schedule.cbegin(); i != schedule.cend(); ++i) {
-        if (nextUpdate(*i) >= updateTime) {
-            schedule.insert(i, feed);
-            return;
-        }
+    d->schedule.insert(feed, nextUpdate(feed));
+    armTimer();
+}
+
+void Scheduler::removeFromSchedule(Feed *feed)
+{
+    if (d->schedule.remove(feed)) {
+        armTimer();
+    }
+}
+
+void Scheduler::armTimer()
+{
+    if (!d->running || d->schedule.isEmpty()) {
+        d->timer.stop();
+        return;
+    }
+
+    // only touch the timer when the earliest update time changes
+    const qint64 updateTime = d->schedule.top().due;
+    if (d->timer.isActive() && d->armedTime == updateTime) {
+        return;
     }
-    schedule.append(feed);
+    d->armedTime = updateTime;
+    const qint64 delay = updateTime - QDateTime::currentMSecsSinceEpoch();
+    d->timer.start(static_cast<int>(std::clamp<qint64>(delay, 0, kMaxTimerInterval)));
 }
 
 void Scheduler::schedule(Feed *feed, const QDateTime &timestamp)
@@ -59,22 +224,20 @@ void Scheduler::schedule(Feed *feed, const QDateTime &timestamp)
         reschedule(feed);
     });
     QObject::connect(feed, &QObject::destroyed, this, [this, feed] {
-        d->schedule.removeAll(feed);
+        removeFromSchedule(feed);
     });
     reschedule(feed, timestamp);
 }
 
 void Scheduler::unschedule(Feed *feed)
 {
-    d->schedule.removeOne(feed);
+    removeFromSchedule(feed);
     QObject::disconnect(feed, nullptr, this, nullptr);
 }
 
-void Scheduler::start(int resolution)
+void Scheduler::start()
 {
-    d->timer.setInterval(resolution);
-    d->timer.callOnTimeout(this, &Scheduler::updateStale);
-    d->timer.start();
+    d->running = true;
 
     // also update immediately, in case anything was scheduled while we were stopped
     updateStale();
@@ -82,69 +245,92 @@ void Scheduler::start(int resolution)
 
 void Scheduler::stop()
 {
+    d->running = false;
     d->timer.stop();
 }
 
 bool Scheduler::isRunning()
 {
-    return d->timer.isActive();
+    return d->running;
+}
+
+void Scheduler::setUpdatePacer(UpdatePacer *pacer)
+{
+    d->pacer = pacer;
 }
 
-static void updateMany(const QDateTime &timestamp, const QList<Feed::Updater *> &toUpdate)
+static void updateMany(UpdatePacer *pacer, const QDateTime &timestamp, const QList<Feed::Updater *> &toUpdate)
 {
     for (auto *entry : toUpdate) {
-        entry->start(timestamp);
+        entry->startPaced(pacer, timestamp);
+    }
+}
+
+qint64 Scheduler::adaptiveUpdateInterval(const QList<QDateTime> &publicationDates, const QDateTime &timestamp)
+{
+    // until a feed has published something, check it as rarely as we're allowed to
+    if (publicationDates.isEmpty()) {
+        return kMaxAdaptiveInterval;
     }
+
+    const QDateTime &oldest = *std::min_element(publicationDates.begin(), publicationDates.end());
+    const qint64 interval = oldest.secsTo(timestamp) / publicationDates.size();
+    return qBound(kMinAdaptiveInterval, interval, kMaxAdaptiveInterval);
 }
 
 void Scheduler::updateStale()
 {
-    // find all the stale feeds before we start updating them so that we don't modify the schedule while we're searching it...
+    // take all the stale feeds off the schedule before we start updating them so that we don't modify the schedule while we're searching it...
     const auto &timestamp = QDateTime::currentDateTime();
     QList<Feed::Updater *> toUpdate{};
-    const auto &schedule{d->schedule};
-    for (Feed *entry : schedule) {
-        if (!needsUpdate(entry, timestamp)) {
-            break;
-        }
-        toUpdate << entry->updater();
+    auto &schedule{d->schedule};
+    while (!schedule.isEmpty() && needsUpdate(schedule.top().due, timestamp)) {
+        toUpdate << schedule.pop()->updater();
     }
-    updateMany(timestamp, toUpdate);
+    updateMany(d->pacer, timestamp, toUpdate);
+    armTimer();
 }
 
 void Scheduler::clearErrors()
 {
+    QDateTime timestamp{QDateTime::currentDateTime()};
     QList<Feed *> errorFeeds;
-    for (Feed *feed : std::as_const(d->schedule)) {
-        if (feed->status() == Feed::Error) {
-            errorFeeds << feed;
+    for (const auto &entry : d->schedule.entries()) {
+        if (entry.feed->status() != Feed::Error) {
+            continue;
+        }
+
+        // don't jump ahead of a server that explicitly asked us to wait
+        const QDateTime &retryAfter = entry.feed->updater()->retryAfter();
+        if (retryAfter.isValid() && retryAfter > timestamp) {
+            continue;
         }
+        errorFeeds << entry.feed;
     }
-    QDateTime timestamp{QDateTime::currentDateTime()};
     for (Feed *feed : std::as_const(errorFeeds)) {
-        feed->updater()->start(timestamp);
+        feed->updater()->startPaced(d->pacer, timestamp);
     }
 }
 
 void Scheduler::reschedule(Feed *feed, const QDateTime &timestamp)
 {
-    d->schedule.removeOne(feed);
+    removeFromSchedule(feed);
     if (feed->status() == LoadStatus::Updating) {
         return;
     }
-    if (isRunning() && needsUpdate(feed, timestamp)) {
-        feed->updater()->start(timestamp);
+    if (isRunning() && needsUpdate(nextUpdate(feed), timestamp)) {
+        feed->updater()->startPaced(d->pacer, timestamp);
     } else {
-        insertIntoSchedule(d->schedule, feed);
+        insertIntoSchedule(feed);
     }
 }
 
 void Scheduler::onFeedStatusChanged(Feed *sender)
 {
     if (sender->status() == LoadStatus::Updating) {
-        d->schedule.removeOne(sender);
+        removeFromSchedule(sender);
     } else {
-        insertIntoSchedule(d->schedule, sender);
+        insertIntoSchedule(sender);
     }
 }
 
@@ -12,6 +12,8 @@
 
 namespace FeedCore
 {
+class UpdatePacer;
+
 /**
  * Automatically update feeds when they become stale
  */
@@ -35,15 +37,13 @@ public:
      */
     void unschedule(Feed *feedRef);
 
-    static constexpr const int kDefaultTimerResolution = 60000;
-
     /**
      * Start the update timer
      *
-     * Once this method is called, stale feeds will be checked for every /resolution/ msecs
-     * until stop() is called.
+     * Once this method is called, each scheduled feed will be updated when it becomes
+     * stale until stop() is called.
      */
-    void start(int resolution = kDefaultTimerResolution);
+    void start();
 
     /**
      * Stop the update timer
@@ -59,13 +59,41 @@ public:
 
     /**
      * Retry any scheduled updates that failed for some reason
+     *
+     * Feeds whose server sent a Retry-After time that hasn't passed yet are left alone.
+     * The failure count is kept, so feeds that fail again continue to back off.
      */
     void clearErrors();
 
+    /**
+     * Launch scheduled updates through /pacer/ instead of starting them all at once.
+     */
+    void setUpdatePacer(FeedCore::UpdatePacer *pacer);
+
+    /* bounds for update intervals chosen by AdaptiveUpdateMode, in seconds */
+    static constexpr const qint64 kMinAdaptiveInterval = 15 * 60;
+    static constexpr const qint64 kMaxAdaptiveInterval = 24 * 60 * 60;
+
+    /* the number of recent publication dates used to estimate a feed's publishing rate */
+    static constexpr const int kAdaptiveSampleSize = 20;
+
+    /**
+     * Estimate the update interval for a feed in AdaptiveUpdateMode.
+     *
+     * /publicationDates/ are the dates of the feed's most recent articles. The result is
+     * the average time between articles, counting the quiet period since the newest one,
+     * so that a feed that stops publishing is polled less and less often.  The result is
+     * bounded by kMinAdaptiveInterval and kMaxAdaptiveInterval.
+     */
+    static qint64 adaptiveUpdateInterval(const QList<QDateTime> &publicationDates, const QDateTime &timestamp = QDateTime::currentDateTime());
+
 private:
     struct PrivData;
     std::unique_ptr<PrivData> d;
     void reschedule(Feed *feed, const QDateTime &timestamp = QDateTime::currentDateTime());
+    void insertIntoSchedule(Feed *feed);
+    void removeFromSchedule(Feed *feed);
+    void armTimer();
     void onUpdateModeChanged(Feed *feed);
     void onFeedStatusChanged(Feed *sender);
     void onNetworkStateChanged();
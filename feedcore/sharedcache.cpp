@@ -2,82 +2,237 @@
  * SPDX-FileCopyrightText: 2022 Connor Carney <hello@connorcarney.com>
  * SPDX-License-Identifier: GPL-3.0-or-later
  */
-#include <QMutex>
-#include <QNetworkDiskCache>
+#include "cachestore.h"
+#include <QBuffer>
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
 #include <QStandardPaths>
+#include <memory>
 #include <sharedcache.h>
 using namespace FeedCore;
 
-namespace
+/* entries larger than this fraction of the maximum cache size are not stored */
+static constexpr const int kMaxEntryFraction = 8;
+
+static constexpr const quint32 kEntryMagic = 0x53594e43;
+static constexpr const qint32 kEntryVersion = 2;
+static constexpr const QDataStream::Version kStreamVersion = QDataStream::Qt_6_0;
+
+static CacheStore *sharedStore()
+{
+    static auto *instance = [] {
+        const QString &cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+
+        // remove the files left behind by the QNetworkDiskCache that we used to use
+        QDir(cacheDir + QLatin1String("/data8")).removeRecursively();
+        QDir(cacheDir + QLatin1String("/prepared")).removeRecursively();
+
+        return new CacheStore(cacheDir + QLatin1String("/network/"), SharedCache::kDefaultMaximumCacheSize);
+    }();
+    return instance;
+}
+
+static bool writeFile(const QString &path, const QByteArray &contents)
+{
+    QDir().mkpath(path.left(path.lastIndexOf('/')));
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(contents);
+    return file.commit();
+}
+
+/* the metadata file also records the payload size, so that a payload that doesn't match it is never used */
+static bool writeMetaData(const QString &path, const QNetworkCacheMetaData &metaData, qint64 payloadSize)
+{
+    QByteArray contents;
+    QDataStream out(&contents, QIODevice::WriteOnly);
+    out.setVersion(kStreamVersion);
+    out << kEntryMagic << kEntryVersion << payloadSize << metaData;
+    return writeFile(path, contents);
+}
+
+static bool readMetaData(const QString &path, const QUrl &url, QNetworkCacheMetaData *metaData, qint64 *payloadSize)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream in(&file);
+    in.setVersion(kStreamVersion);
+    quint32 magic{0};
+    qint32 version{0};
+    QNetworkCacheMetaData storedMetaData;
+    in >> magic >> version;
+    if (magic != kEntryMagic || version != kEntryVersion) {
+        return false;
+    }
+    in >> *payloadSize >> storedMetaData;
+
+    // guard against hash collisions and truncated files
+    if (in.status() != QDataStream::Ok || storedMetaData.url() != url) {
+        return false;
+    }
+    *metaData = storedMetaData;
+    return true;
+}
+
+/* the size of the metadata and payload files for /key/ together */
+static qint64 entrySize(CacheStore *store, const QByteArray &key)
 {
-class SharedDiskCache : public QNetworkDiskCache
+    return QFileInfo(store->pathForKey(key)).size() + QFileInfo(store->metaDataPathForKey(key)).size();
+}
+
+/* the caller holds the file lock for /key/ */
+static void discard(CacheStore *store, const QByteArray &key)
 {
-public:
-    QMutex mutex;
-    static SharedDiskCache *instance();
+    store->drop(key);
+    store->removeFiles(key);
+}
 
-private:
-    SharedDiskCache();
-};
+qint64 SharedCache::maximumCacheSize()
+{
+    return sharedStore()->maximumSize();
+}
 
+void SharedCache::setMaximumCacheSize(qint64 size)
+{
+    sharedStore()->setMaximumSize(size);
 }
 
 QNetworkCacheMetaData SharedCache::metaData(const QUrl &url)
 {
-    QMutexLocker lock(&SharedDiskCache::instance()->mutex);
-    return SharedDiskCache::instance()->metaData(url);
+    auto *store = sharedStore();
+    const QByteArray &key = CacheStore::keyForUrl(url);
+    if (!store->contains(key)) {
+        return QNetworkCacheMetaData();
+    }
+    QNetworkCacheMetaData result;
+    qint64 payloadSize{0};
+    QMutexLocker lock(&store->fileLock(key));
+    if (!readMetaData(store->metaDataPathForKey(key), url, &result, &payloadSize)) {
+        discard(store, key);
+        return QNetworkCacheMetaData();
+    }
+    store->touch(key);
+    return result;
 }
 
 void SharedCache::updateMetaData(const QNetworkCacheMetaData &metaData)
 {
-    QMutexLocker lock(&SharedDiskCache::instance()->mutex);
-    SharedDiskCache::instance()->updateMetaData(metaData);
+    auto *store = sharedStore();
+    const QByteArray &key = CacheStore::keyForUrl(metaData.url());
+    if (!store->contains(key)) {
+        return;
+    }
+
+    // only the metadata file is rewritten; the payload stays where it is
+    const QString &path = store->metaDataPathForKey(key);
+    QNetworkCacheMetaData oldMetaData;
+    qint64 payloadSize{0};
+    QMutexLocker lock(&store->fileLock(key));
+    if (readMetaData(path, metaData.url(), &oldMetaData, &payloadSize) && writeMetaData(path, metaData, payloadSize)) {
+        store->add(key, entrySize(store, key));
+    }
 }
 
 QIODevice *SharedCache::data(const QUrl &url)
 {
-    QMutexLocker lock(&SharedDiskCache::instance()->mutex);
-    return SharedDiskCache::instance()->data(url);
+    auto *store = sharedStore();
+    const QByteArray &key = CacheStore::keyForUrl(url);
+    if (!store->contains(key)) {
+        return nullptr;
+    }
+    QNetworkCacheMetaData metaData;
+    qint64 payloadSize{0};
+    auto file = std::make_unique<QFile>(store->pathForKey(key));
+
+    // the metadata and the payload have to come from the same insert
+    QMutexLocker lock(&store->fileLock(key));
+    if (!readMetaData(store->metaDataPathForKey(key), url, &metaData, &payloadSize) || !file->open(QIODevice::ReadOnly) || file->size() != payloadSize) {
+        discard(store, key);
+        return nullptr;
+    }
+    store->touch(key);
+    return file.release();
 }
 
 bool SharedCache::remove(const QUrl &url)
 {
-    QMutexLocker lock(&SharedDiskCache::instance()->mutex);
-    return SharedDiskCache::instance()->remove(url);
+    // abandon any insert that is in progress for this url
+    for (auto it = m_preparedItems.begin(); it != m_preparedItems.end();) {
+        if (it.value().url() == url) {
+            it.key()->deleteLater();
+            it = m_preparedItems.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    auto *store = sharedStore();
+    const QByteArray &key = CacheStore::keyForUrl(url);
+    if (!store->drop(key)) {
+        return false;
+    }
+    QMutexLocker lock(&store->fileLock(key));
+    store->removeFiles(key);
+    return true;
 }
 
 qint64 SharedCache::cacheSize() const
 {
-    QMutexLocker lock(&SharedDiskCache::instance()->mutex);
-    return SharedDiskCache::instance()->cacheSize();
+    return sharedStore()->size();
 }
 
 QIODevice *SharedCache::prepare(const QNetworkCacheMetaData &metaData)
 {
-    QMutexLocker lock(&SharedDiskCache::instance()->mutex);
-    return SharedDiskCache::instance()->prepare(metaData);
+    if (!metaData.isValid() || !metaData.url().isValid() || !metaData.saveToDisk()) {
+        return nullptr;
+    }
+    auto *buffer = new QBuffer(this);
+    buffer->open(QIODevice::ReadWrite);
+    m_preparedItems.insert(buffer, metaData);
+    return buffer;
 }
 
 void SharedCache::insert(QIODevice *device)
 {
-    QMutexLocker lock(&SharedDiskCache::instance()->mutex);
-    SharedDiskCache::instance()->insert(device);
-}
+    const auto it = m_preparedItems.constFind(device);
+    if (it == m_preparedItems.constEnd()) {
+        return;
+    }
+    const QNetworkCacheMetaData metaData = it.value();
+    m_preparedItems.erase(it);
+    const QByteArray payload = static_cast<QBuffer *>(device)->data();
+    device->deleteLater();
 
-void SharedCache::clear()
-{
-    QMutexLocker lock(&SharedDiskCache::instance()->mutex);
-    SharedDiskCache::instance()->clear();
-}
+    if (payload.size() > maximumCacheSize() / kMaxEntryFraction) {
+        remove(metaData.url());
+        return;
+    }
 
-SharedDiskCache *SharedDiskCache::instance()
-{
-    static auto *instance = new SharedDiskCache;
-    return instance;
+    // the metadata is written last, so that a payload without it is never read
+    auto *store = sharedStore();
+    const QByteArray &key = CacheStore::keyForUrl(metaData.url());
+    {
+        QMutexLocker lock(&store->fileLock(key));
+        if (!writeFile(store->pathForKey(key), payload) || !writeMetaData(store->metaDataPathForKey(key), metaData, payload.size())) {
+            discard(store, key);
+            return;
+        }
+        store->add(key, entrySize(store, key));
+    }
+    store->evictIfNeeded();
 }
 
-SharedDiskCache::SharedDiskCache()
+void SharedCache::clear()
 {
-    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
-    setCacheDirectory(cacheDir);
+    for (auto it = m_preparedItems.cbegin(); it != m_preparedItems.cend(); ++it) {
+        it.key()->deleteLater();
+    }
+    m_preparedItems.clear();
+    sharedStore()->dropAll();
 }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <QAbstractNetworkCache>
+#include <QHash>
 
 namespace FeedCore
 {
@@ -12,14 +13,27 @@ namespace FeedCore
 /**
  * A cache implementation that shares cached data across all of its instances
  *
- * The SharedCache class is a thin wrapper which provides thread-safe
- * access to a single global QNetworkDiskCache instance.
+ * All instances are backed by a single on-disk store that is safe to use from
+ * several threads at once.  The store's index is split into shards with their own
+ * locks, and entries are read and written without holding any lock.  Each entry is
+ * a payload file and a small metadata file, each replaced atomically, so that a
+ * revalidation only rewrites the metadata and the payload can be read straight from
+ * disk.  When the cache grows past
+ * maximumCacheSize(), the least recently used entries are evicted.
  */
 class SharedCache : public QAbstractNetworkCache
 {
 public:
     SharedCache() = default;
 
+    static constexpr const qint64 kDefaultMaximumCacheSize = 100 * 1024 * 1024;
+
+    /**
+     * The size (in bytes) that the shared store is allowed to grow to before old entries are evicted.
+     */
+    static qint64 maximumCacheSize();
+    static void setMaximumCacheSize(qint64 size);
+
     QNetworkCacheMetaData metaData(const QUrl &url) override;
     void updateMetaData(const QNetworkCacheMetaData &metaData) override;
     QIODevice *data(const QUrl &url) override;
@@ -28,6 +42,10 @@ public:
     QIODevice *prepare(const QNetworkCacheMetaData &metaData) override;
     void insert(QIODevice *device) override;
     void clear() override;
+
+private:
+    // devices returned from prepare() that haven't been inserted yet
+    QHash<QIODevice *, QNetworkCacheMetaData> m_preparedItems;
 };
 
 }
@@ -27,5 +27,16 @@ public:
     virtual QFuture<ArticleRef> getHighlights(size_t limit) = 0;
     virtual QFuture<Feed *> getFeeds() = 0;
     virtual QFuture<Feed *> storeFeed(Feed *feed) = 0;
+
+    /**
+     * The number of operations that have been submitted to the backend but have not completed.
+     *
+     * This is used to hold back new updates while the backend is saturated. The default
+     * implementation returns 0.
+     */
+    virtual int pendingTasks() const
+    {
+        return 0;
+    }
 };
 }
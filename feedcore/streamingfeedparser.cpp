@@ -0,0 +1,747 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "streamingfeedparser.h"
+#include <QDateTime>
+#include <QDomElement>
+#include <QHash>
+#include <QRegularExpression>
+#include <QSharedPointer>
+#include <QXmlStreamReader>
+#include <Syndication/Image>
+#include <Syndication/Person>
+#include <Syndication/Tools>
+#include <algorithm>
+#include <utility>
+using namespace FeedCore;
+
+/* the head is only needed for the channel-level update hints, which come before the items */
+static constexpr const int kMaxHeadSize = 64 * 1024;
+
+/* a complete document is handed to the reader in pieces of this size */
+static constexpr const int kChunkSize = 64 * 1024;
+
+static const QString kAtomNamespace = QStringLiteral("http://www.w3.org/2005/Atom");
+static const QString kAtom03Namespace = QStringLiteral("http://purl.org/atom/ns#");
+static const QString kRdfNamespace = QStringLiteral("http://www.w3.org/1999/02/22-rdf-syntax-ns#");
+static const QString kRss10Namespace = QStringLiteral("http://purl.org/rss/1.0/");
+static const QString kRss09Namespace = QStringLiteral("http://my.netscape.com/rdf/simple/0.9/");
+static const QString kContentNamespace = QStringLiteral("http://purl.org/rss/1.0/modules/content/");
+static const QString kDublinCoreNamespace = QStringLiteral("http://purl.org/dc/elements/1.1/");
+
+namespace
+{
+class StreamedPerson : public Syndication::Person
+{
+public:
+    QString m_name;
+    QString m_uri;
+    QString m_email;
+
+    bool isNull() const override
+    {
+        return m_name.isEmpty() && m_uri.isEmpty() && m_email.isEmpty();
+    }
+    QString name() const override
+    {
+        return m_name;
+    }
+    QString uri() const override
+    {
+        return m_uri;
+    }
+    QString email() const override
+    {
+        return m_email;
+    }
+};
+
+class StreamedImage : public Syndication::Image
+{
+public:
+    explicit StreamedImage(const QString &url)
+        : m_url(url)
+    {
+    }
+
+    bool isNull() const override
+    {
+        return m_url.isEmpty();
+    }
+    QString url() const override
+    {
+        return m_url;
+    }
+    QString title() const override
+    {
+        return QString();
+    }
+    QString link() const override
+    {
+        return QString();
+    }
+    QString description() const override
+    {
+        return QString();
+    }
+    uint width() const override
+    {
+        return 0;
+    }
+    uint height() const override
+    {
+        return 0;
+    }
+    uint size() const override
+    {
+        return 0;
+    }
+
+private:
+    QString m_url;
+};
+
+class StreamedItem : public Syndication::Item
+{
+public:
+    QString m_id;
+    QString m_title;
+    QString m_link;
+    QString m_description;
+    QString m_content;
+    QString m_language;
+    time_t m_datePublished{0};
+    time_t m_dateUpdated{0};
+    QList<Syndication::PersonPtr> m_authors;
+
+    Syndication::SpecificItemPtr specificItem() const override
+    {
+        return Syndication::SpecificItemPtr(nullptr);
+    }
+    QString title() const override
+    {
+        return m_title;
+    }
+    QString link() const override
+    {
+        return m_link;
+    }
+    QString description() const override
+    {
+        return m_description;
+    }
+    QString content() const override
+    {
+        return m_content;
+    }
+    time_t datePublished() const override
+    {
+        return m_datePublished;
+    }
+    time_t dateUpdated() const override
+    {
+        return m_dateUpdated;
+    }
+    QString id() const override
+    {
+        return m_id;
+    }
+    QList<Syndication::PersonPtr> authors() const override
+    {
+        return m_authors;
+    }
+    QString language() const override
+    {
+        return m_language;
+    }
+    QList<Syndication::EnclosurePtr> enclosures() const override
+    {
+        return QList<Syndication::EnclosurePtr>();
+    }
+    QList<Syndication::CategoryPtr> categories() const override
+    {
+        return QList<Syndication::CategoryPtr>();
+    }
+    int commentsCount() const override
+    {
+        return 0;
+    }
+    QString commentsLink() const override
+    {
+        return QString();
+    }
+    QString commentsFeed() const override
+    {
+        return QString();
+    }
+    QString commentPostUri() const override
+    {
+        return QString();
+    }
+    QMultiMap<QString, QDomElement> additionalProperties() const override
+    {
+        return QMultiMap<QString, QDomElement>();
+    }
+};
+
+class StreamedFeed : public Syndication::Feed
+{
+public:
+    QString m_title;
+    QString m_link;
+    QString m_description;
+    QString m_language;
+    QString m_copyright;
+    QString m_imageUrl;
+    QString m_iconUrl;
+    QList<Syndication::ItemPtr> m_items;
+
+    Syndication::SpecificDocumentPtr specificDocument() const override
+    {
+        return Syndication::SpecificDocumentPtr(nullptr);
+    }
+    QList<Syndication::ItemPtr> items() const override
+    {
+        return m_items;
+    }
+    QList<Syndication::CategoryPtr> categories() const override
+    {
+        return QList<Syndication::CategoryPtr>();
+    }
+    QString title() const override
+    {
+        return m_title;
+    }
+    QString link() const override
+    {
+        return m_link;
+    }
+    QString description() const override
+    {
+        return m_description;
+    }
+    Syndication::ImagePtr image() const override
+    {
+        return m_imageUrl.isEmpty() ? Syndication::ImagePtr() : Syndication::ImagePtr(new StreamedImage(m_imageUrl));
+    }
+    Syndication::ImagePtr icon() const override
+    {
+        return m_iconUrl.isEmpty() ? Syndication::ImagePtr() : Syndication::ImagePtr(new StreamedImage(m_iconUrl));
+    }
+    QList<Syndication::PersonPtr> authors() const override
+    {
+        return QList<Syndication::PersonPtr>();
+    }
+    QString language() const override
+    {
+        return m_language;
+    }
+    QString copyright() const override
+    {
+        return m_copyright;
+    }
+    QMultiMap<QString, QDomElement> additionalProperties() const override
+    {
+        return QMultiMap<QString, QDomElement>();
+    }
+};
+
+enum class Format { Unknown, Rss, Rdf, Atom, NotAFeed };
+enum class TextType { Text, Html, Xhtml };
+}
+
+/* plain text is escaped, so that every field holds HTML like the Syndication library's */
+static QString htmlize(const QString &text)
+{
+    static const QRegularExpression markup(QStringLiteral("<[a-zA-Z/!]|&#?[a-zA-Z0-9]+;"));
+    return text.contains(markup) ? text : text.toHtmlEscaped();
+}
+
+static time_t parseRfc822Date(const QString &value)
+{
+    // Qt only understands numeric zones, but RFC 822 allows a few names
+    static const QHash<QString, QString> zones{{"GMT", "+0000"},
+                                               {"UT", "+0000"},
+                                               {"UTC", "+0000"},
+                                               {"Z", "+0000"},
+                                               {"EST", "-0500"},
+                                               {"EDT", "-0400"},
+                                               {"CST", "-0600"},
+                                               {"CDT", "-0500"},
+                                               {"MST", "-0700"},
+                                               {"MDT", "-0600"},
+                                               {"PST", "-0800"},
+                                               {"PDT", "-0700"}};
+    QString text = value.simplified();
+    const qsizetype space = text.lastIndexOf(QLatin1Char(' '));
+    if (space > 0) {
+        const auto it = zones.constFind(text.mid(space + 1).toUpper());
+        if (it != zones.constEnd()) {
+            text = text.left(space + 1) + *it;
+        }
+    }
+    const QDateTime date = QDateTime::fromString(text, Qt::RFC2822Date);
+    return date.isValid() ? date.toSecsSinceEpoch() : 0;
+}
+
+static time_t parseIsoDate(const QString &value)
+{
+    const QDateTime date = QDateTime::fromString(value.trimmed(), Qt::ISODateWithMs);
+    return date.isValid() ? date.toSecsSinceEpoch() : 0;
+}
+
+static bool isVoidElement(QStringView name)
+{
+    static const QStringList voidElements{"area", "base", "br", "col", "embed", "hr", "img", "input", "link", "meta", "param", "source", "track", "wbr"};
+    return voidElements.contains(name);
+}
+
+static TextType atomTextType(QStringView type)
+{
+    if (type == QLatin1String("xhtml") || type == QLatin1String("application/xhtml+xml")) {
+        return TextType::Xhtml;
+    }
+    if (type == QLatin1String("html") || type == QLatin1String("text/html")) {
+        return TextType::Html;
+    }
+    return TextType::Text;
+}
+
+/* "jdoe@example.com (John Doe)", as in RSS 2.0 <author> */
+static Syndication::PersonPtr personFromString(const QString &value)
+{
+    static const QRegularExpression emailAndName(QStringLiteral("^\\s*(\\S+@\\S+)\\s*\\((.*)\\)\\s*$"));
+    auto person = QSharedPointer<StreamedPerson>::create();
+    const QRegularExpressionMatch match = emailAndName.match(value);
+    if (match.hasMatch()) {
+        person->m_email = match.captured(1);
+        person->m_name = match.captured(2).trimmed();
+    } else if (value.contains(QLatin1Char('@')) && !value.trimmed().contains(QLatin1Char(' '))) {
+        person->m_email = value.trimmed();
+    } else {
+        person->m_name = value.trimmed();
+    }
+    return person;
+}
+
+struct StreamingFeedParser::PrivData {
+    QXmlStreamReader reader;
+    QUrl url;
+    Format format{Format::Unknown};
+    QString atomNamespace;
+    QSharedPointer<StreamedFeed> feed{QSharedPointer<StreamedFeed>::create()};
+    QList<Syndication::ItemPtr> items;
+    QByteArray head;
+    bool headDone{false};
+    QString error;
+
+    // local names of the open elements
+    QStringList path;
+
+    // text of the innermost open element
+    QString text;
+    TextType textType{TextType::Text};
+
+    // the path depth of each open element that gets special handling, or 0
+    int itemDepth{0};
+    int authorDepth{0};
+    int xhtmlDepth{0};
+
+    QSharedPointer<StreamedItem> item;
+    QSharedPointer<StreamedPerson> author;
+    QString guid;
+    bool guidIsPermaLink{true};
+
+    void parse();
+    void startElement();
+    void endElement();
+    void detectFormat(QStringView name, QStringView ns);
+    bool isCore(QStringView ns) const;
+    bool isItem(QStringView name, QStringView ns) const;
+    QString atomText(const QString &value) const;
+    QString resolve(const QString &href) const;
+    void startItem();
+    void finishItem();
+    void setItemField(QStringView name, QStringView ns, const QString &value);
+    void setFeedField(QStringView name, QStringView ns, const QString &value);
+};
+
+StreamingFeedParser::StreamingFeedParser(const QUrl &url)
+    : d{std::make_unique<PrivData>()}
+{
+    d->url = url;
+}
+
+StreamingFeedParser::~StreamingFeedParser() = default;
+
+void StreamingFeedParser::addData(const QByteArray &data)
+{
+    if (!d->headDone) {
+        d->head += data.left(kMaxHeadSize - d->head.size());
+        d->headDone = d->head.size() >= kMaxHeadSize;
+    }
+    if (!d->error.isEmpty()) {
+        return;
+    }
+    d->reader.addData(data);
+    d->parse();
+}
+
+void StreamingFeedParser::finish()
+{
+    d->headDone = true;
+    if (!d->error.isEmpty()) {
+        return;
+    }
+    d->parse();
+    if (!isFeed()) {
+        d->error = QStringLiteral("not an RSS or Atom feed");
+    } else if (d->reader.error() == QXmlStreamReader::PrematureEndOfDocumentError) {
+        d->error = QStringLiteral("the feed is incomplete");
+    }
+}
+
+QList<Syndication::ItemPtr> StreamingFeedParser::takeItems()
+{
+    return std::exchange(d->items, {});
+}
+
+bool StreamingFeedParser::isFeed() const
+{
+    return d->format == Format::Rss || d->format == Format::Rdf || d->format == Format::Atom;
+}
+
+bool StreamingFeedParser::hasError() const
+{
+    return !d->error.isEmpty();
+}
+
+const QString &StreamingFeedParser::errorString() const
+{
+    return d->error;
+}
+
+Syndication::FeedPtr StreamingFeedParser::feed() const
+{
+    return d->feed;
+}
+
+const QByteArray &StreamingFeedParser::head() const
+{
+    return d->head;
+}
+
+Syndication::FeedPtr StreamingFeedParser::parse(const QByteArray &data, const QUrl &url)
+{
+    StreamingFeedParser parser(url);
+    for (qsizetype offset = 0; offset < data.size() && !parser.hasError(); offset += kChunkSize) {
+        parser.addData(QByteArray::fromRawData(data.constData() + offset, std::min<qsizetype>(kChunkSize, data.size() - offset)));
+    }
+    parser.finish();
+    if (parser.hasError()) {
+        return Syndication::FeedPtr();
+    }
+    parser.d->feed->m_items = parser.takeItems();
+    return parser.feed();
+}
+
+void StreamingFeedParser::PrivData::parse()
+{
+    while (!reader.atEnd() && format != Format::NotAFeed) {
+        switch (reader.readNext()) {
+        case QXmlStreamReader::StartElement:
+            startElement();
+            break;
+        case QXmlStreamReader::EndElement:
+            endElement();
+            break;
+        case QXmlStreamReader::Characters:
+            if (xhtmlDepth > 0) {
+                text += reader.text().toString().toHtmlEscaped();
+            } else {
+                text += reader.text();
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    if (format == Format::NotAFeed) {
+        error = QStringLiteral("not an RSS or Atom feed");
+    } else if (reader.hasError() && reader.error() != QXmlStreamReader::PrematureEndOfDocumentError) {
+        error = reader.errorString();
+    }
+}
+
+void StreamingFeedParser::PrivData::detectFormat(QStringView name, QStringView ns)
+{
+    if (name == QLatin1String("rss") && ns.isEmpty()) {
+        format = Format::Rss;
+    } else if (name == QLatin1String("RDF") && ns == kRdfNamespace) {
+        format = Format::Rdf;
+    } else if (name == QLatin1String("feed") && (ns == kAtomNamespace || ns == kAtom03Namespace)) {
+        format = Format::Atom;
+        atomNamespace = ns.toString();
+    } else {
+        format = Format::NotAFeed;
+    }
+}
+
+/* whether an element belongs to the feed format itself rather than an extension */
+bool StreamingFeedParser::PrivData::isCore(QStringView ns) const
+{
+    switch (format) {
+    case Format::Rss:
+        return ns.isEmpty();
+    case Format::Rdf:
+        return ns == kRss10Namespace || ns == kRss09Namespace;
+    case Format::Atom:
+        return ns == atomNamespace;
+    default:
+        return false;
+    }
+}
+
+bool StreamingFeedParser::PrivData::isItem(QStringView name, QStringView ns) const
+{
+    return isCore(ns) && name == (format == Format::Atom ? QLatin1String("entry") : QLatin1String("item"));
+}
+
+QString StreamingFeedParser::PrivData::atomText(const QString &value) const
+{
+    return textType == TextType::Text ? value.toHtmlEscaped() : value;
+}
+
+QString StreamingFeedParser::PrivData::resolve(const QString &href) const
+{
+    return url.isValid() ? url.resolved(QUrl(href.trimmed())).toString() : href.trimmed();
+}
+
+void StreamingFeedParser::PrivData::startElement()
+{
+    const QStringView name = reader.name();
+    const QStringView ns = reader.namespaceUri();
+    const QXmlStreamAttributes &attributes = reader.attributes();
+    path << name.toString();
+    const int depth = static_cast<int>(path.size());
+
+    // XHTML content is kept as markup
+    if (xhtmlDepth > 0) {
+        text += QLatin1Char('<');
+        text += name;
+        for (const QXmlStreamAttribute &attribute : attributes) {
+            text += QLatin1Char(' ');
+            text += attribute.name();
+            text += QLatin1String("=\"");
+            text += attribute.value().toString().toHtmlEscaped();
+            text += QLatin1Char('"');
+        }
+        text += isVoidElement(name) ? QLatin1String("/>") : QLatin1String(">");
+        return;
+    }
+
+    text.clear();
+    if (format == Format::Unknown) {
+        detectFormat(name, ns);
+        return;
+    }
+
+    if (item.isNull() && isItem(name, ns)) {
+        headDone = true;
+        itemDepth = depth;
+        item = QSharedPointer<StreamedItem>::create();
+        if (format == Format::Rdf) {
+            item->m_id = attributes.value(kRdfNamespace, QLatin1String("about")).toString().trimmed();
+        }
+        return;
+    }
+
+    const bool isItemField = !item.isNull() && depth == itemDepth + 1;
+    const bool isFeedField = item.isNull() && depth == 2;
+    if (format != Format::Atom || !isCore(ns) || !(isItemField || isFeedField)) {
+        if (isItemField && name == QLatin1String("guid") && isCore(ns)) {
+            guidIsPermaLink = attributes.value(QLatin1String("isPermaLink")) != QLatin1String("false");
+        }
+        return;
+    }
+
+    // Atom keeps links in attributes, and says how each text construct is encoded
+    if (name == QLatin1String("link")) {
+        const QStringView rel = attributes.value(QLatin1String("rel"));
+        const QString &link = isItemField ? item->m_link : feed->m_link;
+        if ((rel.isEmpty() || rel == QLatin1String("alternate")) && link.isEmpty()) {
+            (isItemField ? item->m_link : feed->m_link) = resolve(attributes.value(QLatin1String("href")).toString());
+        }
+    } else if (name == QLatin1String("author") && isItemField) {
+        author = QSharedPointer<StreamedPerson>::create();
+        authorDepth = depth;
+    } else {
+        textType = atomTextType(attributes.value(QLatin1String("type")));
+        if (textType == TextType::Xhtml) {
+            xhtmlDepth = depth;
+        }
+    }
+}
+
+void StreamingFeedParser::PrivData::endElement()
+{
+    const QStringView name = reader.name();
+    const QStringView ns = reader.namespaceUri();
+    const int depth = static_cast<int>(path.size());
+
+    if (xhtmlDepth > 0 && depth > xhtmlDepth) {
+        if (!isVoidElement(name)) {
+            text += QLatin1String("</");
+            text += name;
+            text += QLatin1Char('>');
+        }
+        path.removeLast();
+        return;
+    }
+    xhtmlDepth = 0;
+
+    if (!item.isNull()) {
+        if (depth == itemDepth) {
+            finishItem();
+        } else if (!author.isNull() && depth == authorDepth) {
+            if (!author->isNull()) {
+                item->m_authors << author;
+            }
+            author.reset();
+            authorDepth = 0;
+        } else if (!author.isNull() && depth == authorDepth + 1 && isCore(ns)) {
+            if (name == QLatin1String("name")) {
+                author->m_name = text.trimmed();
+            } else if (name == QLatin1String("email")) {
+                author->m_email = text.trimmed();
+            } else if (name == QLatin1String("uri")) {
+                author->m_uri = text.trimmed();
+            }
+        } else if (depth == itemDepth + 1) {
+            setItemField(name, ns, text);
+        }
+    } else if (name == QLatin1String("url") && depth >= 2 && path.at(depth - 2) == QLatin1String("image") && isCore(ns)) {
+        feed->m_imageUrl = text.trimmed();
+    } else if (format == Format::Atom ? depth == 2 : depth == 3 && path.at(1) == QLatin1String("channel")) {
+        setFeedField(name, ns, text);
+    }
+
+    text.clear();
+    textType = TextType::Text;
+    path.removeLast();
+}
+
+void StreamingFeedParser::PrivData::finishItem()
+{
+    if (!guid.isEmpty()) {
+        item->m_id = guid;
+        if (item->m_link.isEmpty() && guidIsPermaLink) {
+            item->m_link = guid;
+        }
+    }
+    if (item->m_dateUpdated == 0) {
+        item->m_dateUpdated = item->m_datePublished;
+    }
+    if (item->m_datePublished == 0) {
+        item->m_datePublished = item->m_dateUpdated;
+    }
+    if (item->m_language.isEmpty()) {
+        item->m_language = feed->m_language;
+    }
+    if (item->m_id.isEmpty()) {
+        // the same fallback as the Syndication mappers, so the id doesn't change when the feed switches parsers
+        item->m_id = QStringLiteral("hash:%1").arg(Syndication::calcMD5Sum(item->m_title + item->m_description + item->m_link + item->m_content));
+    }
+
+    items << item;
+    item.reset();
+    author.reset();
+    itemDepth = authorDepth = 0;
+    guid.clear();
+    guidIsPermaLink = true;
+}
+
+void StreamingFeedParser::PrivData::setItemField(QStringView name, QStringView ns, const QString &value)
+{
+    if (ns == kContentNamespace) {
+        if (name == QLatin1String("encoded")) {
+            item->m_content = value;
+        }
+        return;
+    }
+    if (ns == kDublinCoreNamespace) {
+        if (name == QLatin1String("date") && item->m_datePublished == 0) {
+            item->m_datePublished = parseIsoDate(value);
+        } else if (name == QLatin1String("creator") && item->m_authors.isEmpty()) {
+            auto creator = QSharedPointer<StreamedPerson>::create();
+            creator->m_name = value.trimmed();
+            item->m_authors << creator;
+        } else if (name == QLatin1String("language")) {
+            item->m_language = value.trimmed();
+        }
+        return;
+    }
+    if (!isCore(ns)) {
+        return;
+    }
+
+    if (format == Format::Atom) {
+        if (name == QLatin1String("title")) {
+            item->m_title = atomText(value.trimmed());
+        } else if (name == QLatin1String("id")) {
+            item->m_id = value.trimmed();
+        } else if (name == QLatin1String("updated") || name == QLatin1String("modified")) {
+            item->m_dateUpdated = parseIsoDate(value);
+        } else if (name == QLatin1String("published") || name == QLatin1String("issued")) {
+            item->m_datePublished = parseIsoDate(value);
+        } else if (name == QLatin1String("summary")) {
+            item->m_description = atomText(value);
+        } else if (name == QLatin1String("content")) {
+            item->m_content = atomText(value);
+        }
+        return;
+    }
+
+    if (name == QLatin1String("title")) {
+        item->m_title = htmlize(value.trimmed());
+    } else if (name == QLatin1String("link")) {
+        item->m_link = value.trimmed();
+    } else if (name == QLatin1String("description")) {
+        item->m_description = htmlize(value);
+    } else if (name == QLatin1String("guid")) {
+        guid = value.trimmed();
+    } else if (name == QLatin1String("pubDate")) {
+        item->m_datePublished = parseRfc822Date(value);
+    } else if (name == QLatin1String("author")) {
+        item->m_authors.prepend(personFromString(value));
+    }
+}
+
+void StreamingFeedParser::PrivData::setFeedField(QStringView name, QStringView ns, const QString &value)
+{
+    if (ns == kDublinCoreNamespace && name == QLatin1String("language")) {
+        feed->m_language = value.trimmed();
+        return;
+    }
+    if (!isCore(ns)) {
+        return;
+    }
+
+    if (name == QLatin1String("title")) {
+        feed->m_title = value.trimmed();
+    } else if (name == QLatin1String("link") && format != Format::Atom) {
+        feed->m_link = value.trimmed();
+    } else if (name == QLatin1String("description") || name == QLatin1String("subtitle") || name == QLatin1String("tagline")) {
+        feed->m_description = format == Format::Atom ? atomText(value) : htmlize(value);
+    } else if (name == QLatin1String("language")) {
+        feed->m_language = value.trimmed();
+    } else if (name == QLatin1String("copyright") || name == QLatin1String("rights")) {
+        feed->m_copyright = value.trimmed();
+    } else if (name == QLatin1String("icon")) {
+        feed->m_iconUrl = resolve(value);
+    } else if (name == QLatin1String("logo")) {
+        feed->m_imageUrl = resolve(value);
+    }
+}
@@ -0,0 +1,84 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+#include <QByteArray>
+#include <QList>
+#include <QUrl>
+#include <Syndication/Feed>
+#include <Syndication/Item>
+#include <memory>
+
+namespace FeedCore
+{
+/**
+ * An RSS/Atom parser that reads a document a piece at a time
+ *
+ * Syndication::ParserCollection builds a DOM of the whole document before it returns
+ * any items, which takes several times the size of the document.  This parser produces
+ * each item as soon as its closing tag has been read and keeps nothing else, so its
+ * memory use is bounded by the largest item.
+ *
+ * It understands RSS 0.9x and 2.0, RSS 1.0 (RDF) and Atom, and fills in the fields that
+ * syndic uses (id, title, link, author, dates, description and content) the same way
+ * as the Syndication library, so that articles keep their ids when a feed switches
+ * parsers.  Items without a guid, rdf:about or atom:id get a hash of their text,
+ * computed the same way as in the Syndication library.
+ */
+class StreamingFeedParser
+{
+public:
+    explicit StreamingFeedParser(const QUrl &url = QUrl());
+    ~StreamingFeedParser();
+
+    /**
+     * Parse the next piece of the document.
+     */
+    void addData(const QByteArray &data);
+
+    /**
+     * Call after the last piece of the document has been added.
+     */
+    void finish();
+
+    /**
+     * The items that have been read since the last call.
+     */
+    QList<Syndication::ItemPtr> takeItems();
+
+    /**
+     * Whether the document is an RSS or Atom feed.  This is known once the root element has been read.
+     */
+    bool isFeed() const;
+
+    /**
+     * Whether the document isn't a feed, isn't well-formed, or (after finish()) is incomplete.
+     */
+    bool hasError() const;
+    const QString &errorString() const;
+
+    /**
+     * The properties of the feed itself, without any items.
+     *
+     * Properties that come after the first item are only included once they have been read.
+     */
+    Syndication::FeedPtr feed() const;
+
+    /**
+     * The start of the document, up to the first item, for UpdateHints::fromResponse.
+     */
+    const QByteArray &head() const;
+
+    /**
+     * Parse a complete document, returning a feed with all of its items, or a null
+     * pointer if the document isn't a feed.
+     */
+    static Syndication::FeedPtr parse(const QByteArray &data, const QUrl &url = QUrl());
+
+private:
+    struct PrivData;
+    std::unique_ptr<PrivData> d;
+};
+}
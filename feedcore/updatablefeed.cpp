@@ -8,8 +8,13 @@
 #include "articlelinkextractor.h"
 #include "context.h"
 #include "feeddiscovery.h"
+#include "htmldecoder.h"
 #include "networkaccessmanager.h"
+#include "streamingfeedparser.h"
+#include "updatehints.h"
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QNetworkReply>
 #include <QPointer>
 #include <QQueue>
@@ -18,6 +23,19 @@
 using namespace FeedCore;
 
 constexpr const int kMaxRedirects = 10;
+constexpr const int kMaxCachedRedirects = 1000;
+
+// the socket stops reading once this much of a streamed response is waiting to be parsed
+constexpr const qint64 kStreamBufferSize = 1024 * 1024;
+
+// streamed articles are handed to storage this many at a time
+constexpr const int kStreamBatchSize = 100;
+
+// reading a streamed response pauses while this many batches are waiting to be stored
+constexpr const int kMaxPendingBatches = 4;
+
+static int redirectThreshold = UpdatableFeed::kDefaultPermanentRedirectThreshold;
+static qint64 feedStreamingThreshold = UpdatableFeed::kDefaultStreamingThreshold;
 
 namespace
 {
@@ -34,44 +52,119 @@ class LoadOperation : public QObject
 {
     Q_OBJECT
 public:
+    explicit LoadOperation(UpdateStats *stats);
     void start(const QUrl &url, const QString &failMessage = QString());
     void abort();
 
+    /* when the last successful response expires according to its caching headers */
+    const QDateTime &cacheExpiry() const;
+
+    /* ask for an RFC 3229 delta feed ("A-IM: feed") instead of the whole feed */
+    void setAcceptDelta(bool acceptDelta);
+
+    /* fetch from the network without revalidating a cached copy */
+    void setBypassCache(bool bypassCache);
+
+    /* whether the last successful response was a delta feed (226 IM Used) */
+    bool isDelta() const;
+
+    /* where the first request was permanently redirected to, following every permanent redirect before the first temporary one */
+    const QUrl &permanentRedirect() const;
+
+    /* the Content-Type header of the last successful response */
+    const QByteArray &contentType() const;
+
+    /* emit the body in pieces with received() as it downloads, and succeed with an empty body */
+    void setStreaming(bool streaming);
+
+    /* stop emitting received() until resumed */
+    void setPaused(bool paused);
+
 signals:
+    void received(const QByteArray &data);
     void succeeded(const QByteArray &feed, const QUrl &changeUrl);
-    void failed(const QString &errorString);
+    void failed(const QString &errorString, const QDateTime &retryAfter);
     void aborted();
 
 private:
     QSet<QUrl> m_seenUrls;
     QPointer<QNetworkReply> m_reply;
+    QDateTime m_cacheExpiry;
+    QUrl m_permanentRedirect;
+    QByteArray m_contentType;
+    bool m_onlyPermanentRedirects{true};
+    bool m_acceptDelta{false};
+    bool m_bypassCache{false};
+    bool m_isDelta{false};
+    bool m_streaming{false};
+    bool m_paused{false};
+    bool m_finishPending{false};
+    UpdateStats *m_stats{nullptr};
+
+    // msecs since the request was issued when each phase was reached, or -1
+    QElapsedTimer m_requestTimer;
+    qint64 m_connectingAt{-1};
+    qint64 m_encryptedAt{-1};
+    qint64 m_requestSentAt{-1};
+    qint64 m_headersAt{-1};
+
     void onReplyFinished();
+    void onReadyRead();
+    void followRedirect(const QUrl &from, const QUrl &to);
+    void watchPhases();
+    void recordPhases();
 };
 
 class Update : public QObject
 {
     Q_OBJECT
 public:
-    explicit Update(const UpdatableFeed *feed);
+    Update(const UpdatableFeed *feed, UpdateStats *stats);
+    void setAcceptDelta(bool acceptDelta);
+    void setStreaming(bool streaming);
+    void setPaused(bool paused);
     void abort();
     void start();
+    const UpdateHints &updateHints() const;
+    const QUrl &permanentRedirect() const;
+
+    /* the size of the feed document, once it has been loaded */
+    qint64 feedSize() const;
 
 signals:
+    /* articles from a streamed feed, which are not included in the feed passed to succeeded() */
+    void itemsReceived(const QList<Syndication::ItemPtr> &items);
     void succeeded(const Syndication::FeedPtr &feed);
-    void failed(const QString &errorString);
+    void failed(const QString &errorString, const QDateTime &retryAfter);
     void aborted();
 
 private:
     UpdatableFeed *m_feed{nullptr};
+    UpdateStats *m_stats{nullptr};
     std::unique_ptr<LoadOperation, DeleteLater> m_currentOperation;
     QByteArray m_firstData;
+    QByteArray m_firstContentType;
+    UpdateHints m_updateHints;
+    QUrl m_permanentRedirect;
+    bool m_acceptDelta{false};
+    bool m_bypassCache{false};
+    bool m_streaming{false};
+    std::unique_ptr<StreamingFeedParser> m_streamParser;
+    QList<Syndication::ItemPtr> m_streamBatch;
+    qint64 m_feedSize{0};
 
     void onPrimaryFeedFetchSucceeded(const QByteArray &data, const QUrl &url);
+    void onPrimaryFeedDataReceived(const QByteArray &data);
+    void onStreamedFeedFetchSucceeded(const QByteArray &data, const QUrl &url);
+    void emitStreamedItems(bool flush);
     void onWebPageFetchSucceeded(const QByteArray &data, const QUrl &url);
     void onDiscoveredFeedFetchSucceeded(const QByteArray &data, const QUrl &url);
     void onDiscoveredFeedFetchFailed(const QString &errorString);
     void fallbackToWebPage();
-    void onFailed(const QString &errorString);
+    void captureUpdateHints(const QByteArray &data);
+    Syndication::FeedPtr parseFeed(const QByteArray &data, const QUrl &url);
+    Syndication::FeedPtr extractLinks(const QByteArray &data, const QByteArray &contentType, const QUrl &url);
+    void onFailed(const QString &errorString, const QDateTime &retryAfter);
     void onAborted();
 };
 
@@ -89,8 +182,20 @@ private:
     UpdatableFeed *m_updatableFeed{nullptr};
     std::unique_ptr<Update> m_currentUpdate;
 
+    // the size of the largest feed document seen so far, which decides whether to stream the next one
+    qint64 m_largestResponse{0};
+
+    // articles from a streamed update that are being stored
+    QList<QFuture<void>> m_storeResults;
+    int m_pendingBatches{0};
+
+    // counts the calls to run(), so that batches from an earlier update don't count against this one
+    quint64 m_generation{0};
+    QElapsedTimer m_storeTimer;
+
+    void onItemsReceived(const QList<Syndication::ItemPtr> &items);
     void onSucceeded(const Syndication::FeedPtr &feed);
-    void onFailed(const QString &errorString);
+    void onFailed(const QString &errorString, const QDateTime &retryAfter);
 };
 
 Feed::Updater *UpdatableFeed::updater()
@@ -104,6 +209,52 @@ FeedCore::UpdatableFeed::UpdatableFeed(QObject *parent)
 {
 }
 
+bool UpdatableFeed::acceptsPartialUpdates() const
+{
+    return true;
+}
+
+int UpdatableFeed::permanentRedirectThreshold()
+{
+    return redirectThreshold;
+}
+
+void UpdatableFeed::setPermanentRedirectThreshold(int threshold)
+{
+    redirectThreshold = threshold;
+}
+
+qint64 UpdatableFeed::streamingThreshold()
+{
+    return feedStreamingThreshold;
+}
+
+void UpdatableFeed::setStreamingThreshold(qint64 threshold)
+{
+    feedStreamingThreshold = threshold;
+}
+
+void UpdatableFeed::observePermanentRedirect(const QUrl &target)
+{
+    if (redirectThreshold <= 0) {
+        return;
+    }
+    if (!target.isValid() || target == url()) {
+        setRedirect(QUrl(), 0);
+        return;
+    }
+
+    // a feed that bounces between urls shouldn't be moved, so only count consecutive updates
+    const int count = target == redirectUrl() ? redirectCount() + 1 : 1;
+    if (count < redirectThreshold) {
+        setRedirect(target, count);
+        return;
+    }
+    qDebug() << url() << "has moved permanently to" << target;
+    setRedirect(QUrl(), 0);
+    setUrl(target);
+}
+
 static inline bool hasImageUrl(const Syndication::ImagePtr &image)
 {
     return !(image.isNull() || image->url().isEmpty());
@@ -124,6 +275,15 @@ static inline QUrl getIconUrl(const Syndication::FeedPtr &feed, const QUrl &feed
     return QUrl();
 }
 
+/* articles that were last updated before this time have expired, or 0 if articles don't expire */
+static time_t expiryCutoff(UpdatableFeed *feed)
+{
+    if ((feed->expireAge() > 0) && (feed->expireMode() != Feed::DisableUpdateMode)) {
+        return feed->updater()->updateStartTime().toSecsSinceEpoch() - feed->expireAge();
+    }
+    return 0;
+}
+
 QFuture<void> UpdatableFeed::updateFromSource(const Syndication::FeedPtr &feed)
 {
     if (name().isEmpty()) {
@@ -131,11 +291,17 @@ QFuture<void> UpdatableFeed::updateFromSource(const Syndication::FeedPtr &feed)
     }
     setLink(feed->link());
     setIcon(getIconUrl(feed, url()));
-    const auto &items = feed->items();
-    time_t expireTime = 0;
-    if ((expireAge() > 0) && (expireMode() != DisableUpdateMode)) {
-        expireTime = updater()->updateStartTime().toSecsSinceEpoch() - expireAge();
+    auto whenAdded = addSourceArticles(feed->items());
+    const time_t expireTime = expiryCutoff(this);
+    if (expireTime > 0) {
+        expire(QDateTime::fromSecsSinceEpoch(expireTime));
     }
+    return whenAdded;
+}
+
+QFuture<void> UpdatableFeed::addSourceArticles(const QList<Syndication::ItemPtr> &items)
+{
+    const time_t expireTime = expiryCutoff(this);
     QList<QFuture<void>> addResults;
     for (const auto &item : items) {
         const auto &dateUpdated = item->dateUpdated();
@@ -143,10 +309,6 @@ QFuture<void> UpdatableFeed::updateFromSource(const Syndication::FeedPtr &feed)
             addResults << updateSourceArticle(item);
         }
     }
-    if (expireTime > 0) {
-        expire(QDateTime::fromSecsSinceEpoch(expireTime));
-    }
-
     return QtFuture::whenAll(addResults.begin(), addResults.end()).then([](auto) {});
 }
 
@@ -162,7 +324,14 @@ void UpdatableFeed::UpdaterImpl::run()
         setError(tr("Invalid URL", "error message"));
         return;
     }
-    m_currentUpdate.reset(new Update(m_updatableFeed));
+    m_currentUpdate.reset(new Update(m_updatableFeed, &mutableStats()));
+    m_currentUpdate->setAcceptDelta(m_updatableFeed->acceptsPartialUpdates());
+    m_currentUpdate->setStreaming(m_updatableFeed->acceptsPartialUpdates() && m_largestResponse >= feedStreamingThreshold);
+    m_storeResults.clear();
+    m_pendingBatches = 0;
+    ++m_generation;
+    m_storeTimer.start();
+    QObject::connect(m_currentUpdate.get(), &Update::itemsReceived, this, &UpdaterImpl::onItemsReceived);
     QObject::connect(m_currentUpdate.get(), &Update::succeeded, this, &UpdaterImpl::onSucceeded);
     QObject::connect(m_currentUpdate.get(), &Update::failed, this, &UpdaterImpl::onFailed);
     QObject::connect(m_currentUpdate.get(), &Update::aborted, this, &UpdaterImpl::aborted);
@@ -171,6 +340,9 @@ void UpdatableFeed::UpdaterImpl::run()
 
 void UpdatableFeed::UpdaterImpl::abort()
 {
+    if (cancelPending()) {
+        return;
+    }
     if (m_currentUpdate) {
         m_currentUpdate->abort();
     }
@@ -183,45 +355,385 @@ void UpdatableFeed::UpdaterImpl::cleanup()
     }
 }
 
+void UpdatableFeed::UpdaterImpl::onItemsReceived(const QList<Syndication::ItemPtr> &items)
+{
+    mutableStats().itemCount += static_cast<int>(items.size());
+    auto whenAdded = m_updatableFeed->addSourceArticles(items);
+    m_storeResults << whenAdded;
+
+    // don't parse faster than storage can keep up, or the parsed articles pile up in memory
+    if (++m_pendingBatches >= kMaxPendingBatches) {
+        m_currentUpdate->setPaused(true);
+    }
+    Future::safeThen(whenAdded, this, [this, generation = m_generation](auto) {
+        if (generation != m_generation) {
+            return;
+        }
+        if (--m_pendingBatches < kMaxPendingBatches && m_currentUpdate) {
+            m_currentUpdate->setPaused(false);
+        }
+    });
+}
+
 void UpdatableFeed::UpdaterImpl::onSucceeded(const Syndication::FeedPtr &feed)
 {
-    auto whenDone = m_updatableFeed->updateFromSource(feed);
+    m_updatableFeed->setUpdateHints(m_currentUpdate->updateHints());
+    m_updatableFeed->observePermanentRedirect(m_currentUpdate->permanentRedirect());
+    m_largestResponse = std::max(m_largestResponse, m_currentUpdate->feedSize());
+    mutableStats().itemCount += static_cast<int>(feed->items().size());
+    if (m_storeResults.isEmpty()) {
+        m_storeTimer.start();
+    }
+    m_storeResults << m_updatableFeed->updateFromSource(feed);
+    auto whenDone = QtFuture::whenAll(m_storeResults.begin(), m_storeResults.end());
+    m_storeResults.clear();
     Future::safeThen(whenDone, this, [this](auto) {
+        mutableStats().storeMsecs = m_storeTimer.elapsed();
         finish();
     });
 }
 
-void UpdatableFeed::UpdaterImpl::onFailed(const QString &errorString)
+void UpdatableFeed::UpdaterImpl::onFailed(const QString &errorString, const QDateTime &retryAfter)
 {
     qDebug() << "Updater Error:" << errorString;
-    setError(errorString);
+    setError(errorString, retryAfter);
+}
+
+namespace
+{
+struct CachedRedirect {
+    QUrl target;
+    QDateTime expiry;
+};
+}
+
+// temporary redirects that are still fresh, by source url
+static QHash<QUrl, CachedRedirect> cachedRedirects;
+
+static QUrl cachedRedirect(const QUrl &url)
+{
+    const auto it = cachedRedirects.constFind(url);
+    if (it == cachedRedirects.constEnd()) {
+        return QUrl();
+    }
+    if (it->expiry <= QDateTime::currentDateTime()) {
+        cachedRedirects.erase(it);
+        return QUrl();
+    }
+    return it->target;
+}
+
+static void cacheRedirect(const QUrl &from, const QUrl &to, const QDateTime &expiry)
+{
+    const QDateTime &now = QDateTime::currentDateTime();
+    if (!expiry.isValid() || expiry <= now) {
+        return;
+    }
+    if (cachedRedirects.size() >= kMaxCachedRedirects) {
+        cachedRedirects.removeIf([&now](const auto &entry) {
+            return entry.value().expiry <= now;
+        });
+        if (cachedRedirects.size() >= kMaxCachedRedirects) {
+            return;
+        }
+    }
+    cachedRedirects.insert(from, {to, expiry});
 }
 
 void LoadOperation::start(const QUrl &url, const QString &failMessage)
 {
     if (m_seenUrls.contains(url) || m_seenUrls.count() > kMaxRedirects) {
         const QString &errorMessage = failMessage.isEmpty() ? "unknown error" : failMessage;
-        emit failed(errorMessage);
+        emit failed(errorMessage, QDateTime());
+        return;
     }
     m_seenUrls << url;
+    const QUrl &cachedTarget = cachedRedirect(url);
+    if (cachedTarget.isValid()) {
+        m_onlyPermanentRedirects = false;
+        start(cachedTarget, "too many redirects");
+        return;
+    }
+
+    // redirects are followed by hand so that permanent ones can be told apart from temporary ones
     QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::ManualRedirectPolicy);
+    if (m_acceptDelta) {
+        // servers that support it only send a delta when the request is conditional, which
+        // the cache takes care of
+        request.setRawHeader("A-IM", "feed");
+    }
+    if (m_bypassCache) {
+        request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+    }
+    if (m_streaming) {
+        request.setAttribute(NetworkAccessManager::StreamingAttribute, true);
+    }
+    m_requestTimer.start();
+    m_connectingAt = m_encryptedAt = m_requestSentAt = m_headersAt = -1;
     m_reply = NetworkAccessManager::instance()->get(request);
-    QObject::connect(m_reply, &QNetworkReply::finished, this, &LoadOperation::onReplyFinished);
+    NetworkAccessManager::whenStarted(m_reply, this, [this](QNetworkReply *reply) {
+        m_reply = reply;
+        watchPhases();
+        if (m_streaming) {
+            m_reply->setReadBufferSize(kStreamBufferSize);
+            QObject::connect(m_reply, &QNetworkReply::readyRead, this, &LoadOperation::onReadyRead);
+        }
+        QObject::connect(m_reply, &QNetworkReply::finished, this, &LoadOperation::onReplyFinished);
+    });
+}
+
+LoadOperation::LoadOperation(UpdateStats *stats)
+    : m_stats{stats}
+{
+}
+
+static void mark(qint64 &phase, const QElapsedTimer &timer)
+{
+    if (phase < 0) {
+        phase = timer.elapsed();
+    }
+}
+
+void LoadOperation::watchPhases()
+{
+    QObject::connect(m_reply, &QNetworkReply::socketStartedConnecting, this, [this] {
+        mark(m_connectingAt, m_requestTimer);
+    });
+    QObject::connect(m_reply, &QNetworkReply::encrypted, this, [this] {
+        mark(m_encryptedAt, m_requestTimer);
+    });
+    QObject::connect(m_reply, &QNetworkReply::requestSent, this, [this] {
+        mark(m_requestSentAt, m_requestTimer);
+    });
+    QObject::connect(m_reply, &QNetworkReply::metaDataChanged, this, [this] {
+        mark(m_headersAt, m_requestTimer);
+    });
+}
+
+static qint64 phaseLength(qint64 from, qint64 to)
+{
+    return (from >= 0 && to >= from) ? to - from : 0;
+}
+
+void LoadOperation::recordPhases()
+{
+    if (m_stats == nullptr) {
+        return;
+    }
+    const qint64 finishedAt = m_requestTimer.elapsed();
+    const qint64 connectedAt = m_encryptedAt >= 0 ? m_encryptedAt : m_requestSentAt;
+    const qint64 waitEnd = m_connectingAt >= 0 ? m_connectingAt : m_requestSentAt;
+    m_stats->requests++;
+    m_stats->queueMsecs += phaseLength(0, waitEnd);
+    m_stats->connectMsecs += phaseLength(m_connectingAt, connectedAt);
+    m_stats->responseMsecs += phaseLength(m_requestSentAt, m_headersAt);
+    m_stats->downloadMsecs += phaseLength(m_headersAt, finishedAt);
+    if (m_encryptedAt >= 0) {
+        m_stats->encryptedRequests++;
+    }
+    if (m_reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool()) {
+        m_stats->cachedResponses++;
+    }
 }
 
 void LoadOperation::abort()
 {
+    if (m_finishPending) {
+        // the reply has already finished, so aborting it wouldn't be reported
+        m_finishPending = false;
+        m_reply->deleteLater();
+        emit aborted();
+        return;
+    }
     m_reply->abort();
 }
 
+static bool isThrottled(int httpStatus)
+{
+    return httpStatus == 429 /* Too Many Requests */ || httpStatus == 503 /* Service Unavailable */;
+}
+
+static QDateTime parseRetryAfter(const QByteArray &value)
+{
+    // Retry-After is either a number of seconds or an HTTP date
+    bool isSeconds = false;
+    const qint64 seconds = value.trimmed().toLongLong(&isSeconds);
+    if (isSeconds) {
+        return QDateTime::currentDateTime().addSecs(qMax<qint64>(seconds, 0));
+    }
+    return UpdateHints::parseHttpDate(value);
+}
+
+static QDateTime responseExpiry(QNetworkReply *reply)
+{
+    const QByteArray &cacheControl = reply->rawHeader("Cache-Control");
+    for (const QByteArray &directive : cacheControl.split(',')) {
+        const QByteArray &trimmed = directive.trimmed().toLower();
+        if (trimmed == "no-cache" || trimmed == "no-store") {
+            return QDateTime();
+        }
+        if (trimmed.startsWith("max-age=")) {
+            bool ok = false;
+            const qint64 maxAge = trimmed.mid(8).toLongLong(&ok);
+            return ok ? QDateTime::currentDateTime().addSecs(maxAge) : QDateTime();
+        }
+    }
+    if (reply->hasRawHeader("Expires")) {
+        return UpdateHints::parseHttpDate(reply->rawHeader("Expires"));
+    }
+    return QDateTime();
+}
+
+static QDateTime retryAfter(QNetworkReply *reply)
+{
+    const int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (!isThrottled(httpStatus) || !reply->hasRawHeader("Retry-After")) {
+        return QDateTime();
+    }
+    return parseRetryAfter(reply->rawHeader("Retry-After"));
+}
+
+const QDateTime &LoadOperation::cacheExpiry() const
+{
+    return m_cacheExpiry;
+}
+
+void LoadOperation::setAcceptDelta(bool acceptDelta)
+{
+    m_acceptDelta = acceptDelta;
+}
+
+void LoadOperation::setBypassCache(bool bypassCache)
+{
+    m_bypassCache = bypassCache;
+}
+
+bool LoadOperation::isDelta() const
+{
+    return m_isDelta;
+}
+
+const QUrl &LoadOperation::permanentRedirect() const
+{
+    return m_permanentRedirect;
+}
+
+const QByteArray &LoadOperation::contentType() const
+{
+    return m_contentType;
+}
+
+void LoadOperation::setStreaming(bool streaming)
+{
+    m_streaming = streaming;
+}
+
+void LoadOperation::setPaused(bool paused)
+{
+    m_paused = paused;
+    if (m_paused || m_reply.isNull()) {
+        return;
+    }
+    if (m_finishPending) {
+        m_finishPending = false;
+        onReplyFinished();
+    } else if (m_streaming) {
+        onReadyRead();
+    }
+}
+
+static bool isPermanentRedirect(int httpStatus)
+{
+    return httpStatus == 301 /* Moved Permanently */ || httpStatus == 308 /* Permanent Redirect */;
+}
+
+static bool isRedirect(int httpStatus)
+{
+    // not 304 Not Modified, which can also carry a Location header
+    return httpStatus == 301 || httpStatus == 302 || httpStatus == 303 || httpStatus == 307 || httpStatus == 308;
+}
+
+static QUrl redirectTarget(QNetworkReply *reply)
+{
+    const int httpStatus = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (reply->error() != QNetworkReply::NoError || !isRedirect(httpStatus)) {
+        return QUrl();
+    }
+    const QUrl &location = reply->header(QNetworkRequest::LocationHeader).toUrl();
+    return location.isValid() ? reply->url().resolved(location) : QUrl();
+}
+
+void LoadOperation::followRedirect(const QUrl &from, const QUrl &to)
+{
+    const bool isInsecure = from.scheme() == QLatin1String("https") && to.scheme() == QLatin1String("http");
+    if (isInsecure) {
+        qDebug() << "insecure redirect from" << from << "to" << to;
+    }
+
+    // never learn a downgrade to plain http
+    if (isPermanentRedirect(m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()) && !isInsecure) {
+        if (m_onlyPermanentRedirects) {
+            m_permanentRedirect = to;
+        }
+    } else {
+        m_onlyPermanentRedirects = false;
+        cacheRedirect(from, to, responseExpiry(m_reply));
+    }
+    start(to, "too many redirects");
+}
+
+void LoadOperation::onReadyRead()
+{
+    // redirects and error pages aren't part of the feed
+    const int httpStatus = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (m_paused || (httpStatus != 0 && (httpStatus < 200 || httpStatus >= 300))) {
+        return;
+    }
+    const QByteArray data = m_reply->readAll();
+    if (data.isEmpty()) {
+        return;
+    }
+    if (m_stats != nullptr) {
+        m_stats->bytes += data.size();
+    }
+    emit received(data);
+}
+
 void LoadOperation::onReplyFinished()
 {
+    if (m_paused && m_streaming) {
+        // the rest of the body is read once the operation resumes
+        m_finishPending = true;
+        return;
+    }
     m_reply->deleteLater();
     QUrl url = m_reply->url();
+    recordPhases();
+
+    const QUrl &redirect = redirectTarget(m_reply);
+    if (redirect.isValid()) {
+        followRedirect(url, redirect);
+        return;
+    }
 
     switch (m_reply->error()) {
     case QNetworkReply::NoError: {
+        m_cacheExpiry = responseExpiry(m_reply);
+        m_contentType = m_reply->rawHeader("Content-Type");
+        m_isDelta = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 226 /* IM Used */;
+        if (m_isDelta && m_stats != nullptr) {
+            m_stats->deltaResponses++;
+        }
+        if (m_streaming) {
+            onReadyRead();
+            emit succeeded(QByteArray(), url);
+            break;
+        }
         QByteArray data = m_reply->readAll();
+        if (m_stats != nullptr) {
+            m_stats->bytes += data.size();
+        }
         emit succeeded(data, url);
         break;
     }
@@ -230,21 +742,32 @@ void LoadOperation::onReplyFinished()
         emit aborted();
         break;
 
-    case QNetworkReply::InsecureRedirectError: {
-        const QUrl redirect = m_reply->header(QNetworkRequest::LocationHeader).toUrl();
-        qDebug() << "insecure redirect from" << url << "to" << redirect;
-        start(redirect, "too many redirects");
-        break;
-    }
-
     default:
-        emit failed(m_reply->errorString());
+        emit failed(m_reply->errorString(), retryAfter(m_reply));
     }
 }
 
-Update::Update(const UpdatableFeed *feed)
+Update::Update(const UpdatableFeed *feed, UpdateStats *stats)
     : m_feed{const_cast<UpdatableFeed *>(feed)}
+    , m_stats{stats}
+{
+}
+
+void Update::setAcceptDelta(bool acceptDelta)
+{
+    m_acceptDelta = acceptDelta;
+}
+
+void Update::setStreaming(bool streaming)
+{
+    m_streaming = streaming;
+}
+
+void Update::setPaused(bool paused)
 {
+    if (m_currentOperation) {
+        m_currentOperation->setPaused(paused);
+    }
 }
 
 void Update::abort()
@@ -254,10 +777,20 @@ void Update::abort()
 
 void Update::start()
 {
-    m_currentOperation.reset(new LoadOperation);
+    m_currentOperation.reset(new LoadOperation(m_stats));
+    m_currentOperation->setBypassCache(m_bypassCache);
+    m_streamParser.reset();
+    m_feedSize = 0;
     if (m_feed->flags() & Feed::IsWebPageFlag) {
         QObject::connect(m_currentOperation.get(), &LoadOperation::succeeded, this, &Update::onWebPageFetchSucceeded);
+    } else if (m_streaming && NetworkAccessManager::instance()->allowsStreaming()) {
+        // articles are stored as they arrive, so a delta can't be retried as a whole feed
+        m_streamParser = std::make_unique<StreamingFeedParser>(m_feed->url());
+        m_currentOperation->setStreaming(true);
+        QObject::connect(m_currentOperation.get(), &LoadOperation::received, this, &Update::onPrimaryFeedDataReceived);
+        QObject::connect(m_currentOperation.get(), &LoadOperation::succeeded, this, &Update::onStreamedFeedFetchSucceeded);
     } else {
+        m_currentOperation->setAcceptDelta(m_acceptDelta);
         QObject::connect(m_currentOperation.get(), &LoadOperation::succeeded, this, &Update::onPrimaryFeedFetchSucceeded);
     }
     QObject::connect(m_currentOperation.get(), &LoadOperation::failed, this, &Update::onFailed);
@@ -265,14 +798,68 @@ void Update::start()
     m_currentOperation->start(m_feed->url());
 }
 
+const UpdateHints &Update::updateHints() const
+{
+    return m_updateHints;
+}
+
+const QUrl &Update::permanentRedirect() const
+{
+    return m_permanentRedirect;
+}
+
+qint64 Update::feedSize() const
+{
+    return m_feedSize;
+}
+
+void Update::captureUpdateHints(const QByteArray &data)
+{
+    m_updateHints = UpdateHints::fromResponse(data, m_currentOperation->cacheExpiry(), m_feed->updater()->updateStartTime());
+}
+
+Syndication::FeedPtr Update::parseFeed(const QByteArray &data, const QUrl &url)
+{
+    QElapsedTimer parseTimer;
+    parseTimer.start();
+    m_feedSize = data.size();
+    // the Syndication library builds a DOM several times the size of the document
+    Syndication::FeedPtr feed = data.size() >= feedStreamingThreshold ? StreamingFeedParser::parse(data, url)
+                                                                      : Syndication::parserCollection()->parse({data, url.toString()});
+    m_stats->parseMsecs += parseTimer.elapsed();
+    return feed;
+}
+
+Syndication::FeedPtr Update::extractLinks(const QByteArray &data, const QByteArray &contentType, const QUrl &url)
+{
+    QElapsedTimer parseTimer;
+    parseTimer.start();
+    ArticleLinkExtractor extractor(HtmlDecoder::toUtf8(data, contentType), url);
+    extractor.walk();
+    Syndication::FeedPtr feed = extractor.articleLinksFeed();
+    m_stats->parseMsecs += parseTimer.elapsed();
+    return feed;
+}
+
 void Update::onPrimaryFeedFetchSucceeded(const QByteArray &data, const QUrl &url)
 {
     m_firstData = data;
-    Syndication::FeedPtr feed = Syndication::parserCollection()->parse({data, url.toString()});
-    if (feed.isNull()) {
+    m_firstContentType = m_currentOperation->contentType();
+    m_permanentRedirect = m_currentOperation->permanentRedirect();
+    captureUpdateHints(data);
+    Syndication::FeedPtr feed = parseFeed(data, url);
+    // a delta can also come from the cache after a request that didn't ask for one
+    const bool isUnusableDelta = m_currentOperation->isDelta() && (feed.isNull() || !m_acceptDelta);
+    if (isUnusableDelta && !m_bypassCache) {
+        // a delta that we can't use says nothing about the feed, so load the whole thing
+        qDebug() << "unusable delta feed from" << url;
+        m_acceptDelta = false;
+        m_bypassCache = true;
+        start();
+    } else if (feed.isNull()) {
         // if the feed didn't parse, try feed discovery
-        QUrl discoveredFeedUrl = FeedDiscovery::discoverFeed(m_feed->url(), data);
-        m_currentOperation.reset(new LoadOperation);
+        QUrl discoveredFeedUrl = FeedDiscovery::discoverFeed(m_feed->url(), HtmlDecoder::toUtf8(data, m_firstContentType));
+        m_currentOperation.reset(new LoadOperation(m_stats));
         QObject::connect(m_currentOperation.get(), &LoadOperation::succeeded, this, &Update::onDiscoveredFeedFetchSucceeded);
         QObject::connect(m_currentOperation.get(), &LoadOperation::failed, this, &Update::onDiscoveredFeedFetchFailed);
         QObject::connect(m_currentOperation.get(), &LoadOperation::aborted, this, &Update::onAborted);
@@ -282,20 +869,75 @@ void Update::onPrimaryFeedFetchSucceeded(const QByteArray &data, const QUrl &url
     }
 }
 
+void Update::onPrimaryFeedDataReceived(const QByteArray &data)
+{
+    m_feedSize += data.size();
+
+    // keep the document until we know it's a feed, in case it's a web page
+    if (!m_streamParser->isFeed()) {
+        m_firstData += data;
+    }
+    if (m_streamParser->hasError()) {
+        return;
+    }
+    QElapsedTimer parseTimer;
+    parseTimer.start();
+    m_streamParser->addData(data);
+    m_stats->parseMsecs += parseTimer.elapsed();
+    if (m_streamParser->isFeed()) {
+        m_firstData.clear();
+        emitStreamedItems(false);
+    }
+}
+
+void Update::emitStreamedItems(bool flush)
+{
+    m_streamBatch << m_streamParser->takeItems();
+    if (m_streamBatch.size() >= kStreamBatchSize || (flush && !m_streamBatch.isEmpty())) {
+        emit itemsReceived(std::exchange(m_streamBatch, {}));
+    }
+}
+
+void Update::onStreamedFeedFetchSucceeded(const QByteArray &data, const QUrl &url)
+{
+    Q_UNUSED(data);
+    if (!m_streamParser->isFeed()) {
+        // not a feed after all, so handle it the same way as an unstreamed response
+        const QByteArray document = std::exchange(m_firstData, {});
+        onPrimaryFeedFetchSucceeded(document, url);
+        return;
+    }
+
+    QElapsedTimer parseTimer;
+    parseTimer.start();
+    m_streamParser->finish();
+    m_stats->parseMsecs += parseTimer.elapsed();
+    emitStreamedItems(true);
+    if (m_streamParser->hasError()) {
+        emit failed(m_streamParser->errorString(), QDateTime());
+        return;
+    }
+    m_permanentRedirect = m_currentOperation->permanentRedirect();
+    captureUpdateHints(m_streamParser->head());
+    emit succeeded(m_streamParser->feed());
+}
+
 void Update::onWebPageFetchSucceeded(const QByteArray &data, const QUrl &url)
 {
-    ArticleLinkExtractor extractor(data, url);
-    extractor.walk();
-    Syndication::FeedPtr feed = extractor.articleLinksFeed();
-    emit succeeded(feed);
+    m_permanentRedirect = m_currentOperation->permanentRedirect();
+    captureUpdateHints(QByteArray());
+    emit succeeded(extractLinks(data, m_currentOperation->contentType(), url));
 }
 
 void Update::onDiscoveredFeedFetchSucceeded(const QByteArray &data, const QUrl &url)
 {
-    Syndication::FeedPtr feed = Syndication::parserCollection()->parse({data, url.toString()});
+    captureUpdateHints(data);
+    Syndication::FeedPtr feed = parseFeed(data, url);
     if (feed.isNull()) {
         fallbackToWebPage();
     } else {
+        // the feed has moved to the discovered url, so the redirect doesn't apply
+        m_permanentRedirect.clear();
         m_feed->setUrl(url);
         emit succeeded(feed);
     }
@@ -309,19 +951,17 @@ void Update::onDiscoveredFeedFetchFailed(const QString &errorString)
 
 void Update::fallbackToWebPage()
 {
-    ArticleLinkExtractor extractor(m_firstData, m_feed->url());
-    extractor.walk();
+    Syndication::FeedPtr feed = extractLinks(m_firstData, m_firstContentType, m_feed->url());
     if (m_feed) {
         m_feed->setFlags(m_feed->flags() | Feed::IsWebPageFlag);
     }
-    Syndication::FeedPtr feed = extractor.articleLinksFeed();
     emit succeeded(feed);
     return;
 }
 
-void Update::onFailed(const QString &errorString)
+void Update::onFailed(const QString &errorString, const QDateTime &retryAfter)
 {
-    emit failed(errorString);
+    emit failed(errorString, retryAfter);
 }
 
 void Update::onAborted()
@@ -17,6 +17,27 @@ class UpdatableFeed : public Feed
 public:
     Updater *updater() final;
 
+    static constexpr const int kDefaultPermanentRedirectThreshold = 3;
+
+    /**
+     * The number of consecutive updates that must be permanently redirected (301 or 308)
+     * to the same url before the feed's url is changed to it, or 0 to never change it.
+     */
+    static int permanentRedirectThreshold();
+    static void setPermanentRedirectThreshold(int threshold);
+
+    static constexpr const qint64 kDefaultStreamingThreshold = 4 * 1024 * 1024;
+
+    /**
+     * The response size (in bytes) above which a feed is parsed with StreamingFeedParser
+     * instead of the Syndication library.
+     *
+     * Feeds that have sent a response this large before are also read as they download,
+     * and their articles are stored in batches, when acceptsPartialUpdates() allows it.
+     */
+    static qint64 streamingThreshold();
+    static void setStreamingThreshold(qint64 threshold);
+
 protected:
     explicit UpdatableFeed(QObject *parent);
 
@@ -48,6 +69,20 @@ private:
      */
     virtual void expire(const QDateTime &olderThan) = 0;
 
+    /**
+     * Whether updates may be partial feeds (RFC 3229 delta feeds) that only contain the
+     * articles added since the last update, and whether the articles of a large feed may
+     * be passed to updateSourceArticle in batches while it downloads.
+     *
+     * The base implementation returns true, since updateFromSource adds articles one at a
+     * time and never removes articles that are missing from an update.  Derived classes
+     * that replace their contents with each update should override this to return false.
+     */
+    virtual bool acceptsPartialUpdates() const;
+
+    void observePermanentRedirect(const QUrl &target);
+    QFuture<void> addSourceArticles(const QList<Syndication::ItemPtr> &items);
+
     class UpdaterImpl;
     UpdaterImpl *m_updater;
 };
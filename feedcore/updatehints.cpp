@@ -0,0 +1,169 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "updatehints.h"
+#include <QLocale>
+#include <QStringList>
+#include <QTimeZone>
+#include <QXmlStreamReader>
+
+using namespace FeedCore;
+
+/* don't let a publisher push the next fetch out by more than this */
+static constexpr const qint64 kMaxHintDelay = 24 * 60 * 60;
+
+static constexpr const int kAllHours = (1 << 24) - 1;
+static constexpr const int kAllDays = (1 << 7) - 1;
+
+static const QString kSyndicationNamespace = QStringLiteral("http://purl.org/rss/1.0/modules/syndication/");
+
+bool UpdateHints::operator==(const UpdateHints &other) const
+{
+    return notBefore == other.notBefore && skipHours == other.skipHours && skipDays == other.skipDays;
+}
+
+bool UpdateHints::operator!=(const UpdateHints &other) const
+{
+    return !(*this == other);
+}
+
+static qint64 syndicationPeriod(const QString &updatePeriod)
+{
+    if (updatePeriod == QLatin1String("hourly")) {
+        return 60 * 60;
+    }
+    if (updatePeriod == QLatin1String("weekly")) {
+        return 7 * 24 * 60 * 60;
+    }
+    if (updatePeriod == QLatin1String("monthly")) {
+        return 30 * 24 * 60 * 60;
+    }
+    if (updatePeriod == QLatin1String("yearly")) {
+        return 365 * 24 * 60 * 60;
+    }
+
+    // "daily" is the default
+    return 24 * 60 * 60;
+}
+
+static int dayBit(const QString &day)
+{
+    static const QStringList days{"Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday", "Sunday"};
+    const int index = days.indexOf(day);
+    return index < 0 ? 0 : 1 << index;
+}
+
+namespace
+{
+/* reads the channel-level hints, stopping at the first item */
+class HintReader
+{
+public:
+    explicit HintReader(const QByteArray &data)
+        : m_reader(data)
+    {
+    }
+
+    qint64 ttl{0};
+    qint64 syndicationInterval{0};
+    int skipHours{0};
+    int skipDays{0};
+
+    void read()
+    {
+        QString updatePeriod;
+        int updateFrequency{0};
+        while (!m_reader.atEnd()) {
+            if (m_reader.readNext() != QXmlStreamReader::StartElement) {
+                continue;
+            }
+
+            const auto &name = m_reader.name();
+            if (name == QLatin1String("item") || name == QLatin1String("entry")) {
+                break;
+            }
+            if (m_reader.namespaceUri() == kSyndicationNamespace) {
+                if (name == QLatin1String("updatePeriod")) {
+                    updatePeriod = m_reader.readElementText().trimmed();
+                } else if (name == QLatin1String("updateFrequency")) {
+                    updateFrequency = m_reader.readElementText().trimmed().toInt();
+                }
+            } else if (!m_reader.namespaceUri().isEmpty()) {
+                // the remaining hints are plain RSS 2.0 elements
+                continue;
+            } else if (name == QLatin1String("ttl")) {
+                ttl = m_reader.readElementText().trimmed().toLongLong() * 60;
+            } else if (name == QLatin1String("hour")) {
+                const int hour = m_reader.readElementText().trimmed().toInt();
+                if (hour >= 0 && hour < 24) {
+                    skipHours |= 1 << hour;
+                }
+            } else if (name == QLatin1String("day")) {
+                skipDays |= dayBit(m_reader.readElementText().trimmed());
+            }
+        }
+
+        if (!updatePeriod.isEmpty() || updateFrequency > 0) {
+            syndicationInterval = syndicationPeriod(updatePeriod) / qMax(updateFrequency, 1);
+        }
+    }
+
+private:
+    QXmlStreamReader m_reader;
+};
+}
+
+UpdateHints UpdateHints::fromResponse(const QByteArray &data, const QDateTime &cacheExpiry, const QDateTime &timestamp)
+{
+    HintReader reader(data);
+    reader.read();
+
+    UpdateHints result;
+    const qint64 feedDelay = qBound<qint64>(0, qMax(reader.ttl, reader.syndicationInterval), kMaxHintDelay);
+    if (feedDelay > 0) {
+        result.notBefore = timestamp.addSecs(feedDelay);
+    }
+    if (cacheExpiry.isValid() && cacheExpiry > timestamp && cacheExpiry > result.notBefore) {
+        result.notBefore = qMin(cacheExpiry, timestamp.addSecs(kMaxHintDelay));
+    }
+
+    // a feed that asks to never be fetched is probably misconfigured
+    if (reader.skipHours != kAllHours) {
+        result.skipHours = reader.skipHours;
+    }
+    if (reader.skipDays != kAllDays) {
+        result.skipDays = reader.skipDays;
+    }
+    return result;
+}
+
+QDateTime UpdateHints::nextAllowedTime(const QDateTime &time) const
+{
+    if (skipHours == 0 && skipDays == 0) {
+        return time;
+    }
+
+    QDateTime result = time.toUTC();
+    for (int i = 0; i < 24 * 7; ++i) {
+        const bool hourSkipped = skipHours & (1 << result.time().hour());
+        const bool daySkipped = skipDays & (1 << (result.date().dayOfWeek() - 1));
+        if (!hourSkipped && !daySkipped) {
+            break;
+        }
+
+        // move to the start of the next hour
+        result = QDateTime(result.date(), QTime(result.time().hour(), 0), QTimeZone::utc()).addSecs(60 * 60);
+    }
+    return result.toTimeZone(time.timeZone());
+}
+
+QDateTime UpdateHints::parseHttpDate(const QByteArray &value)
+{
+    const QDateTime date = QLocale::c().toDateTime(QString::fromLatin1(value.trimmed()), QStringLiteral("ddd, dd MMM yyyy hh:mm:ss 'GMT'"));
+    if (!date.isValid()) {
+        return QDateTime();
+    }
+    return QDateTime(date.date(), date.time(), QTimeZone::utc());
+}
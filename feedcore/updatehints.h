@@ -0,0 +1,56 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+#include <QByteArray>
+#include <QDateTime>
+
+namespace FeedCore
+{
+/**
+ * Hints about when a feed should be fetched again
+ *
+ * These are published by the feed itself (RSS ttl, skipHours and skipDays, and the
+ * sy:updatePeriod / sy:updateFrequency syndication module) or by the server that
+ * sent it (Cache-Control max-age or Expires).
+ */
+struct UpdateHints {
+    /**
+     * Don't fetch the feed again before this time
+     */
+    QDateTime notBefore;
+
+    /**
+     * Bit n is set if the feed shouldn't be fetched during hour n (UTC)
+     */
+    int skipHours{0};
+
+    /**
+     * Bit n is set if the feed shouldn't be fetched on day n+1 of the week (see Qt::DayOfWeek)
+     */
+    int skipDays{0};
+
+    bool operator==(const UpdateHints &other) const;
+    bool operator!=(const UpdateHints &other) const;
+
+    /**
+     * Collect hints from a feed document, fetched at /timestamp/.
+     *
+     * /cacheExpiry/ is the expiration time from the HTTP response headers, if any.  Hints that
+     * would delay the next fetch by more than a day are clamped.
+     */
+    static UpdateHints fromResponse(const QByteArray &data, const QDateTime &cacheExpiry, const QDateTime &timestamp);
+
+    /**
+     * The first time at or after /time/ that isn't excluded by skipHours or skipDays
+     */
+    QDateTime nextAllowedTime(const QDateTime &time) const;
+
+    /**
+     * Parse an HTTP-date header value (RFC 7231 IMF-fixdate), returning an invalid QDateTime on failure
+     */
+    static QDateTime parseHttpDate(const QByteArray &value);
+};
+}
@@ -0,0 +1,138 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "updatepacer.h"
+#include "storage.h"
+#include <QDateTime>
+#include <QHash>
+#include <QMultiMap>
+#include <QPointer>
+#include <QTimer>
+
+namespace FeedCore
+{
+/* launch at most this many updates before returning to the event loop */
+static constexpr const int kMaxLaunchesPerTick = 8;
+
+/* how long to wait before checking the backlog again */
+static constexpr const int kBacklogRetryInterval = 250;
+
+struct UpdatePacer::PrivData {
+    QPointer<Storage> storage;
+    QMultiMap<qint64, Feed::Updater *> queue;
+    QHash<Feed::Updater *, qint64> launchTimes;
+    QTimer timer;
+    int window{kDefaultWindow};
+    int maxBacklog{kDefaultMaxBacklog};
+};
+
+UpdatePacer::UpdatePacer(Storage *storage, QObject *parent)
+    : QObject(parent)
+    , d{std::make_unique<PrivData>()}
+{
+    d->storage = storage;
+    d->timer.setSingleShot(true);
+    d->timer.callOnTimeout(this, &UpdatePacer::launchDue);
+}
+
+UpdatePacer::~UpdatePacer()
+{
+    const QList<Feed::Updater *> pending = d->queue.values();
+    for (Feed::Updater *updater : pending) {
+        updater->cancelPending();
+    }
+}
+
+int UpdatePacer::window() const
+{
+    return d->window;
+}
+
+void UpdatePacer::setWindow(int window)
+{
+    d->window = window;
+}
+
+int UpdatePacer::maxBacklog() const
+{
+    return d->maxBacklog;
+}
+
+void UpdatePacer::setMaxBacklog(int maxBacklog)
+{
+    d->maxBacklog = maxBacklog;
+}
+
+int UpdatePacer::pendingCount() const
+{
+    return static_cast<int>(d->queue.size());
+}
+
+static qint64 launchDelay(Feed *feed, int window)
+{
+    if (window <= 0) {
+        return 0;
+    }
+
+    // a fixed seed keeps each feed in the same slot from one run to the next
+    return static_cast<qint64>(qHash(feed->url().toString(), 0) % static_cast<size_t>(window));
+}
+
+void UpdatePacer::enqueue(Feed::Updater *updater)
+{
+    remove(updater);
+    const qint64 launchTime = QDateTime::currentMSecsSinceEpoch() + launchDelay(updater->feed(), d->window);
+    d->queue.insert(launchTime, updater);
+    d->launchTimes.insert(updater, launchTime);
+    armTimer();
+}
+
+void UpdatePacer::remove(Feed::Updater *updater)
+{
+    const auto launchTime = d->launchTimes.constFind(updater);
+    if (launchTime == d->launchTimes.cend()) {
+        return;
+    }
+    const auto it = d->queue.find(*launchTime, updater);
+    if (it != d->queue.end()) {
+        d->queue.erase(it);
+    }
+    d->launchTimes.erase(launchTime);
+}
+
+void UpdatePacer::launchDue()
+{
+    if (isBacklogged()) {
+        d->timer.start(kBacklogRetryInterval);
+        return;
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (int launched = 0; launched < kMaxLaunchesPerTick; ++launched) {
+        if (d->queue.isEmpty() || d->queue.firstKey() > now) {
+            break;
+        }
+        Feed::Updater *updater = d->queue.first();
+        remove(updater);
+        updater->launch();
+    }
+    armTimer();
+}
+
+void UpdatePacer::armTimer()
+{
+    if (d->queue.isEmpty()) {
+        d->timer.stop();
+        return;
+    }
+    const qint64 delay = d->queue.firstKey() - QDateTime::currentMSecsSinceEpoch();
+    d->timer.start(static_cast<int>(qMax<qint64>(delay, 0)));
+}
+
+bool UpdatePacer::isBacklogged() const
+{
+    return d->storage && d->storage->pendingTasks() > d->maxBacklog;
+}
+}
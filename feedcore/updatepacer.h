@@ -0,0 +1,62 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+#include "feed.h"
+#include <QObject>
+#include <memory>
+
+namespace FeedCore
+{
+class Storage;
+
+/**
+ * Spreads the launch of many feed updates over a time window
+ *
+ * Updates started with Feed::Updater::startPaced are launched after a delay that is
+ * derived from the feed URL, so a given feed always lands in the same slot of the
+ * window. No new updates are launched while the storage backend has more than
+ * maxBacklog() tasks waiting.
+ */
+class UpdatePacer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit UpdatePacer(Storage *storage = nullptr, QObject *parent = nullptr);
+    ~UpdatePacer();
+
+    static constexpr const int kDefaultWindow = 10000;
+    static constexpr const int kDefaultMaxBacklog = 256;
+
+    /**
+     * The length of the window (in msecs) that queued updates are spread over.
+     *
+     * Set this to 0 to launch updates as soon as the backlog allows.
+     */
+    int window() const;
+    void setWindow(int window);
+
+    /**
+     * The number of waiting storage tasks above which no new updates are launched.
+     */
+    int maxBacklog() const;
+    void setMaxBacklog(int maxBacklog);
+
+    /**
+     * The number of updates that are waiting to be launched.
+     */
+    int pendingCount() const;
+
+private:
+    struct PrivData;
+    std::unique_ptr<PrivData> d;
+    void enqueue(Feed::Updater *updater);
+    void remove(Feed::Updater *updater);
+    void launchDue();
+    void armTimer();
+    bool isBacklogged() const;
+    friend Feed::Updater;
+};
+}
@@ -0,0 +1,61 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "updatestats.h"
+#include <QJsonArray>
+
+using namespace FeedCore;
+
+QJsonObject UpdateStats::toJson() const
+{
+    return {{"feed", feedName},
+            {"url", url.toString()},
+            {"succeeded", succeeded},
+            {"pendingMsecs", pendingMsecs},
+            {"queueMsecs", queueMsecs},
+            {"connectMsecs", connectMsecs},
+            {"responseMsecs", responseMsecs},
+            {"downloadMsecs", downloadMsecs},
+            {"parseMsecs", parseMsecs},
+            {"storeMsecs", storeMsecs},
+            {"totalMsecs", totalMsecs},
+            {"requests", requests},
+            {"encryptedRequests", encryptedRequests},
+            {"cachedResponses", cachedResponses},
+            {"deltaResponses", deltaResponses},
+            {"bytes", bytes},
+            {"items", itemCount}};
+}
+
+QJsonObject UpdateStats::summarize(const QList<UpdateStats> &updates, qint64 wallMsecs)
+{
+    UpdateStats totals;
+    int failed{0};
+    QJsonArray feeds;
+    for (const UpdateStats &update : updates) {
+        failed += update.succeeded ? 0 : 1;
+        totals.pendingMsecs += update.pendingMsecs;
+        totals.queueMsecs += update.queueMsecs;
+        totals.connectMsecs += update.connectMsecs;
+        totals.responseMsecs += update.responseMsecs;
+        totals.downloadMsecs += update.downloadMsecs;
+        totals.parseMsecs += update.parseMsecs;
+        totals.storeMsecs += update.storeMsecs;
+        totals.totalMsecs += update.totalMsecs;
+        totals.requests += update.requests;
+        totals.encryptedRequests += update.encryptedRequests;
+        totals.cachedResponses += update.cachedResponses;
+        totals.deltaResponses += update.deltaResponses;
+        totals.bytes += update.bytes;
+        totals.itemCount += update.itemCount;
+        feeds << update.toJson();
+    }
+
+    QJsonObject totalsJson = totals.toJson();
+    totalsJson.remove("feed");
+    totalsJson.remove("url");
+    totalsJson.remove("succeeded");
+    return {{"wallMsecs", wallMsecs}, {"feedCount", static_cast<qint64>(updates.size())}, {"failedCount", failed}, {"totals", totalsJson}, {"feeds", feeds}};
+}
@@ -0,0 +1,53 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QUrl>
+
+namespace FeedCore
+{
+/**
+ * Measurements for a single feed update
+ *
+ * Durations are in milliseconds.  When an update makes more than one request (feed
+ * discovery, web page fallback), the network phases are summed over all requests.
+ *
+ * Qt doesn't report when a TCP connection is established, so connectMsecs covers host
+ * lookup, the TCP connection and, for encrypted connections, the TLS handshake.
+ */
+struct UpdateStats {
+    QString feedName;
+    QUrl url;
+    bool succeeded{false};
+
+    qint64 pendingMsecs{0}; /** < waiting in the update pacer */
+    qint64 queueMsecs{0}; /** < waiting for a network slot */
+    qint64 connectMsecs{0}; /** < host lookup, connect and TLS handshake */
+    qint64 responseMsecs{0}; /** < request sent until the response headers arrive (time to first byte) */
+    qint64 downloadMsecs{0}; /** < response headers until the response is complete */
+    qint64 parseMsecs{0}; /** < parsing the feed or extracting links from a web page */
+    qint64 storeMsecs{0}; /** < storing articles */
+    qint64 totalMsecs{0}; /** < the whole update, including the time spent pending */
+
+    int requests{0};
+    int encryptedRequests{0};
+    int cachedResponses{0};
+    int deltaResponses{0}; /** < RFC 3229 delta feeds (226 IM Used) */
+    qint64 bytes{0};
+    int itemCount{0};
+
+    QJsonObject toJson() const;
+
+    /**
+     * Summarize the updates from a bulk update that took /wallMsecs/ from start to finish.
+     *
+     * The result contains totals for every phase and the stats for each feed.
+     */
+    static QJsonObject summarize(const QList<UpdateStats> &updates, qint64 wallMsecs);
+};
+}
@@ -54,6 +54,14 @@ void ArticleImpl::requestContent()
     });
 }
 
+QFuture<QString> ArticleImpl::getContent()
+{
+    if (m_storage.isNull()) {
+        return QFuture<QString>();
+    }
+    return m_storage->getContent(this);
+}
+
 QFuture<QString> ArticleImpl::getCachedReadableContent()
 {
     return m_storage->getReadableContent(this);
@@ -22,6 +22,7 @@ public:
     qint64 id() const;
     void updateFromQuery(const ItemQuery &q);
     void requestContent() final;
+    QFuture<QString> getContent() final;
     QFuture<QString> getCachedReadableContent() final;
     void cacheReadableContent(const QString &readableContent) final;
 
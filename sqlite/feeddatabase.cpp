@@ -95,9 +95,48 @@ static void initDatabase(QSqlDatabase &db)
                      "ADD COLUMN flags INTEGER;",
 
                      "PRAGMA user_version = 2;"});
-        break;
+        // fall through
 
     case 2:
+        success = success
+            && exec(db,
+                    {"ALTER TABLE Feed "
+                     "ADD COLUMN failureCount INTEGER;",
+
+                     "ALTER TABLE Feed "
+                     "ADD COLUMN retryTime INTEGER;",
+
+                     "PRAGMA user_version = 3;"});
+        // fall through
+
+    case 3:
+        success = success
+            && exec(db,
+                    {"ALTER TABLE Feed "
+                     "ADD COLUMN hintNotBefore INTEGER;",
+
+                     "ALTER TABLE Feed "
+                     "ADD COLUMN skipHours INTEGER;",
+
+                     "ALTER TABLE Feed "
+                     "ADD COLUMN skipDays INTEGER;",
+
+                     "PRAGMA user_version = 4;"});
+        // fall through
+
+    case 4:
+        success = success
+            && exec(db,
+                    {"ALTER TABLE Feed "
+                     "ADD COLUMN redirectUrl TEXT;",
+
+                     "ALTER TABLE Feed "
+                     "ADD COLUMN redirectCount INTEGER;",
+
+                     "PRAGMA user_version = 5;"});
+        break;
+
+    case 5:
         break;
 
     default:
@@ -206,6 +245,26 @@ ItemQuery FeedDatabase::selectUnreadItemsByFeed(qint64 feedId)
     return q;
 }
 
+QList<QDateTime> FeedDatabase::selectItemDatesByFeed(qint64 feedId, int limit)
+{
+    QSqlQuery q(db());
+    q.prepare(
+        "SELECT date FROM Item "
+        "WHERE feed=:feed AND date>0 "
+        "ORDER BY date DESC LIMIT :limit");
+    q.bindValue(":feed", feedId);
+    q.bindValue(":limit", limit);
+    QList<QDateTime> result;
+    if (!q.exec()) {
+        qWarning() << "SQL Error in selectItemDatesByFeed: " + q.lastError().text();
+        return result;
+    }
+    while (q.next()) {
+        result << QDateTime::fromSecsSinceEpoch(q.value(0).toLongLong());
+    }
+    return result;
+}
+
 ItemQuery FeedDatabase::selectItem(qint64 id)
 {
     ItemQuery q(db(), "id=:id");
@@ -565,6 +624,80 @@ void FeedDatabase::updateFeedExpireAge(qint64 feedId, qint64 expireAge)
     }
 }
 
+void FeedDatabase::updateFeedFailureCount(qint64 feedId, int failureCount)
+{
+    QSqlQuery q(db());
+    q.prepare(
+        "UPDATE Feed SET "
+        "failureCount=:failureCount "
+        "WHERE id=:id");
+    q.bindValue(":failureCount", failureCount);
+    q.bindValue(":id", feedId);
+    if (!q.exec()) {
+        qWarning() << "SQL Error in updateFeedFailureCount: " << q.lastError().text();
+    }
+}
+
+void FeedDatabase::updateFeedRetryTime(qint64 feedId, const QDateTime &retryTime)
+{
+    QSqlQuery q(db());
+    q.prepare(
+        "UPDATE Feed SET "
+        "retryTime=:retryTime "
+        "WHERE id=:id");
+    if (retryTime.isValid()) {
+        q.bindValue(":retryTime", retryTime.toSecsSinceEpoch());
+    } else {
+        q.bindValue(":retryTime", QVariant(QMetaType::fromType<qint64>()));
+    }
+    q.bindValue(":id", feedId);
+    if (!q.exec()) {
+        qWarning() << "SQL Error in updateFeedRetryTime: " << q.lastError().text();
+    }
+}
+
+void FeedDatabase::updateFeedUpdateHints(qint64 feedId, const FeedCore::UpdateHints &hints)
+{
+    QSqlQuery q(db());
+    q.prepare(
+        "UPDATE Feed SET "
+        "hintNotBefore=:hintNotBefore, "
+        "skipHours=:skipHours, "
+        "skipDays=:skipDays "
+        "WHERE id=:id");
+    if (hints.notBefore.isValid()) {
+        q.bindValue(":hintNotBefore", hints.notBefore.toSecsSinceEpoch());
+    } else {
+        q.bindValue(":hintNotBefore", QVariant(QMetaType::fromType<qint64>()));
+    }
+    q.bindValue(":skipHours", hints.skipHours);
+    q.bindValue(":skipDays", hints.skipDays);
+    q.bindValue(":id", feedId);
+    if (!q.exec()) {
+        qWarning() << "SQL Error in updateFeedUpdateHints: " << q.lastError().text();
+    }
+}
+
+void FeedDatabase::updateFeedRedirect(qint64 feedId, const QUrl &redirectUrl, int redirectCount)
+{
+    QSqlQuery q(db());
+    q.prepare(
+        "UPDATE Feed SET "
+        "redirectUrl=:redirectUrl, "
+        "redirectCount=:redirectCount "
+        "WHERE id=:id");
+    if (redirectUrl.isValid()) {
+        q.bindValue(":redirectUrl", redirectUrl.toString());
+    } else {
+        q.bindValue(":redirectUrl", QVariant(QMetaType::fromType<QString>()));
+    }
+    q.bindValue(":redirectCount", redirectCount);
+    q.bindValue(":id", feedId);
+    if (!q.exec()) {
+        qWarning() << "SQL Error in updateFeedRedirect: " << q.lastError().text();
+    }
+}
+
 void FeedDatabase::updateFeedFlags(qint64 feedId, int flags)
 {
     QSqlQuery q(db());
@@ -6,6 +6,7 @@
 #pragma once
 #include "sqlite/feedquery.h"
 #include "sqlite/itemquery.h"
+#include "updatehints.h"
 #include <QDateTime>
 #include <QSqlQuery>
 #include <QUrl>
@@ -27,6 +28,7 @@ public:
     ItemQuery selectItemsByRecommended(int limit);
     ItemQuery selectItemsByFeed(qint64 feedId);
     ItemQuery selectUnreadItemsByFeed(qint64 feedId);
+    QList<QDateTime> selectItemDatesByFeed(qint64 feedId, int limit);
     ItemQuery selectItem(qint64 id);
     ItemQuery selectItem(qint64 feed, const QString &localId);
     QString selectItemContent(qint64 id);
@@ -54,6 +56,10 @@ public:
     void updateFeedUpdateInterval(qint64 feedId, qint64 updateInterval);
     void updateFeedLastUpdate(qint64 feedId, const QDateTime &lastUpdated);
     void updateFeedExpireAge(qint64 feedId, qint64 expireAge);
+    void updateFeedFailureCount(qint64 feedId, int failureCount);
+    void updateFeedRetryTime(qint64 feedId, const QDateTime &retryTime);
+    void updateFeedUpdateHints(qint64 feedId, const FeedCore::UpdateHints &hints);
+    void updateFeedRedirect(qint64 feedId, const QUrl &redirectUrl, int redirectCount);
     void updateFeedFlags(qint64 feedId, int flags);
     void deleteFeed(qint64 feedId);
 
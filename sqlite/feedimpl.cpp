@@ -28,6 +28,8 @@ void FeedImpl::unpackUpdateInterval(qint64 updateInterval)
 {
     if (updateInterval == 0) {
         setUpdateMode(InheritUpdateMode);
+    } else if (updateInterval == -2) {
+        setUpdateMode(AdaptiveUpdateMode);
     } else if (updateInterval < 0) {
         setUpdateMode(DisableUpdateMode);
     } else {
@@ -57,6 +59,10 @@ void FeedImpl::updateFromQuery(const FeedQuery &query)
     setIcon(query.icon());
     setUnreadCount(query.unreadCount());
     setLastUpdate(query.lastUpdate());
+    setFailureCount(query.failureCount());
+    setRetryTime(query.retryTime());
+    setUpdateHints(query.updateHints());
+    setRedirect(query.redirectUrl(), query.redirectCount());
     unpackUpdateInterval(query.updateInterval());
     unpackExpireAge(query.expireAge());
     setFlags(query.flags());
@@ -70,6 +76,11 @@ QFuture<ArticleRef> FeedImpl::getArticles(bool unreadFilter)
     return m_storage->getByFeed(this);
 }
 
+QFuture<QDateTime> FeedImpl::getPublicationDates(int limit)
+{
+    return m_storage->getPublicationDates(this, limit);
+}
+
 QFuture<void> FeedImpl::updateSourceArticle(const Syndication::ItemPtr &article)
 {
     auto q = m_storage->storeArticle(this, article);
@@ -25,6 +25,7 @@ public:
     qint64 id() const;
     void updateFromQuery(const FeedQuery &query);
     QFuture<FeedCore::ArticleRef> getArticles(bool unreadFilter) final;
+    QFuture<QDateTime> getPublicationDates(int limit) final;
     bool editable() final
     {
         return true;
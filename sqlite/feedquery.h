@@ -4,6 +4,7 @@
  */
 
 #pragma once
+#include "updatehints.h"
 #include <QDateTime>
 #include <QSqlQuery>
 #include <QUrl>
@@ -19,7 +20,8 @@ public:
     {
         prepare(
             "SELECT Feed.id, Feed.displayName, Feed.category, Feed.url, Feed.link, Feed.icon, "
-            "COUNT(Item.id), updateInterval, lastUpdate, expireAge, flags "
+            "COUNT(Item.id), updateInterval, lastUpdate, expireAge, flags, "
+            "failureCount, retryTime, hintNotBefore, skipHours, skipDays, redirectUrl, redirectCount "
             "FROM Feed LEFT JOIN Item ON Item.feed=Feed.id AND Item.isRead=false "
             "WHERE "
             + whereClause + " GROUP BY Feed.id");
@@ -68,5 +70,31 @@ public:
     {
         return value(10).toInt();
     }
+    int failureCount() const
+    {
+        return value(11).toInt();
+    }
+    QDateTime retryTime() const
+    {
+        const QVariant &retryTime = value(12);
+        return retryTime.isNull() ? QDateTime() : QDateTime::fromSecsSinceEpoch(retryTime.toLongLong());
+    }
+    FeedCore::UpdateHints updateHints() const
+    {
+        const QVariant &notBefore = value(13);
+        FeedCore::UpdateHints hints;
+        hints.notBefore = notBefore.isNull() ? QDateTime() : QDateTime::fromSecsSinceEpoch(notBefore.toLongLong());
+        hints.skipHours = value(14).toInt();
+        hints.skipDays = value(15).toInt();
+        return hints;
+    }
+    QUrl redirectUrl() const
+    {
+        return QUrl(value(16).toString());
+    }
+    int redirectCount() const
+    {
+        return value(17).toInt();
+    }
 };
 }
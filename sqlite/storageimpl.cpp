@@ -14,6 +14,7 @@
 #include <QSemaphore>
 #include <QTimer>
 #include <Syndication/Person>
+#include <atomic>
 #include <utility>
 using namespace FeedCore;
 using namespace SqliteStorage;
@@ -45,6 +46,7 @@ public:
     void appendFeedResults(QPromise<FeedCore::Feed *> &op, FeedQuery &q);
     void ensureTransaction();
     bool hasArticle(qint64 id) const;
+    int pendingTasks() const;
 
 private:
     FeedDatabase m_db;
@@ -52,6 +54,7 @@ private:
     QHash<qint64, QWeakPointer<ArticleImpl>> m_articles;
     StorageImpl *m_storage;
     bool m_hasTransaction{false};
+    std::atomic<int> m_pendingTasks{0};
     const static int CommitEvent;
     void customEvent(QEvent *e) override;
 };
@@ -119,6 +122,11 @@ bool StorageImpl::Worker::hasArticle(qint64 id) const
     return m_articles.contains(id) && !m_articles[id].isNull();
 }
 
+int StorageImpl::Worker::pendingTasks() const
+{
+    return m_pendingTasks;
+}
+
 QFuture<ArticleRef> StorageImpl::getAll()
 {
     return m_worker->runInDatabaseThread<ArticleRef>([this](auto &db, auto &op) {
@@ -209,6 +217,17 @@ QFuture<ArticleRef> StorageImpl::getUnreadByFeed(FeedImpl *feed)
     });
 }
 
+QFuture<QDateTime> StorageImpl::getPublicationDates(FeedImpl *feed, int limit)
+{
+    const qint64 feedId = feed->id();
+    return m_worker->runInDatabaseThread<QDateTime>([feedId, limit](auto &db, auto &op) {
+        const QList<QDateTime> dates = db.selectItemDatesByFeed(feedId, limit);
+        for (const QDateTime &date : dates) {
+            op.addResult(date);
+        }
+    });
+}
+
 QFuture<ArticleRef> StorageImpl::storeArticle(FeedImpl *feed, const Syndication::ItemPtr &item)
 {
     // TODO maybe sync with the main thread here so we can use `item` directly instead
@@ -309,6 +328,11 @@ void StorageImpl::Worker::appendFeedResults(QPromise<Feed *> &op, FeedQuery &q)
     }
 }
 
+int StorageImpl::pendingTasks() const
+{
+    return m_worker->pendingTasks();
+}
+
 QFuture<Feed *> StorageImpl::getFeeds()
 {
     return m_worker->runInDatabaseThread<Feed *>([this](auto &db, auto &op) {
@@ -327,6 +351,9 @@ static qint64 packModeValue(Feed::UpdateMode mode, qint64 value)
     case Feed::DisableUpdateMode:
         return -1;
 
+    case Feed::AdaptiveUpdateMode:
+        return -2;
+
     case Feed::OverrideUpdateMode:
         return value;
     }
@@ -397,6 +424,18 @@ void StorageImpl::listenForChanges(FeedImpl *feed)
     QObject::connect(feed, &Feed::lastUpdateChanged, this, [this, feed] {
         m_worker->runInDatabaseThread(&FeedDatabase::updateFeedLastUpdate, feed->id(), feed->lastUpdate());
     });
+    QObject::connect(feed, &Feed::failureCountChanged, this, [this, feed] {
+        m_worker->runInDatabaseThread(&FeedDatabase::updateFeedFailureCount, feed->id(), feed->failureCount());
+    });
+    QObject::connect(feed, &Feed::retryTimeChanged, this, [this, feed] {
+        m_worker->runInDatabaseThread(&FeedDatabase::updateFeedRetryTime, feed->id(), feed->retryTime());
+    });
+    QObject::connect(feed, &Feed::updateHintsChanged, this, [this, feed] {
+        m_worker->runInDatabaseThread(&FeedDatabase::updateFeedUpdateHints, feed->id(), feed->updateHints());
+    });
+    QObject::connect(feed, &Feed::redirectChanged, this, [this, feed] {
+        m_worker->runInDatabaseThread(&FeedDatabase::updateFeedRedirect, feed->id(), feed->redirectUrl(), feed->redirectCount());
+    });
     QObject::connect(feed, &Feed::updateIntervalChanged, this, [this, feed] {
         onUpdateIntervalChanged(feed);
     });
@@ -453,10 +492,12 @@ QFuture<Payload> StorageImpl::Worker::runInDatabaseThread(Func func)
 {
     QPromise<Payload> op;
     QFuture<Payload> future = op.future();
+    m_pendingTasks++;
     QMetaObject::invokeMethod(this, [this, func, op = std::move(op)]() mutable {
         op.start();
         func(m_db, op);
         op.finish();
+        m_pendingTasks--;
     });
     return future;
 }
@@ -464,8 +505,10 @@ QFuture<Payload> StorageImpl::Worker::runInDatabaseThread(Func func)
 template<typename Func>
 void StorageImpl::Worker::runInDatabaseThread(Func func)
 {
+    m_pendingTasks++;
     QMetaObject::invokeMethod(this, [this, func]() {
         func(m_db);
+        m_pendingTasks--;
     });
 }
 
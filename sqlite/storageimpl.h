@@ -22,6 +22,7 @@ public:
     QFuture<FeedCore::ArticleRef> getById(qint64 id);
     QFuture<FeedCore::ArticleRef> getByFeed(FeedImpl *feedId);
     QFuture<FeedCore::ArticleRef> getUnreadByFeed(FeedImpl *feedId);
+    QFuture<QDateTime> getPublicationDates(FeedImpl *feed, int limit);
     QFuture<FeedCore::ArticleRef> storeArticle(FeedImpl *feed, const Syndication::ItemPtr &item);
     QFuture<QString> getContent(ArticleImpl *article);
     QFuture<QString> getReadableContent(ArticleImpl *article);
@@ -36,6 +37,7 @@ public:
     QFuture<FeedCore::ArticleRef> getHighlights(size_t limit) final;
     QFuture<FeedCore::Feed *> getFeeds() final;
     QFuture<FeedCore::Feed *> storeFeed(FeedCore::Feed *feed) final;
+    int pendingTasks() const final;
     void listenForChanges(FeedImpl *feed);
     void expire(FeedImpl *feed, const QDateTime &olderThan);
 
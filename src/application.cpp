@@ -16,9 +16,11 @@
 #ifdef KF6DBusAddons_FOUND
 #include <KDBusService>
 #endif
+#include "articleprefetcher.h"
 #include "articlesummary.h"
 #include "contentimageitem.h"
 #include "contentmodel.h"
+#include "contentpresplitter.h"
 #include "context.h"
 #include "editablefeedlistmodel.h"
 #include "feedlistmodel.h"
@@ -39,6 +41,7 @@ struct Application::PrivData {
     Settings settings;
     std::unique_ptr<QQmlApplicationEngine> engine;
     std::unique_ptr<NotificationController> notifier;
+    std::unique_ptr<ContentPresplitter> presplitter;
 
 #ifdef KF6DBusAddons_FOUND
     KDBusService *service{nullptr};
@@ -55,7 +58,7 @@ static QString filePath(QString const &fileName)
     return appDataDir.filePath(fileName);
 }
 
-static FeedCore::Context *createContext(QObject *parent = nullptr)
+FeedCore::Context *Application::createContext(QObject *parent)
 {
     QString dbPath = filePath("feeds.db");
     auto *fm = new SqliteStorage::StorageImpl(dbPath); // ownership passes to context
@@ -70,6 +73,7 @@ static void registerQmlTypes()
     qmlRegisterType<FeedCore::ProvisionalFeed>("com.rocksandpaper.syndic", 1, 0, "ProvisionalFeed");
     qmlRegisterType<ContentModel>("com.rocksandpaper.syndic", 1, 0, "ContentModel");
     qmlRegisterType<ContentImageItem>("com.rocksandpaper.syndic", 1, 0, "ContentImage");
+    qmlRegisterType<ArticlePrefetcher>("com.rocksandpaper.syndic", 1, 0, "ArticlePrefetcher");
     qmlRegisterType<FeedCore::SearchResultFeed>("com.rocksandpaper.syndic", 1, 0, "SearchResultFeed");
     qmlRegisterType<HighlightsModel>("com.rocksandpaper.syndic", 1, 0, "HighlightsModel");
     qmlRegisterType<FeedCore::ArticleSummary>("com.rocksandpaper.syndic", 1, 0, "ArticleSummary");
@@ -122,9 +126,7 @@ Application::Application(int &argc, char **argv)
     : SyndicApplicationBase(argc, argv)
     , d{std::make_unique<PrivData>()}
 {
-    setOrganizationName("syndic");
-    setOrganizationDomain("rocksandpaper.com");
-    setApplicationName("syndic");
+    setApplicationInfo();
     setDesktopFileName("com.rocksandpaper.syndic.desktop");
     setApplicationDisplayName(tr("Syndic"));
 
@@ -151,10 +153,19 @@ Application::Application(int &argc, char **argv)
 
     d->context = createContext(this);
     bindContextPropertiesToSettings();
+    d->presplitter = std::make_unique<ContentPresplitter>(d->context);
 }
 
 Application::~Application() = default;
 
+void Application::setApplicationInfo()
+{
+    // these determine where the database and settings are stored
+    setOrganizationName("syndic");
+    setOrganizationDomain("rocksandpaper.com");
+    setApplicationName("syndic");
+}
+
 FeedCore::Context *Application::context()
 {
     return d->context;
@@ -29,6 +29,18 @@ public:
     Application(int &argc, char **argv);
     ~Application();
     FeedCore::Context *context();
+
+    /**
+     * Set the names that QStandardPaths and KConfig use to locate our data.
+     *
+     * This works with any QCoreApplication, so other entry points can share our data.
+     */
+    static void setApplicationInfo();
+
+    /**
+     * Create a context backed by the application's feed database.
+     */
+    static FeedCore::Context *createContext(QObject *parent = nullptr);
     Settings *settings();
     void loadMainWindow();
     void startBackgroundNotifier();
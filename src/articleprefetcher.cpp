@@ -0,0 +1,421 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "articleprefetcher.h"
+#include "article.h"
+#include "contentblockcache.h"
+#include "contentblockstore.h"
+#include "contentimageitem.h"
+#include "context.h"
+#include "feed.h"
+#include "future.h"
+#include "htmlsplitter.h"
+#include "imagecache.h"
+#include "qmlarticleref.h"
+#include "readability/readability.h"
+#include "readability/readabilityresult.h"
+#include "readability/readablecontentcache.h"
+#include <QAbstractItemModel>
+#include <QCoreApplication>
+#include <QPointer>
+#include <QQmlEngine>
+#include <QQuickWindow>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <unordered_map>
+
+using namespace FeedCore;
+
+/* only the first images are loaded, since they are the ones on screen when the article is opened */
+static constexpr const int kMaxImagesPerArticle = 8;
+
+struct ArticlePrefetcher::Prefetch {
+    ArticleRef article;
+    quint64 id{0};
+    QPointer<ReadabilityResult> readable;
+    QList<ImageCache::Key> images;
+
+    // read by the split, which runs on another thread
+    std::shared_ptr<std::atomic_bool> cancelled{std::make_shared<std::atomic_bool>(false)};
+
+    Prefetch() = default;
+
+    ~Prefetch()
+    {
+        *cancelled = true;
+        delete readable;
+        for (const ImageCache::Key &key : std::as_const(images)) {
+            ImageCache::instance()->release(key);
+        }
+    }
+
+    Q_DISABLE_COPY_MOVE(Prefetch)
+};
+
+struct ArticlePrefetcher::PrivData {
+    QPointer<QAbstractItemModel> model;
+    QPointer<Context> context;
+    QPointer<QQuickWindow> window;
+    int currentIndex{-1};
+    int ahead{2};
+    int behind{1};
+    QTimer updateTimer;
+    quint64 nextId{0};
+    std::unordered_map<Article *, std::unique_ptr<Prefetch>> prefetches;
+
+    ArticleRef articleAt(int row) const;
+
+    // the prefetch that was started as /id/ for /article/, or nullptr if it has been cancelled
+    Prefetch *find(Article *article, quint64 id) const;
+};
+
+ArticleRef ArticlePrefetcher::PrivData::articleAt(int row) const
+{
+    if (model == nullptr || row < 0 || row >= model->rowCount()) {
+        return {};
+    }
+    return model->data(model->index(row, 0), Qt::UserRole).value<QmlArticleRef>();
+}
+
+ArticlePrefetcher::Prefetch *ArticlePrefetcher::PrivData::find(Article *article, quint64 id) const
+{
+    const auto it = prefetches.find(article);
+    if (it == prefetches.end() || it->second->id != id) {
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+namespace
+{
+class SplitPool : public QThreadPool
+{
+public:
+    SplitPool()
+    {
+        setMaxThreadCount(1);
+        setThreadPriority(QThread::LowPriority);
+    }
+};
+}
+
+static QThreadPool &splitPool()
+{
+    static SplitPool instance;
+    return instance;
+}
+
+ArticlePrefetcher::ArticlePrefetcher(QObject *parent)
+    : QObject(parent)
+    , d{std::make_unique<PrivData>()}
+{
+    // coalesce the changes from a swipe, or from several properties being set at once
+    d->updateTimer.setSingleShot(true);
+    d->updateTimer.setInterval(0);
+    QObject::connect(&d->updateTimer, &QTimer::timeout, this, &ArticlePrefetcher::update);
+}
+
+ArticlePrefetcher::~ArticlePrefetcher()
+{
+    // queued splits aren't worth finishing once the page is gone, and the pool would wait for them on exit
+    splitPool().clear();
+}
+
+QAbstractItemModel *ArticlePrefetcher::model() const
+{
+    return d->model;
+}
+
+void ArticlePrefetcher::setModel(QAbstractItemModel *model)
+{
+    if (d->model == model) {
+        return;
+    }
+    if (d->model != nullptr) {
+        QObject::disconnect(d->model, nullptr, this, nullptr);
+    }
+    d->model = model;
+    if (model != nullptr) {
+        QObject::connect(model, &QAbstractItemModel::rowsInserted, this, &ArticlePrefetcher::scheduleUpdate);
+        QObject::connect(model, &QAbstractItemModel::rowsRemoved, this, &ArticlePrefetcher::scheduleUpdate);
+        QObject::connect(model, &QAbstractItemModel::rowsMoved, this, &ArticlePrefetcher::scheduleUpdate);
+        QObject::connect(model, &QAbstractItemModel::modelReset, this, &ArticlePrefetcher::scheduleUpdate);
+    }
+    scheduleUpdate();
+    emit modelChanged();
+}
+
+int ArticlePrefetcher::currentIndex() const
+{
+    return d->currentIndex;
+}
+
+void ArticlePrefetcher::setCurrentIndex(int currentIndex)
+{
+    if (d->currentIndex == currentIndex) {
+        return;
+    }
+    d->currentIndex = currentIndex;
+    scheduleUpdate();
+    emit currentIndexChanged();
+}
+
+Context *ArticlePrefetcher::context() const
+{
+    return d->context;
+}
+
+void ArticlePrefetcher::setContext(Context *context)
+{
+    if (d->context == context) {
+        return;
+    }
+    d->context = context;
+    scheduleUpdate();
+    emit contextChanged();
+}
+
+int ArticlePrefetcher::ahead() const
+{
+    return d->ahead;
+}
+
+void ArticlePrefetcher::setAhead(int ahead)
+{
+    if (d->ahead == ahead) {
+        return;
+    }
+    d->ahead = ahead;
+    scheduleUpdate();
+    emit aheadChanged();
+}
+
+int ArticlePrefetcher::behind() const
+{
+    return d->behind;
+}
+
+void ArticlePrefetcher::setBehind(int behind)
+{
+    if (d->behind == behind) {
+        return;
+    }
+    d->behind = behind;
+    scheduleUpdate();
+    emit behindChanged();
+}
+
+QQuickWindow *ArticlePrefetcher::window() const
+{
+    return d->window;
+}
+
+void ArticlePrefetcher::setWindow(QQuickWindow *window)
+{
+    if (d->window == window) {
+        return;
+    }
+    d->window = window;
+    emit windowChanged();
+}
+
+void ArticlePrefetcher::scheduleUpdate()
+{
+    d->updateTimer.start();
+}
+
+void ArticlePrefetcher::update()
+{
+    QList<ArticleRef> wanted;
+    QSet<Article *> keep;
+
+    // the page loads the current article itself, but anything prefetched for it is kept while the page is created
+    const ArticleRef &current = d->articleAt(d->currentIndex);
+    if (current) {
+        keep.insert(current.get());
+    }
+
+    // nearest first, and the next articles before the previous ones
+    for (int i = 1; i <= std::max(d->ahead, d->behind); ++i) {
+        const ArticleRef &next = i <= d->ahead ? d->articleAt(d->currentIndex + i) : ArticleRef();
+        const ArticleRef &previous = i <= d->behind ? d->articleAt(d->currentIndex - i) : ArticleRef();
+        for (const ArticleRef &article : {next, previous}) {
+            if (current && article && !keep.contains(article.get())) {
+                keep.insert(article.get());
+                wanted << article;
+            }
+        }
+    }
+
+    for (auto it = d->prefetches.begin(); it != d->prefetches.end();) {
+        if (keep.contains(it->first)) {
+            ++it;
+        } else {
+            it = d->prefetches.erase(it);
+        }
+    }
+
+    for (const ArticleRef &article : std::as_const(wanted)) {
+        auto &prefetch = d->prefetches[article.get()];
+        if (prefetch != nullptr) {
+            continue;
+        }
+        prefetch = std::make_unique<Prefetch>();
+        prefetch->article = article;
+        prefetch->id = ++d->nextId;
+        start(prefetch.get());
+    }
+}
+
+void ArticlePrefetcher::start(Prefetch *prefetch)
+{
+    const Feed *feed = prefetch->article->feed();
+    if (d->context != nullptr && feed != nullptr && (feed->flags() & Feed::UseReadableContentFlag) != 0) {
+        requestReadableContent(prefetch);
+    } else {
+        requestContent(prefetch);
+    }
+}
+
+void ArticlePrefetcher::requestContent(Prefetch *prefetch)
+{
+    // not Article::requestContent(), which would also deliver the content to the pages that are showing the article
+    QFuture<QString> content = prefetch->article->getContent();
+    if (content.isCanceled()) {
+        return;
+    }
+    Future::safeThen(content, this, [this, article = prefetch->article.get(), id = prefetch->id](auto &fut) {
+        Prefetch *prefetch = d->find(article, id);
+        if (prefetch != nullptr && fut.isValid() && fut.resultCount() > 0) {
+            split(prefetch, fut.result());
+        }
+    });
+}
+
+void ArticlePrefetcher::requestReadableContent(Prefetch *prefetch)
+{
+    // content that was saved with the article, as in Article::requestReadableContent
+    QFuture<QString> cached = prefetch->article->getCachedReadableContent();
+    if (cached.isCanceled()) {
+        fetchReadableContent(prefetch);
+        return;
+    }
+    Future::safeThen(cached, this, [this, article = prefetch->article.get(), id = prefetch->id](auto &fut) {
+        Prefetch *prefetch = d->find(article, id);
+        if (prefetch == nullptr) {
+            return;
+        }
+        if (fut.isValid() && fut.resultCount() > 0) {
+            split(prefetch, fut.result());
+        } else {
+            fetchReadableContent(prefetch);
+        }
+    });
+}
+
+void ArticlePrefetcher::fetchReadableContent(Prefetch *prefetch)
+{
+    QFuture<ReadableContentCache::Entry> cached = ReadableContentCache::lookup(prefetch->article->url());
+    Future::safeThen(cached, this, [this, article = prefetch->article.get(), id = prefetch->id](auto &fut) {
+        Prefetch *prefetch = d->find(article, id);
+        if (prefetch == nullptr) {
+            return;
+        }
+        const ReadableContentCache::Entry &entry = fut.result();
+        if (entry.isFresh()) {
+            split(prefetch, entry.content);
+        } else {
+            fetchFromReadability(prefetch);
+        }
+    });
+}
+
+void ArticlePrefetcher::fetchFromReadability(Prefetch *prefetch)
+{
+    Readability *readability = d->context != nullptr ? d->context->getReadability() : nullptr;
+    if (readability == nullptr) {
+        requestContent(prefetch);
+        return;
+    }
+    prefetch->readable = readability->fetch(prefetch->article->url(), Readability::BackgroundPriority);
+    QObject::connect(prefetch->readable, &ReadabilityResult::finished, this, [this, prefetch](const QString &content) {
+        prefetch->article->cacheReadableContent(content);
+        split(prefetch, content);
+    });
+    QObject::connect(prefetch->readable, &ReadabilityResult::error, this, [this, prefetch] {
+        requestContent(prefetch);
+    });
+}
+
+void ArticlePrefetcher::split(Prefetch *prefetch, const QString &content)
+{
+    if (content.isEmpty()) {
+        return;
+    }
+    splitPool().start([prefetcher = QPointer<ArticlePrefetcher>(this),
+                       article = prefetch->article.get(),
+                       id = prefetch->id,
+                       cancelled = prefetch->cancelled,
+                       content,
+                       base = prefetch->article->url()] {
+        // the article may have been swiped past while the split was queued
+        if (*cancelled) {
+            return;
+        }
+        QList<ContentBlock *> blocks = ContentBlockCache::find(content, nullptr);
+        const bool isCached = !blocks.isEmpty();
+        if (!isCached) {
+            blocks = ContentBlockStore::load(content);
+        }
+        if (blocks.isEmpty()) {
+            blocks = HtmlSplitter::cleanHtml(content, nullptr);
+            ContentBlockStore::store(content, blocks);
+        }
+
+        QList<QUrl> images;
+        for (ContentBlock *block : std::as_const(blocks)) {
+            auto *image = qobject_cast<ImageBlock *>(block);
+            if (image != nullptr && images.size() < kMaxImagesPerArticle) {
+                images << QUrl(image->resolvedSrc(base));
+            }
+        }
+
+        if (isCached) {
+            qDeleteAll(blocks);
+        } else {
+            for (ContentBlock *block : std::as_const(blocks)) {
+                block->moveToThread(QCoreApplication::instance()->thread());
+            }
+            ContentBlockCache::insert(content, blocks);
+        }
+
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [prefetcher, article, id, images] {
+            if (prefetcher) {
+                prefetcher->onSplit(article, id, images);
+            }
+        });
+    });
+}
+
+void ArticlePrefetcher::onSplit(Article *article, quint64 id, const QList<QUrl> &images)
+{
+    Prefetch *prefetch = d->find(article, id);
+    const QQmlEngine *engine = qmlEngine(this);
+    if (prefetch == nullptr || engine == nullptr) {
+        return;
+    }
+
+    // the same width that ContentImageItem asks for, so the page finds the entries that were prefetched
+    const int width = ContentImageItem::decodeWidth(d->window, 0);
+    ImageCache *cache = ImageCache::instance();
+    for (const QUrl &url : images) {
+        if (!url.isEmpty()) {
+            prefetch->images << cache->acquire(url, width, engine->networkAccessManager(), QNetworkRequest::LowPriority);
+        }
+    }
+}
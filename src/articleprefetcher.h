@@ -0,0 +1,102 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+#include <QObject>
+#include <memory>
+
+class QAbstractItemModel;
+class QQuickWindow;
+namespace FeedCore
+{
+class Article;
+class Context;
+}
+
+/**
+ * Loads the articles next to the current one in an article list, so that swiping to
+ * them doesn't have to wait for the network.
+ *
+ * For the next /ahead/ and previous /behind/ articles, the prefetcher requests the
+ * content (readable content for feeds that use it), splits it into the
+ * ContentBlockCache, and acquires the first few images in the ImageCache at the
+ * width that a ContentImageItem in /window/ would use.  Downloads are sent at low
+ * priority.  The content is queried without emitting Article::gotContent, so pages
+ * that are already showing the article aren't affected.  When the current index moves,
+ * articles that are no longer nearby are cancelled and their images released.
+ */
+class ArticlePrefetcher : public QObject
+{
+    Q_OBJECT
+
+    /**
+     * The article list, as an ArticleListModel
+     */
+    Q_PROPERTY(QAbstractItemModel *model READ model WRITE setModel NOTIFY modelChanged);
+
+    /**
+     * The index of the article that is being shown
+     */
+    Q_PROPERTY(int currentIndex READ currentIndex WRITE setCurrentIndex NOTIFY currentIndexChanged);
+
+    /**
+     * The context that readable content is fetched from
+     */
+    Q_PROPERTY(FeedCore::Context *context READ context WRITE setContext NOTIFY contextChanged);
+
+    /**
+     * The number of articles after the current one to load
+     */
+    Q_PROPERTY(int ahead READ ahead WRITE setAhead NOTIFY aheadChanged);
+
+    /**
+     * The number of articles before the current one to load
+     */
+    Q_PROPERTY(int behind READ behind WRITE setBehind NOTIFY behindChanged);
+
+    /**
+     * The window that the articles are shown in, which determines the size that images are decoded at
+     */
+    Q_PROPERTY(QQuickWindow *window READ window WRITE setWindow NOTIFY windowChanged);
+
+public:
+    explicit ArticlePrefetcher(QObject *parent = nullptr);
+    ~ArticlePrefetcher();
+
+    QAbstractItemModel *model() const;
+    void setModel(QAbstractItemModel *model);
+    int currentIndex() const;
+    void setCurrentIndex(int currentIndex);
+    FeedCore::Context *context() const;
+    void setContext(FeedCore::Context *context);
+    int ahead() const;
+    void setAhead(int ahead);
+    int behind() const;
+    void setBehind(int behind);
+    QQuickWindow *window() const;
+    void setWindow(QQuickWindow *window);
+
+signals:
+    void modelChanged();
+    void currentIndexChanged();
+    void contextChanged();
+    void aheadChanged();
+    void behindChanged();
+    void windowChanged();
+
+private:
+    struct PrivData;
+    struct Prefetch;
+    std::unique_ptr<PrivData> d;
+    void scheduleUpdate();
+    void update();
+    void start(Prefetch *prefetch);
+    void requestContent(Prefetch *prefetch);
+    void requestReadableContent(Prefetch *prefetch);
+    void fetchReadableContent(Prefetch *prefetch);
+    void fetchFromReadability(Prefetch *prefetch);
+    void split(Prefetch *prefetch, const QString &content);
+    void onSplit(FeedCore::Article *article, quint64 id, const QList<QUrl> &images);
+};
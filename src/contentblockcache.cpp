@@ -0,0 +1,96 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "contentblockcache.h"
+#include "htmlsplitter.h"
+#include <QCache>
+#include <QMutex>
+#include <algorithm>
+
+namespace
+{
+struct CachedBlocks {
+    QList<ContentBlock *> blocks;
+
+    explicit CachedBlocks(const QList<ContentBlock *> &blocks)
+        : blocks{blocks}
+    {
+    }
+
+    // the blocks belong to the GUI thread, but eviction can happen on any thread that inserts
+    ~CachedBlocks()
+    {
+        for (ContentBlock *block : std::as_const(blocks)) {
+            block->deleteLater();
+        }
+    }
+
+    Q_DISABLE_COPY_MOVE(CachedBlocks)
+};
+
+struct BlockCache {
+    QMutex mutex;
+    QCache<QString, CachedBlocks> cache{ContentBlockCache::kDefaultMaxCost};
+};
+}
+
+static BlockCache &blockCache()
+{
+    static BlockCache instance;
+    return instance;
+}
+
+bool ContentBlockCache::contains(const QString &html)
+{
+    BlockCache &cache = blockCache();
+    QMutexLocker lock(&cache.mutex);
+    return cache.cache.contains(html);
+}
+
+QList<ContentBlock *> ContentBlockCache::find(const QString &html, QObject *parent)
+{
+    BlockCache &cache = blockCache();
+    QMutexLocker lock(&cache.mutex);
+    const CachedBlocks *entry = cache.cache.object(html);
+    if (entry == nullptr) {
+        return {};
+    }
+    QList<ContentBlock *> result;
+    result.reserve(entry->blocks.size());
+    for (const ContentBlock *block : entry->blocks) {
+        result << block->clone(parent);
+    }
+    return result;
+}
+
+void ContentBlockCache::insert(const QString &html, const QList<ContentBlock *> &blocks)
+{
+    BlockCache &cache = blockCache();
+    QMutexLocker lock(&cache.mutex);
+
+    // entries that are too large for the cache are deleted right away
+    cache.cache.insert(html, new CachedBlocks(blocks), std::max<qsizetype>(1, html.size()));
+}
+
+void ContentBlockCache::clear()
+{
+    BlockCache &cache = blockCache();
+    QMutexLocker lock(&cache.mutex);
+    cache.cache.clear();
+}
+
+qsizetype ContentBlockCache::maxCost()
+{
+    BlockCache &cache = blockCache();
+    QMutexLocker lock(&cache.mutex);
+    return cache.cache.maxCost();
+}
+
+void ContentBlockCache::setMaxCost(qsizetype maxCost)
+{
+    BlockCache &cache = blockCache();
+    QMutexLocker lock(&cache.mutex);
+    cache.cache.setMaxCost(maxCost);
+}
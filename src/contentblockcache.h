@@ -0,0 +1,50 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+#include <QList>
+#include <QString>
+
+class ContentBlock;
+class QObject;
+
+/**
+ * A cache of the blocks that HtmlSplitter made from recently displayed HTML.
+ *
+ * Swiping back to an article, or opening it again, shows the same HTML, so the blocks
+ * can be copied from here instead of parsing the document again.  Entries are keyed
+ * by the HTML itself, so an article whose content changes (e.g. when readable content
+ * replaces the feed content) gets a new entry.  The cache is shared by every
+ * ContentModel, and the least recently used entries are evicted once the HTML of the
+ * cached entries adds up to more than maxCost() characters.
+ *
+ * It is safe to use from any thread.
+ */
+class ContentBlockCache
+{
+public:
+    static constexpr const qsizetype kDefaultMaxCost = 4 * 1024 * 1024;
+
+    /**
+     * Whether the blocks for /html/ are cached.
+     */
+    static bool contains(const QString &html);
+
+    /**
+     * Copies of the blocks for /html/, owned by /parent/, or an empty list if they aren't cached.
+     */
+    static QList<ContentBlock *> find(const QString &html, QObject *parent);
+
+    /**
+     * Cache /blocks/ as the result of splitting /html/.  The cache takes ownership of the blocks,
+     * which must not have a parent and must belong to the GUI thread.  Evicted blocks are deleted
+     * with deleteLater(), since eviction can happen on another thread.
+     */
+    static void insert(const QString &html, const QList<ContentBlock *> &blocks);
+
+    static void clear();
+    static qsizetype maxCost();
+    static void setMaxCost(qsizetype maxCost);
+};
@@ -0,0 +1,134 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "contentblockstore.h"
+#include "cachestore.h"
+#include "htmlsplitter.h"
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+static constexpr const quint32 kEntryMagic = 0x53594e42;
+static constexpr const qint32 kEntryVersion = 1;
+static constexpr const QDataStream::Version kStreamVersion = QDataStream::Qt_6_0;
+
+static FeedCore::CacheStore *blockStore()
+{
+    static auto *instance = new FeedCore::CacheStore(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/blocks/"),
+                                                     ContentBlockStore::kDefaultMaximumSize);
+    return instance;
+}
+
+/* hashes the string as it is in memory, so that it doesn't have to be converted first */
+static QByteArray keyForHtml(const QString &html)
+{
+    const QByteArrayView data(reinterpret_cast<const char *>(html.constData()), html.size() * qsizetype(sizeof(QChar)));
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+}
+
+static QList<ContentBlock *> readEntry(const QString &path, const QString &html, QObject *parent)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    QDataStream in(&file);
+    in.setVersion(kStreamVersion);
+    quint32 magic{0};
+    qint32 version{0};
+    qint64 htmlSize{0};
+    QByteArray compressed;
+    in >> magic >> version >> htmlSize >> compressed;
+    if (in.status() != QDataStream::Ok || magic != kEntryMagic || version != kEntryVersion || htmlSize != html.size()) {
+        return {};
+    }
+
+    QByteArray payload = qUncompress(compressed);
+    QBuffer buffer(&payload);
+    buffer.open(QIODevice::ReadOnly);
+    QDataStream blocksIn(&buffer);
+    blocksIn.setVersion(kStreamVersion);
+    quint32 count{0};
+    blocksIn >> count;
+    QList<ContentBlock *> result;
+    for (quint32 i = 0; i < count; ++i) {
+        ContentBlock *block = ContentBlock::read(blocksIn, parent);
+        if (block == nullptr) {
+            qDeleteAll(result);
+            return {};
+        }
+        result << block;
+    }
+    return result;
+}
+
+static bool writeEntry(const QString &path, const QString &html, const QList<ContentBlock *> &blocks)
+{
+    QByteArray payload;
+    QDataStream blocksOut(&payload, QIODevice::WriteOnly);
+    blocksOut.setVersion(kStreamVersion);
+    blocksOut << quint32(blocks.size());
+    for (const ContentBlock *block : blocks) {
+        block->write(blocksOut);
+    }
+
+    QDir().mkpath(path.left(path.lastIndexOf('/')));
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QDataStream out(&file);
+    out.setVersion(kStreamVersion);
+    out << kEntryMagic << kEntryVersion << qint64(html.size()) << qCompress(payload);
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool ContentBlockStore::contains(const QString &html)
+{
+    return blockStore()->contains(keyForHtml(html));
+}
+
+QList<ContentBlock *> ContentBlockStore::load(const QString &html, QObject *parent)
+{
+    auto *store = blockStore();
+    const QByteArray &key = keyForHtml(html);
+    if (!store->contains(key)) {
+        return {};
+    }
+    const QString &path = store->pathForKey(key);
+    const QList<ContentBlock *> &result = readEntry(path, html, parent);
+    if (result.isEmpty()) {
+        store->drop(key);
+        store->removeFiles(key);
+        return {};
+    }
+    store->touch(key);
+    return result;
+}
+
+void ContentBlockStore::store(const QString &html, const QList<ContentBlock *> &blocks)
+{
+    if (blocks.isEmpty()) {
+        return;
+    }
+    auto *store = blockStore();
+    const QByteArray &key = keyForHtml(html);
+    const QString &path = store->pathForKey(key);
+    if (!writeEntry(path, html, blocks)) {
+        return;
+    }
+    store->add(key, QFileInfo(path).size());
+    store->evictIfNeeded();
+}
+
+void ContentBlockStore::clear()
+{
+    blockStore()->dropAll();
+}
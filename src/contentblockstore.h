@@ -0,0 +1,38 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+#include <QList>
+#include <QString>
+
+class ContentBlock;
+class QObject;
+
+/**
+ * Blocks that HtmlSplitter made from article content, saved on disk.
+ *
+ * Entries are keyed by a hash of the HTML, so feed content and readable content that
+ * are the same share an entry, and content that changes simply misses.  They are
+ * written compressed into their own cache directory, which is limited in size with
+ * the least recently used entries evicted first.  Unlike ContentBlockCache, this
+ * survives a restart, so articles that were split in the background by
+ * ContentPresplitter open without a parse.
+ *
+ * The functions read and write files, so they should be called from a worker thread.
+ */
+class ContentBlockStore
+{
+public:
+    static constexpr const qint64 kDefaultMaximumSize = 50 * 1024 * 1024;
+
+    static bool contains(const QString &html);
+
+    /**
+     * The blocks for /html/, owned by /parent/, or an empty list if they haven't been stored.
+     */
+    static QList<ContentBlock *> load(const QString &html, QObject *parent = nullptr);
+    static void store(const QString &html, const QList<ContentBlock *> &blocks);
+    static void clear();
+};
@@ -5,21 +5,13 @@
 
 #include "contentimageitem.h"
 
-#include <QBuffer>
-#include <QNetworkReply>
 #include <QQmlEngine>
 #include <QQuickWindow>
 #include <QSGImageNode>
 #include <QSGNode>
 #include <QSGTexture>
-#include <QThread>
-
-#if defined(Q_OS_LINUX)
-#include <unistd.h>
-#endif
-
-QSet<ContentImageItem *> ContentImageItem::s_loadedItems;
-qint64 ContentImageItem::s_totalBytes = 0;
+#include <QtMath>
+#include <algorithm>
 
 ContentImageItem::ContentImageItem(QQuickItem *parent)
     : QQuickItem(parent)
@@ -28,8 +20,7 @@ ContentImageItem::ContentImageItem(QQuickItem *parent)
 
 ContentImageItem::~ContentImageItem()
 {
-    cancelImageLoad();
-    decrementMemoryTotals();
+    ImageCache::instance()->release(m_cacheKey);
 }
 
 QSGNode *ContentImageItem::updatePaintNode(QSGNode *node, QQuickItem::UpdatePaintNodeData * /* data */)
@@ -58,6 +49,9 @@ void ContentImageItem::setSource(const QUrl &src)
         return;
     }
     m_src = src;
+    m_originalSize = QSize();
+    ImageCache::instance()->release(m_cacheKey);
+    setCacheKey(ImageCache::Key());
     if (!src.isEmpty()) {
         m_image = QImage();
         beginImageLoad();
@@ -74,6 +68,12 @@ ContentImageItem::LoadStatus ContentImageItem::loadStatus()
 void ContentImageItem::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
 {
     QQuickItem::geometryChange(newGeometry, oldGeometry);
+
+    // load a larger copy if the item has grown wider than the pixels we have
+    const bool isScaled = m_cacheKey.width > 0 && m_cacheKey.width < m_originalSize.width();
+    if (isScaled && targetDecodeWidth() > m_cacheKey.width) {
+        beginImageLoad();
+    }
 }
 
 void ContentImageItem::updatePolish()
@@ -83,62 +83,66 @@ void ContentImageItem::updatePolish()
 
 void ContentImageItem::beginImageLoad()
 {
-    if (m_reply != nullptr) {
-        cancelImageLoad();
+    // keep the previous entry until the new one is acquired, in case it's the same image
+    ImageCache *cache = ImageCache::instance();
+    const ImageCache::Key previous = m_cacheKey;
+    setCacheKey(cache->acquire(m_src, targetDecodeWidth(), qmlEngine(this)->networkAccessManager()));
+    cache->release(previous);
+    const QImage &image = cache->image(m_cacheKey);
+    if (!image.isNull()) {
+        showImage(image);
     }
-    QNetworkAccessManager *nam{qmlEngine(this)->networkAccessManager()};
-    QNetworkRequest req(m_src);
-    req.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
-    m_reply = nam->get(req);
-    QObject::connect(m_reply, &QNetworkReply::finished, this, &ContentImageItem::onImageLoadFinished);
 }
 
-void ContentImageItem::cancelImageLoad()
+int ContentImageItem::decodeWidth(const QQuickWindow *window, qreal itemWidth)
 {
-    if (m_reply == nullptr) {
-        return;
+    // no limit until the item is in a window
+    if (window == nullptr) {
+        return 0;
     }
-    m_reply->deleteLater();
-    m_reply->abort();
-    m_reply = nullptr;
+    return qCeil(std::max<qreal>(window->width(), itemWidth) * window->effectiveDevicePixelRatio());
 }
 
-void ContentImageItem::onImageLoadFinished()
+int ContentImageItem::targetDecodeWidth() const
 {
-    QNetworkReply *reply = m_reply;
-    m_reply = nullptr;
-    reply->deleteLater();
-    QNetworkReply::NetworkError error = reply->error();
-    if (error == QNetworkReply::OperationCanceledError) {
-        setLoadStatus(Cancelled);
-        return;
-    }
+    return decodeWidth(window(), width());
+}
 
-    if (error != QNetworkReply::NoError) {
-        qDebug() << "image download failed:" << reply->url() << reply->errorString();
-        setLoadStatus(Error);
-        return;
+void ContentImageItem::setCacheKey(const ImageCache::Key &key)
+{
+    if (m_notifier != nullptr) {
+        QObject::disconnect(m_notifier, nullptr, this, nullptr);
     }
-
-    QByteArray arr = reply->readAll();
-    QBuffer buffer(&arr);
-    QImage image;
-    if (!image.load(&buffer, nullptr)) {
-        qDebug() << "invalid image:" << reply->url();
-        setLoadStatus(Error);
-        return;
+    m_cacheKey = key;
+    m_notifier = key.isNull() ? nullptr : ImageCache::instance()->notifier(key);
+    if (m_notifier != nullptr) {
+        QObject::connect(m_notifier, &ImageCacheNotifier::decoded, this, &ContentImageItem::onImageDecoded);
+        QObject::connect(m_notifier, &ImageCacheNotifier::failed, this, &ContentImageItem::onImageFailed);
     }
+}
+
+void ContentImageItem::onImageDecoded()
+{
+    showImage(ImageCache::instance()->image(m_cacheKey));
+}
 
-    if (!incrementMemoryTotals(image)) {
-        qDebug() << "Memory limit exceeded when loading image:" << reply->url();
+void ContentImageItem::onImageFailed()
+{
+    setCacheKey(ImageCache::Key());
+
+    // if a larger copy failed, keep showing the one we have
+    if (m_image.isNull()) {
         setLoadStatus(Error);
-        return;
     }
+}
 
+void ContentImageItem::showImage(const QImage &image)
+{
     m_image = image;
+    m_originalSize = ImageCache::instance()->originalSize(m_src);
     setFlag(QQuickItem::ItemHasContents, true);
-    setImplicitWidth(m_image.width());
-    setImplicitHeight(m_image.height());
+    setImplicitWidth(m_originalSize.width());
+    setImplicitHeight(m_originalSize.height());
     setLoadStatus(Complete);
     m_needsUpdate = true;
     update();
@@ -152,38 +156,3 @@ void ContentImageItem::setLoadStatus(LoadStatus v)
     m_loadStatus = v;
     emit loadStatusChanged();
 }
-
-void ContentImageItem::clearImage()
-{
-    s_totalBytes -= m_imageBytes;
-    m_imageBytes = 0;
-    m_image = QImage();
-    setFlag(QQuickItem::ItemHasContents, false);
-    setLoadStatus(Cancelled);
-    update();
-}
-
-void ContentImageItem::decrementMemoryTotals()
-{
-    s_totalBytes -= m_imageBytes;
-    m_imageBytes = 0;
-}
-
-// Returns true if the image was successfully added to the memory totals,
-// or false if adding the image would exceed the memory limit.
-bool ContentImageItem::incrementMemoryTotals(QImage &image)
-{
-    qint64 imageBytes = image.sizeInBytes();
-    s_totalBytes += imageBytes;
-
-    // A fairly arbitrary limit on the total amount of memory that all ContentImageItems can use.
-    // 1 GB should be enough for most articles while still fitting within the memory constraints of most devices.
-    static const qint64 kMaxTotalBytes = 1ULL << 30U;
-
-    if (s_totalBytes > kMaxTotalBytes) {
-        s_totalBytes -= imageBytes;
-        return false;
-    }
-    m_imageBytes += imageBytes;
-    return true;
-}
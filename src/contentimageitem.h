@@ -4,9 +4,10 @@
  */
 
 #pragma once
+#include "imagecache.h"
 #include <QImage>
+#include <QPointer>
 #include <QQuickItem>
-class QNetworkReply;
 
 /**
  * A QQuickItem that displays block-level images.
@@ -14,6 +15,13 @@ class QNetworkReply;
  * This component is used in the article view to display fluid-width images
  * since the built-in text renderer doesn't support that.  Small images that
  * are rendered inline with the text do not use this component.
+ *
+ * Images are loaded through the ImageCache, no wider than the window that
+ * displays them, so a large photo doesn't hold up the render loop or use
+ * memory for pixels that can't be seen, and items that show the same image
+ * share one copy.  The implicit size is always the size of the original image.
+ * If the item later grows wider than the decoded image, a larger copy is
+ * requested from the cache.
  */
 class ContentImageItem : public QQuickItem
 {
@@ -39,6 +47,13 @@ public:
     void setSource(const QUrl &src);
     LoadStatus loadStatus();
 
+    /**
+     * The width that images are decoded at for an item /itemWidth/ pixels wide in
+     * /window/, or 0 (the original size) if there is no window.  Images that are
+     * loaded before their item exists should use the item width 0.
+     */
+    static int decodeWidth(const QQuickWindow *window, qreal itemWidth);
+
 signals:
     void sourceChanged(QUrl src);
     void loadStatusChanged();
@@ -48,22 +63,19 @@ protected:
     void updatePolish() override;
 
 private:
-    static QSet<ContentImageItem *> s_loadedItems;
-    static qint64 s_totalBytes;
-    static constexpr qint64 kMaxTotalBytes = 1ULL << 30U; // 1 GB
-
     QUrl m_src;
     QImage m_image;
     bool m_needsUpdate{false};
-    QNetworkReply *m_reply{nullptr};
     LoadStatus m_loadStatus{Loading};
-    qint64 m_imageBytes{0};
+    ImageCache::Key m_cacheKey;
+    QPointer<ImageCacheNotifier> m_notifier;
+    QSize m_originalSize;
 
     void beginImageLoad();
-    void cancelImageLoad();
-    void onImageLoadFinished();
+    int targetDecodeWidth() const;
+    void setCacheKey(const ImageCache::Key &key);
+    void onImageDecoded();
+    void onImageFailed();
+    void showImage(const QImage &image);
     void setLoadStatus(LoadStatus v);
-    void clearImage();
-    void decrementMemoryTotals();
-    bool incrementMemoryTotals(QImage &image);
 };
@@ -4,6 +4,8 @@
  */
 
 #include "contentmodel.h"
+#include "contentblockcache.h"
+#include "contentblockstore.h"
 
 #include <QCoreApplication>
 #include <QEvent>
@@ -16,25 +18,36 @@
 
 #include <QDebug>
 
+/* blocks in the first insert, which should be enough to fill the screen; each insert after that is twice as large */
+static constexpr const qsizetype kFirstBatchSize = 4;
+
 namespace
 {
 const auto kAddBlockEventType = static_cast<QEvent::Type>(QEvent::registerEventType());
 
-class AddBlockEvent : public QEvent
+class AddBlocksEvent : public QEvent
 {
-    std::unique_ptr<ContentBlock> m_contentBlock;
+    QList<ContentBlock *> m_blocks;
 
 public:
-    explicit AddBlockEvent(ContentBlock *block)
+    Q_DISABLE_COPY_MOVE(AddBlocksEvent)
+    explicit AddBlocksEvent(QList<ContentBlock *> blocks)
         : QEvent(kAddBlockEventType)
-        , m_contentBlock{block}
+        , m_blocks{std::move(blocks)}
     {
     }
 
-    ContentBlock *takeBlock(QObject *newParent)
+    ~AddBlocksEvent() override
     {
-        m_contentBlock->setParent(newParent);
-        return m_contentBlock.release();
+        qDeleteAll(m_blocks);
+    }
+
+    QList<ContentBlock *> takeBlocks(QObject *newParent)
+    {
+        for (ContentBlock *block : std::as_const(m_blocks)) {
+            block->setParent(newParent);
+        }
+        return std::exchange(m_blocks, {});
     }
 };
 }
@@ -65,14 +78,49 @@ public:
     void run() override
     {
         QMutexLocker lock(&m_runLock);
-        const QList<ContentBlock *> blocks = HtmlSplitter::cleanHtml(m_text, nullptr);
-        for (ContentBlock *block : blocks) {
-            if (m_cancelled) {
-                return;
+        const QString text = m_text;
+        QList<ContentBlock *> blocks = ContentBlockStore::load(text);
+        const bool isStored = !blocks.isEmpty();
+        if (!isStored) {
+            blocks = HtmlSplitter::cleanHtml(text, nullptr);
+        }
+        QThread *targetThread = m_target->thread();
+        for (ContentBlock *block : std::as_const(blocks)) {
+            block->moveToThread(targetThread);
+        }
+
+        QList<ContentBlock *> batch;
+        qsizetype batchSize = kFirstBatchSize;
+        for (qsizetype i = 0; i < blocks.size() && !m_cancelled; ++i) {
+            ContentBlock *copy = blocks[i]->clone(nullptr);
+            copy->moveToThread(targetThread);
+            batch << copy;
+            if (batch.size() >= batchSize) {
+                postBatch(std::exchange(batch, {}));
+                batchSize *= 2;
             }
-            block->moveToThread(m_target->thread());
-            QCoreApplication::postEvent(m_target, new AddBlockEvent(block), Qt::LowEventPriority);
         }
+        if (!m_cancelled && !batch.isEmpty()) {
+            postBatch(std::exchange(batch, {}));
+        }
+        qDeleteAll(batch);
+
+        // the destructor only has to wait for the blocks to be posted, not for them to be written out
+        lock.unlock();
+        QThreadPool::globalInstance()->start([text, blocks, isStored] {
+            if (!isStored) {
+                ContentBlockStore::store(text, blocks);
+            }
+
+            // cache the blocks even if the job was cancelled, in case the user comes back to the article
+            ContentBlockCache::insert(text, blocks);
+        });
+    }
+
+private:
+    void postBatch(QList<ContentBlock *> batch)
+    {
+        QCoreApplication::postEvent(m_target, new AddBlocksEvent(std::move(batch)), Qt::LowEventPriority);
     }
 };
 
@@ -105,16 +153,20 @@ void ContentModel::setText(const QString &text)
     if (m_text != text) {
         m_text = text;
 
+        if (m_job) {
+            QThreadPool::globalInstance()->tryTake(m_job.get());
+            m_job.reset();
+        }
+        QCoreApplication::removePostedEvents(this, kAddBlockEventType);
         for (auto *block : std::as_const(m_blocks)) {
             block->deleteLater();
         }
         beginResetModel();
-        m_blocks.clear();
+        m_blocks = ContentBlockCache::find(m_text, this);
         endResetModel();
 
-        if (!m_text.isEmpty()) {
+        if (m_blocks.isEmpty() && !m_text.isEmpty()) {
             m_job = std::make_unique<ParseJob>(this, text);
-            QCoreApplication::removePostedEvents(this, kAddBlockEventType);
             QThreadPool::globalInstance()->start(m_job.get());
         }
 
@@ -129,12 +181,15 @@ QHash<int, QByteArray> ContentModel::roleNames() const
 
 void ContentModel::customEvent(QEvent *event)
 {
-    if (auto *addBlockEvent = dynamic_cast<AddBlockEvent *>(event)) {
+    if (auto *addBlocksEvent = dynamic_cast<AddBlocksEvent *>(event)) {
         assert(QThread::currentThread() == this->thread());
-        int idx = m_blocks.count();
-        beginInsertRows(QModelIndex(), idx, idx);
-        ContentBlock *block = addBlockEvent->takeBlock(this);
-        m_blocks.append(block);
+        const QList<ContentBlock *> blocks = addBlocksEvent->takeBlocks(this);
+        if (blocks.isEmpty()) {
+            return;
+        }
+        const auto first = m_blocks.count();
+        beginInsertRows(QModelIndex(), first, first + blocks.count() - 1);
+        m_blocks.append(blocks);
         endInsertRows();
     } else {
         QAbstractListModel::customEvent(event);
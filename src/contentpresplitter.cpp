@@ -0,0 +1,155 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "contentpresplitter.h"
+#include "article.h"
+#include "contentblockcache.h"
+#include "contentblockstore.h"
+#include "context.h"
+#include "feed.h"
+#include "htmlsplitter.h"
+#include "readability/readabilityprefetchscheduler.h"
+#include <QThread>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+using namespace FeedCore;
+
+/* when more new articles than this are waiting for an update to finish, the oldest are dropped */
+static constexpr const int kMaxPending = 500;
+
+/* when more splits than this are waiting for the pool, new ones are dropped; they are split when the article is opened instead */
+static constexpr const int kMaxQueued = 100;
+
+struct ContentPresplitter::PrivData {
+    Context *context{nullptr};
+    QSharedPointer<Feed> feed;
+    QList<ArticleRef> pending;
+    QMetaObject::Connection prefetchConnection;
+};
+
+namespace
+{
+class PresplitPool : public QThreadPool
+{
+public:
+    PresplitPool()
+    {
+        setMaxThreadCount(1);
+        setThreadPriority(QThread::LowestPriority);
+    }
+};
+
+std::atomic<int> queuedSplits{0};
+
+// held by each split until it has run or been cleared from the pool
+class QueuedSplit
+{
+public:
+    QueuedSplit()
+    {
+        ++queuedSplits;
+    }
+
+    ~QueuedSplit()
+    {
+        --queuedSplits;
+    }
+
+    Q_DISABLE_COPY_MOVE(QueuedSplit)
+};
+}
+
+static QThreadPool &presplitPool()
+{
+    static PresplitPool instance;
+    return instance;
+}
+
+ContentPresplitter::ContentPresplitter(Context *context, QObject *parent)
+    : QObject(parent)
+    , d{std::make_unique<PrivData>()}
+{
+    d->context = context;
+    d->feed = context->allItemsFeed();
+    QObject::connect(d->feed.get(), &Feed::articleAdded, this, &ContentPresplitter::onArticleAdded);
+    QObject::connect(d->feed.get(), &Feed::statusChanged, this, &ContentPresplitter::onStatusChanged);
+    QObject::connect(context, &Context::prefetchContentChanged, this, &ContentPresplitter::onPrefetchContentChanged);
+    onPrefetchContentChanged();
+}
+
+ContentPresplitter::~ContentPresplitter()
+{
+    // the splits are only worth doing while the application is running, and the pool waits for them on exit
+    presplitPool().clear();
+}
+
+void ContentPresplitter::presplit(const QString &html)
+{
+    if (html.isEmpty() || queuedSplits >= kMaxQueued || ContentBlockCache::contains(html)) {
+        return;
+    }
+    presplitPool().start([html, queued = std::make_shared<QueuedSplit>()] {
+        if (ContentBlockStore::contains(html)) {
+            return;
+        }
+        const QList<ContentBlock *> blocks = HtmlSplitter::cleanHtml(html, nullptr);
+        ContentBlockStore::store(html, blocks);
+        qDeleteAll(blocks);
+    });
+}
+
+void ContentPresplitter::onArticleAdded(const ArticleRef &article)
+{
+    if (article->isRead()) {
+        return;
+    }
+    d->pending << article;
+    if (d->pending.size() > kMaxPending) {
+        d->pending.removeFirst();
+    }
+    onStatusChanged();
+}
+
+void ContentPresplitter::onStatusChanged()
+{
+    // wait for the update to finish, so that the content queries don't hold up storing articles
+    const auto status = d->feed->status();
+    if (status == Feed::Updating || status == Feed::Loading) {
+        return;
+    }
+    const QList<ArticleRef> articles = std::exchange(d->pending, {});
+    for (const ArticleRef &article : articles) {
+        requestContent(article);
+    }
+}
+
+void ContentPresplitter::onPrefetchContentChanged()
+{
+    QObject::disconnect(d->prefetchConnection);
+    if (auto *scheduler = d->context->prefetchScheduler()) {
+        d->prefetchConnection = QObject::connect(scheduler, &ReadabilityPrefetchScheduler::prefetched, this, [](const ArticleRef &, const QString &content) {
+            presplit(content);
+        });
+    }
+}
+
+void ContentPresplitter::requestContent(const ArticleRef &article)
+{
+    // not requestContent(), which would also deliver the content to any page that is showing the article
+    QFuture<QString> content = article->getContent();
+    if (content.isCanceled()) {
+        return;
+    }
+
+    // the capture keeps the article alive until its content arrives
+    Future::safeThen(content, this, [article](auto &fut) {
+        if (fut.isValid() && fut.resultCount() > 0) {
+            presplit(fut.result());
+        }
+    });
+}
@@ -0,0 +1,46 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+#include "articleref.h"
+#include <QObject>
+#include <memory>
+
+namespace FeedCore
+{
+class Context;
+}
+
+/**
+ * Splits article content into blocks in the background, before it is displayed.
+ *
+ * The content of new articles is split once the update that added them has finished,
+ * and readable content is split as soon as it has been prefetched.  The blocks are
+ * saved in the ContentBlockStore, so that ContentModel can load them instead of
+ * parsing the HTML when the article is opened.  Splitting runs on a single
+ * low-priority thread, so that it doesn't hold up content that is being displayed.
+ * The queue is bounded, and whatever is still queued is dropped when the presplitter
+ * is destroyed.
+ */
+class ContentPresplitter : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ContentPresplitter(FeedCore::Context *context, QObject *parent = nullptr);
+    ~ContentPresplitter();
+
+    /**
+     * Split /html/ and store the blocks, unless they have been stored already.
+     */
+    static void presplit(const QString &html);
+
+private:
+    struct PrivData;
+    std::unique_ptr<PrivData> d;
+    void onArticleAdded(const FeedCore::ArticleRef &article);
+    void onStatusChanged();
+    void onPrefetchContentChanged();
+    void requestContent(const FeedCore::ArticleRef &article);
+};
@@ -0,0 +1,131 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "headlessupdate.h"
+#include "application.h"
+#include "context.h"
+#include "networkreplay.h"
+#include "settings.h"
+#include "sharedcache.h"
+#include "updatepacer.h"
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QTextStream>
+#include <cstring>
+using namespace FeedCore;
+
+static constexpr const char *kHeadlessOption = "--headless";
+
+bool isHeadlessUpdateRequested(int argc, char **argv)
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], kHeadlessOption) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void printFeedStats(QTextStream &out, const QJsonObject &stats)
+{
+    out << (stats.value("succeeded").toBool() ? "ok    " : "FAILED") << "  " << stats.value("totalMsecs").toInteger() << " ms"
+        << "  (pending " << stats.value("pendingMsecs").toInteger() << ", queue " << stats.value("queueMsecs").toInteger() << ", connect "
+        << stats.value("connectMsecs").toInteger() << ", response " << stats.value("responseMsecs").toInteger() << ", download "
+        << stats.value("downloadMsecs").toInteger() << ", parse " << stats.value("parseMsecs").toInteger() << ", store "
+        << stats.value("storeMsecs").toInteger() << ")  " << stats.value("items").toInteger() << " items, " << stats.value("bytes").toInteger()
+        << " bytes";
+}
+
+static void printRefreshStats(QTextStream &out, const QJsonObject &refreshStats)
+{
+    const QJsonArray &feeds = refreshStats.value("feeds").toArray();
+    for (const QJsonValue &value : feeds) {
+        const QJsonObject &stats = value.toObject();
+        out << stats.value("feed").toString() << " <" << stats.value("url").toString() << ">\n    ";
+        printFeedStats(out, stats);
+        out << "\n";
+    }
+    out << "\n"
+        << refreshStats.value("feedCount").toInteger() << " feeds, " << refreshStats.value("failedCount").toInteger() << " failed, "
+        << refreshStats.value("wallMsecs").toInteger() << " ms\n    ";
+    QJsonObject totals = refreshStats.value("totals").toObject();
+    totals.insert("succeeded", refreshStats.value("failedCount").toInteger() == 0);
+    printFeedStats(out, totals);
+    out << "\n";
+    out.flush();
+}
+
+int runHeadlessUpdate(int &argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+    Application::setApplicationInfo();
+
+    QCommandLineParser commandLine;
+    commandLine.addHelpOption();
+    commandLine.addOption(QCommandLineOption("headless", "Run without a user interface."));
+    commandLine.addOption(QCommandLineOption("update-all", "Update every feed, print the results and exit."));
+    const QCommandLineOption updateStatsOption("update-stats", "Write timing stats for each bulk update to <file> as JSON.", "file");
+    commandLine.addOption(updateStatsOption);
+    const QCommandLineOption windowOption("update-window",
+                                          "Spread the start of the updates over <msecs>. The default is to start them as fast as the "
+                                          "network and database allow.",
+                                          "msecs",
+                                          "0");
+    commandLine.addOption(windowOption);
+    const QCommandLineOption recordOption("record-network", "Save every response to the corpus in <dir>.", "dir");
+    commandLine.addOption(recordOption);
+    const QCommandLineOption replayOption("replay-network", "Serve responses from the corpus in <dir> instead of the network.", "dir");
+    commandLine.addOption(replayOption);
+    const QCommandLineOption latencyOption("replay-latency", "Delay each replayed response by <msecs>.", "msecs", "0");
+    commandLine.addOption(latencyOption);
+    const QCommandLineOption bandwidthOption("replay-bandwidth", "Deliver each replayed response at <bytes> per second.", "bytes", "0");
+    commandLine.addOption(bandwidthOption);
+    commandLine.process(app);
+
+    if (!commandLine.isSet("update-all")) {
+        QTextStream(stderr) << "--headless requires --update-all\n";
+        return 1;
+    }
+
+    if (commandLine.isSet(replayOption)) {
+        auto *replay = new ReplayNetworkAccessManager(commandLine.value(replayOption));
+        replay->setLatency(commandLine.value(latencyOption).toInt());
+        replay->setBandwidth(commandLine.value(bandwidthOption).toLongLong());
+        NetworkAccessManager::setInstance(replay);
+    } else if (commandLine.isSet(recordOption)) {
+        NetworkAccessManager::setInstance(new RecordingNetworkAccessManager(commandLine.value(recordOption), new SharedCache));
+    }
+
+    Settings settings;
+    Context *context = Application::createContext(&app);
+    context->setExpireAge(settings.expireItems() ? settings.expireAge() : 0);
+
+    // readable content prefetching is left off, since the process exits as soon as the refresh finishes
+
+    context->updatePacer()->setWindow(commandLine.value(windowOption).toInt());
+    if (commandLine.isSet(updateStatsOption)) {
+        context->setRefreshStatsFile(commandLine.value(updateStatsOption));
+    }
+
+    QObject::connect(
+        context,
+        &Context::refreshFinished,
+        &app,
+        [context] {
+            const QJsonObject &stats = context->lastRefreshStats();
+            QTextStream out(stdout);
+            printRefreshStats(out, stats);
+            QCoreApplication::exit(stats.value("failedCount").toInteger() > 0 ? 1 : 0);
+        },
+        Qt::QueuedConnection);
+    context->requestUpdate();
+    const int result = QCoreApplication::exec();
+
+    // destroying the context waits for the database thread to finish
+    delete context;
+    return result;
+}
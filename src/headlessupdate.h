@@ -0,0 +1,26 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+
+/**
+ * Update every feed once without loading the user interface, then exit.
+ *
+ * This is the entry point for "syndic --update-all --headless". It uses the same
+ * database and settings as the application, so it can be run from cron to keep the
+ * database warm, or to profile the update path. A line with timing and item stats
+ * is printed for each feed, followed by the totals.
+ *
+ * Returns the process exit code: 0 if every feed updated, 1 if any update failed.
+ */
+int runHeadlessUpdate(int &argc, char **argv);
+
+/**
+ * Check the raw command line for the headless option.
+ *
+ * This is needed before the application object is created, because headless mode
+ * doesn't create a GUI application.
+ */
+bool isHeadlessUpdateRequested(int argc, char **argv);
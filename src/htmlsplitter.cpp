@@ -4,6 +4,7 @@
  */
 
 #include "htmlsplitter.h"
+#include <QDataStream>
 #include <QRegularExpression>
 #include <cstdlib>
 #include <utility>
@@ -14,6 +15,9 @@ static constexpr const int kHeightLimit = 36;
 /* parse numeric attributes in base 10 */
 static constexpr const int kNumericAttributeBase = 10;
 
+/* identifies the type of each block written by ContentBlock::write */
+enum BlockType : quint8 { TextBlockType = 1, ImageBlockType = 2 };
+
 HtmlSplitter::HtmlSplitter(const QString &input, QObject *blockParent)
     : GumboVisitor(input)
     , m_blockParent(blockParent)
@@ -229,6 +233,48 @@ const QString &ImageBlock::delegateName() const
     return name;
 }
 
+ContentBlock *ContentBlock::read(QDataStream &in, QObject *parent)
+{
+    quint8 type{0};
+    in >> type;
+    switch (type) {
+    case TextBlockType:
+        return TextBlock::fromStream(in, parent);
+    case ImageBlockType:
+        return ImageBlock::fromStream(in, parent);
+    default:
+        return nullptr;
+    }
+}
+
+void ImageBlock::write(QDataStream &out) const
+{
+    out << quint8(ImageBlockType) << m_src << m_href << m_title << m_size;
+}
+
+ImageBlock *ImageBlock::fromStream(QDataStream &in, QObject *parent)
+{
+    QString src;
+    in >> src;
+    auto *result = new ImageBlock(src, parent);
+    in >> result->m_href >> result->m_title >> result->m_size;
+    if (in.status() != QDataStream::Ok) {
+        delete result;
+        return nullptr;
+    }
+    return result;
+}
+
+ContentBlock *ImageBlock::clone(QObject *parent) const
+{
+    auto *result = new ImageBlock(m_src, parent);
+    result->m_href = m_href;
+    result->m_title = m_title;
+    result->m_size = m_size;
+    result->m_sizeGuess = m_sizeGuess;
+    return result;
+}
+
 QString ImageBlock::resolvedSrc(const QUrl &base)
 {
     return base.resolved(m_src).toString();
@@ -279,6 +325,29 @@ const QString &TextBlock::delegateName() const
     return name;
 }
 
+void TextBlock::write(QDataStream &out) const
+{
+    out << quint8(TextBlockType) << m_text;
+}
+
+TextBlock *TextBlock::fromStream(QDataStream &in, QObject *parent)
+{
+    auto *result = new TextBlock(parent);
+    in >> result->m_text;
+    if (in.status() != QDataStream::Ok) {
+        delete result;
+        return nullptr;
+    }
+    return result;
+}
+
+ContentBlock *TextBlock::clone(QObject *parent) const
+{
+    auto *result = new TextBlock(parent);
+    result->m_text = m_text;
+    return result;
+}
+
 void TextBlock::appendText(const QString &text)
 {
     m_text.append(text);
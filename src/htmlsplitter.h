@@ -11,6 +11,7 @@
 
 class ContentBlock;
 class TextBlock;
+class QDataStream;
 /**
  * Separate text and images into blocks that can be rendered separately.
  */
@@ -54,6 +55,21 @@ public:
     {
     }
     virtual const QString &delegateName() const = 0;
+
+    /**
+     * A new block with the same content, owned by /parent/.
+     */
+    virtual ContentBlock *clone(QObject *parent) const = 0;
+
+    /**
+     * Write the block to /out/, so that it can be recreated with read().
+     */
+    virtual void write(QDataStream &out) const = 0;
+
+    /**
+     * A block read from /in/, owned by /parent/, or nullptr if the data isn't valid.
+     */
+    static ContentBlock *read(QDataStream &in, QObject *parent = nullptr);
 };
 
 class TextBlock : public ContentBlock
@@ -66,6 +82,9 @@ public:
     {
     }
     const QString &delegateName() const override;
+    ContentBlock *clone(QObject *parent) const override;
+    void write(QDataStream &out) const override;
+    static TextBlock *fromStream(QDataStream &in, QObject *parent);
 
 private:
     QString m_text{""};
@@ -84,6 +103,9 @@ class ImageBlock : public ContentBlock
 public:
     explicit ImageBlock(QString src, QObject *parent = nullptr);
     const QString &delegateName() const override;
+    ContentBlock *clone(QObject *parent) const override;
+    void write(QDataStream &out) const override;
+    static ImageBlock *fromStream(QDataStream &in, QObject *parent);
     Q_INVOKABLE QString resolvedSrc(const QUrl &base);
     Q_INVOKABLE QString resolvedHref(const QUrl &base);
     float aspectRatio();
@@ -0,0 +1,378 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "imagecache.h"
+#include <QBuffer>
+#include <QCache>
+#include <QDebug>
+#include <QImageReader>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <list>
+
+/* JPEG images with more pixels than this show a preview while they are decoded */
+static constexpr const qint64 kPreviewMinimumPixels = 2000 * 1000;
+
+/* the preview is decoded at this fraction of the full size, which libjpeg can do without decoding every pixel */
+static constexpr const int kPreviewScale = 8;
+
+// A fairly arbitrary limit on the total amount of memory that images can use, even when they are all being shown.
+// 1 GB should be enough for most articles while still fitting within the memory constraints of most devices.
+static constexpr const qint64 kMaxTotalBytes = 1LL << 30;
+
+namespace
+{
+using LruList = std::list<ImageCache::Key>;
+
+struct Entry {
+    QImage image;
+    int refs{0};
+    std::shared_ptr<ImageCacheNotifier> notifier;
+
+    // the image is the final decode and not a preview
+    bool complete{false};
+
+    // the image is as large as the original, so it can be used at any width
+    bool fullSize{false};
+
+    bool decoding{false};
+
+    // the position in the eviction order, if nothing is using the entry
+    bool isEvictable{false};
+    LruList::iterator lruPosition;
+};
+}
+
+struct ImageCache::PrivData {
+    QHash<Key, Entry> entries;
+    QHash<QUrl, QSize> originalSizes;
+    QHash<QUrl, QNetworkReply *> downloads;
+    QCache<QUrl, QByteArray> encoded{kDefaultMaxEncodedCost};
+    QThreadPool decodePool;
+    qint64 cost{0};
+    qint64 maxCost{kDefaultMaxCost};
+
+    // the entries that can be evicted, least recently used first
+    LruList lru;
+
+    void setImage(Entry &entry, const QImage &image);
+    void touch(const Key &key, Entry &entry);
+    void remove(QHash<Key, Entry>::iterator it);
+    Key findDecoded(const Key &key) const;
+    bool isReferenced(const QUrl &url) const;
+};
+
+void ImageCache::PrivData::setImage(Entry &entry, const QImage &image)
+{
+    cost += image.sizeInBytes() - entry.image.sizeInBytes();
+    entry.image = image;
+}
+
+void ImageCache::PrivData::touch(const Key &key, Entry &entry)
+{
+    if (entry.isEvictable) {
+        lru.erase(entry.lruPosition);
+    }
+    entry.isEvictable = entry.refs == 0 && !entry.decoding && !entry.image.isNull();
+    if (entry.isEvictable) {
+        entry.lruPosition = lru.insert(lru.end(), key);
+    }
+}
+
+void ImageCache::PrivData::remove(QHash<Key, Entry>::iterator it)
+{
+    if (it->isEvictable) {
+        lru.erase(it->lruPosition);
+    }
+    cost -= it->image.sizeInBytes();
+    entries.erase(it);
+}
+
+ImageCache::Key ImageCache::PrivData::findDecoded(const Key &key) const
+{
+    Key best;
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        const Key &candidate = it.key();
+        const Entry &entry = it.value();
+        if (candidate.url != key.url || !entry.complete) {
+            continue;
+        }
+        const bool isLargeEnough = entry.fullSize || (key.width > 0 && candidate.width >= key.width);
+        if (!isLargeEnough) {
+            continue;
+        }
+
+        // prefer the smallest image that is large enough
+        const int width = entry.image.width();
+        if (best.isNull() || width < entries.value(best).image.width()) {
+            best = candidate;
+        }
+    }
+    return best;
+}
+
+bool ImageCache::PrivData::isReferenced(const QUrl &url) const
+{
+    return std::any_of(entries.keyBegin(), entries.keyEnd(), [this, &url](const Key &key) {
+        return key.url == url && entries.value(key).refs > 0;
+    });
+}
+
+ImageCache *ImageCache::instance()
+{
+    static auto *instance = new ImageCache;
+    return instance;
+}
+
+ImageCache::ImageCache()
+    : d{std::make_unique<PrivData>()}
+{
+    d->decodePool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
+}
+
+ImageCache::~ImageCache() = default;
+
+ImageCache::Key ImageCache::acquire(const QUrl &url, int width, QNetworkAccessManager *nam, QNetworkRequest::Priority priority)
+{
+    Key key{url, width};
+    const QSize &original = d->originalSizes.value(url);
+    if (original.isValid() && width >= original.width()) {
+        key.width = 0;
+    }
+
+    const Key &decoded = d->findDecoded(key);
+    if (!decoded.isNull()) {
+        key = decoded;
+    }
+
+    Entry &entry = d->entries[key];
+    ++entry.refs;
+    if (entry.notifier == nullptr) {
+        entry.notifier = std::make_shared<ImageCacheNotifier>();
+    }
+    d->touch(key, entry);
+    if (!entry.complete && !entry.decoding) {
+        load(key, nam, priority);
+    }
+    return key;
+}
+
+void ImageCache::release(const Key &key)
+{
+    auto it = d->entries.find(key);
+    if (it == d->entries.end()) {
+        return;
+    }
+    Entry &entry = it.value();
+    --entry.refs;
+    d->touch(key, entry);
+
+    // stop downloading images that nothing is waiting for
+    if (entry.refs == 0 && !entry.complete && !entry.decoding && !d->isReferenced(key.url)) {
+        QNetworkReply *reply = d->downloads.value(key.url);
+        if (reply != nullptr) {
+            reply->abort();
+        }
+    }
+    evictIfNeeded();
+}
+
+QImage ImageCache::image(const Key &key) const
+{
+    return d->entries.value(key).image;
+}
+
+ImageCacheNotifier *ImageCache::notifier(const Key &key) const
+{
+    return d->entries.value(key).notifier.get();
+}
+
+QSize ImageCache::originalSize(const QUrl &url) const
+{
+    return d->originalSizes.value(url);
+}
+
+qint64 ImageCache::cost() const
+{
+    return d->cost;
+}
+
+qint64 ImageCache::maxCost() const
+{
+    return d->maxCost;
+}
+
+void ImageCache::setMaxCost(qint64 maxCost)
+{
+    d->maxCost = maxCost;
+    evictIfNeeded();
+}
+
+void ImageCache::load(const Key &key, QNetworkAccessManager *nam, QNetworkRequest::Priority priority)
+{
+    const QByteArray *encoded = d->encoded.object(key.url);
+    if (encoded != nullptr) {
+        decode(key, *encoded);
+        return;
+    }
+
+    // the entry is decoded when the download that is already running finishes
+    if (d->downloads.contains(key.url)) {
+        return;
+    }
+
+    QNetworkRequest req(key.url);
+    req.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::NoLessSafeRedirectPolicy);
+    req.setPriority(priority);
+    QNetworkReply *reply = nam->get(req);
+    d->downloads.insert(key.url, reply);
+    QObject::connect(reply, &QNetworkReply::finished, this, [this, url = key.url] {
+        onDownloadFinished(url);
+    });
+}
+
+void ImageCache::onDownloadFinished(const QUrl &url)
+{
+    QNetworkReply *reply = d->downloads.take(url);
+    reply->deleteLater();
+
+    QList<Key> waiting;
+    for (auto it = d->entries.cbegin(); it != d->entries.cend(); ++it) {
+        if (it.key().url == url && !it.value().complete && !it.value().decoding) {
+            waiting << it.key();
+        }
+    }
+
+    QNetworkReply::NetworkError error = reply->error();
+    if (error == QNetworkReply::OperationCanceledError) {
+        for (const Key &key : std::as_const(waiting)) {
+            d->remove(d->entries.find(key));
+        }
+        return;
+    }
+
+    if (error != QNetworkReply::NoError) {
+        qDebug() << "image download failed:" << reply->url() << reply->errorString();
+        for (const Key &key : std::as_const(waiting)) {
+            fail(key);
+        }
+        return;
+    }
+
+    const QByteArray &encoded = reply->readAll();
+    d->encoded.insert(url, new QByteArray(encoded), encoded.size());
+    for (const Key &key : std::as_const(waiting)) {
+        decode(key, encoded);
+    }
+}
+
+void ImageCache::decode(const Key &key, const QByteArray &encoded)
+{
+    Entry &entry = d->entries[key];
+    entry.decoding = true;
+    d->touch(key, entry);
+    const bool wantsPreview = entry.image.isNull();
+    d->decodePool.start([this, key, wantsPreview, encoded] {
+        auto deliver = [this, key](const QImage &image, const QSize &originalSize, bool isPreview) {
+            QMetaObject::invokeMethod(this, [this, key, image, originalSize, isPreview] {
+                onImageDecoded(key, image, originalSize, isPreview);
+            });
+        };
+
+        QBuffer buffer;
+        buffer.setData(encoded);
+        buffer.open(QIODevice::ReadOnly);
+        QImageReader reader(&buffer);
+        const QSize originalSize = reader.size();
+        QSize scaledSize;
+        if (key.width > 0 && originalSize.width() > key.width) {
+            scaledSize = originalSize.scaled(key.width, originalSize.height(), Qt::KeepAspectRatio);
+        }
+
+        const QSize &targetSize = scaledSize.isValid() ? scaledSize : originalSize;
+        if (wantsPreview && reader.format() == "jpeg" && qint64(targetSize.width()) * targetSize.height() > kPreviewMinimumPixels) {
+            QBuffer previewBuffer;
+            previewBuffer.setData(encoded);
+            previewBuffer.open(QIODevice::ReadOnly);
+            QImageReader previewReader(&previewBuffer);
+            previewReader.setScaledSize(originalSize / kPreviewScale);
+            const QImage &preview = previewReader.read();
+            if (!preview.isNull()) {
+                deliver(preview, originalSize, true);
+            }
+        }
+
+        if (scaledSize.isValid()) {
+            reader.setScaledSize(scaledSize);
+        }
+        const QImage &image = reader.read();
+        deliver(image, originalSize.isValid() ? originalSize : image.size(), false);
+    });
+}
+
+void ImageCache::onImageDecoded(const Key &key, const QImage &image, const QSize &originalSize, bool isPreview)
+{
+    auto it = d->entries.find(key);
+    if (it == d->entries.end()) {
+        return;
+    }
+
+    if (image.isNull()) {
+        if (!isPreview) {
+            qDebug() << "invalid image:" << key.url;
+            fail(key);
+        }
+        return;
+    }
+
+    d->originalSizes.insert(key.url, originalSize);
+    if (!isPreview) {
+        // make room before the image is counted.  The entry is still decoding, so it isn't evicted itself.
+        evictIfNeeded();
+        if (d->cost - d->entries.value(key).image.sizeInBytes() + image.sizeInBytes() > kMaxTotalBytes) {
+            qDebug() << "Memory limit exceeded when loading image:" << key.url;
+            fail(key);
+            return;
+        }
+    }
+
+    Entry &entry = d->entries[key];
+    d->setImage(entry, image);
+    entry.complete = !isPreview;
+    entry.decoding = isPreview;
+    entry.fullSize = entry.complete && image.width() >= originalSize.width();
+    d->touch(key, entry);
+
+    // the items may acquire or release entries, which would invalidate the reference
+    const std::shared_ptr<ImageCacheNotifier> notifier = entry.notifier;
+    if (notifier != nullptr) {
+        emit notifier->decoded();
+    }
+    evictIfNeeded();
+}
+
+void ImageCache::fail(const Key &key)
+{
+    auto it = d->entries.find(key);
+    if (it == d->entries.end()) {
+        return;
+    }
+    const std::shared_ptr<ImageCacheNotifier> notifier = it->notifier;
+    d->remove(it);
+    if (notifier != nullptr) {
+        emit notifier->failed();
+    }
+}
+
+void ImageCache::evictIfNeeded()
+{
+    // everything that isn't in the list is being shown or decoded
+    while (d->cost > d->maxCost && !d->lru.empty()) {
+        d->remove(d->entries.find(d->lru.front()));
+    }
+}
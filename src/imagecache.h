@@ -0,0 +1,142 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#pragma once
+#include <QHash>
+#include <QImage>
+#include <QNetworkRequest>
+#include <QObject>
+#include <QUrl>
+#include <memory>
+
+class QNetworkAccessManager;
+
+/**
+ * Tells the items that acquired an ImageCache entry about changes to it.
+ */
+class ImageCacheNotifier : public QObject
+{
+    Q_OBJECT
+
+signals:
+    /**
+     * A new image is available for the entry.
+     */
+    void decoded();
+
+    /**
+     * The image can't be loaded.  The entry is removed, along with this object, and
+     * doesn't need to be released.
+     */
+    void failed();
+};
+
+/**
+ * The decoded images shown by every ContentImageItem in the application.
+ *
+ * Images are keyed by url and by the width they were decoded at, so items that show
+ * the same image at the same size (e.g. the article view and the next page of the
+ * swipe view) share one download and one decode.  A request is also satisfied by an
+ * image that was decoded larger.  Entries are reference counted by the items that
+ * acquire them.  Once the decoded images add up to more than maxCost() bytes, the least
+ * recently used images that no item is showing are evicted.  The downloaded data is
+ * kept in a smaller cache of its own, so an image that was evicted can be decoded
+ * again without going back to the network.
+ *
+ * Decoding happens on a pool of worker threads.  Large JPEG images get a quick
+ * low-resolution preview while the full decode runs.  Each entry has its own
+ * ImageCacheNotifier, so a decode only wakes up the items that are showing it.
+ *
+ * It must only be used from the GUI thread.
+ */
+class ImageCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr const qint64 kDefaultMaxCost = 256 * 1024 * 1024;
+    static constexpr const qint64 kDefaultMaxEncodedCost = 32 * 1024 * 1024;
+
+    struct Key {
+        QUrl url;
+
+        // 0 if the image is decoded at its original size
+        int width{0};
+
+        bool isNull() const
+        {
+            return url.isEmpty();
+        }
+
+        bool operator==(const Key &other) const
+        {
+            return url == other.url && width == other.width;
+        }
+
+        bool operator!=(const Key &other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    static ImageCache *instance();
+    ~ImageCache();
+
+    /**
+     * Add a reference to /url/ decoded no wider than /width/ pixels (or at full size
+     * if /width/ is 0), and start loading it if needed.  If it has to be downloaded,
+     * /nam/ is used, and the request is sent with /priority/.
+     *
+     * Returns the key of the entry, which must be passed to release() when the image
+     * isn't needed any more.
+     */
+    Key acquire(const QUrl &url, int width, QNetworkAccessManager *nam, QNetworkRequest::Priority priority = QNetworkRequest::NormalPriority);
+
+    /**
+     * Remove a reference that was added by acquire().
+     */
+    void release(const Key &key);
+
+    /**
+     * The image for /key/, or a null image if it hasn't been decoded yet.  This may be
+     * a low-resolution preview.
+     */
+    QImage image(const Key &key) const;
+
+    /**
+     * The notifier for /key/, which lives as long as the entry.  It is valid for keys
+     * that have been acquired and not released.
+     */
+    ImageCacheNotifier *notifier(const Key &key) const;
+
+    /**
+     * The size of the original image at /url/, if it's known.
+     */
+    QSize originalSize(const QUrl &url) const;
+
+    /**
+     * The number of bytes used by the decoded images.
+     */
+    qint64 cost() const;
+
+    qint64 maxCost() const;
+    void setMaxCost(qint64 maxCost);
+
+private:
+    ImageCache();
+    struct PrivData;
+    std::unique_ptr<PrivData> d;
+    void load(const Key &key, QNetworkAccessManager *nam, QNetworkRequest::Priority priority);
+    void decode(const Key &key, const QByteArray &encoded);
+    void onDownloadFinished(const QUrl &url);
+    void onImageDecoded(const Key &key, const QImage &image, const QSize &originalSize, bool isPreview);
+    void fail(const Key &key);
+    void evictIfNeeded();
+};
+
+inline size_t qHash(const ImageCache::Key &key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.url, key.width);
+}
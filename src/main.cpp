@@ -5,6 +5,8 @@
 
 #include "application.h"
 #include "cmake-config.h"
+#include "context.h"
+#include "headlessupdate.h"
 #include <QCommandLineOption>
 #include <QCommandLineParser>
 #include <QQuickStyle>
@@ -16,6 +18,10 @@ int main(int argc, char *argv[])
     // HACK readability breaks the arm64 jit, so disable it
     qputenv("QV4_FORCE_INTERPRETER", "1");
 #endif
+    if (isHeadlessUpdateRequested(argc, argv)) {
+        return runHeadlessUpdate(argc, argv);
+    }
+
     // https://github.com/cscarney/syndic/issues/235
     // https://bugs.kde.org/show_bug.cgi?id=479891
     // Contrary to the documentation, this does not seem to change the scale factor,
@@ -36,8 +42,21 @@ int main(int argc, char *argv[])
     {
         QCommandLineParser commandLine;
         commandLine.addOption(QCommandLineOption("background"));
+        const QCommandLineOption updateAllOption("update-all", "Update every feed at startup. Add --headless to update without a user interface and exit.");
+        commandLine.addOption(updateAllOption);
+        commandLine.addOption(QCommandLineOption("headless", "Run without a user interface (requires --update-all)."));
+        const QCommandLineOption updateStatsOption("update-stats", "Write timing stats for each bulk update to <file> as JSON.", "file");
+        commandLine.addOption(updateStatsOption);
         commandLine.process(app);
 
+        if (commandLine.isSet(updateStatsOption)) {
+            app.context()->setRefreshStatsFile(commandLine.value(updateStatsOption));
+        }
+
+        if (commandLine.isSet(updateAllOption)) {
+            app.context()->requestUpdate();
+        }
+
         if (commandLine.isSet("background")) {
             app.startBackgroundNotifier();
         } else {
@@ -92,6 +92,19 @@ Kirigami.ScrollablePage {
                 }
             }
 
+            RadioButton {
+                id: updateIntervalAdaptive
+                ButtonGroup.group: updateIntervalGroup
+                //: poll more or less often depending on how often the feed publishes
+                text: qsTr("Adapt to Feed Activity")
+                checked: provisionalFeed.updateMode === Feed.AdaptiveUpdateMode
+                onToggled: {
+                    if (checked) {
+                        provisionalFeed.updateMode = Feed.AdaptiveUpdateMode
+                    }
+                }
+            }
+
             RadioButton {
                 id: updateIntervalCustom
                 ButtonGroup.group: updateIntervalGroup
@@ -121,6 +121,13 @@ Kirigami.Page {
 
     }
 
+    ArticlePrefetcher {
+        model: articleListController.model
+        currentIndex: articleListController.currentIndex
+        context: feedContext
+        window: root.Window.window
+    }
+
     OverlayMessage {
         id: hoveredLinkToolTip
         text: root.hoveredLink
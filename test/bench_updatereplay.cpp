@@ -0,0 +1,233 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*
+ * Benchmark for bulk updates, using a replayed network so that results are reproducible.
+ *
+ * By default this generates a synthetic corpus of 1000 feeds. To benchmark real feeds,
+ * record a corpus with "syndic --update-all --headless --record-network <dir>" and pass
+ * it with --corpus, along with the feed list (exported from syndic) with --opml.
+ */
+
+#include "context.h"
+#include "networkreplay.h"
+#include "sqlite/storageimpl.h"
+#include "updatepacer.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QTimer>
+#include <QXmlStreamWriter>
+#include <limits>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+using namespace FeedCore;
+
+static constexpr const int kDefaultFeedCount = 1000;
+static constexpr const int kDefaultItemCount = 20;
+static constexpr const int kSetupTimeout = 60000;
+
+struct ResourceUsage {
+    qint64 cpuMsecs{0};
+    qint64 peakRssKiB{0};
+};
+
+static ResourceUsage resourceUsage()
+{
+    ResourceUsage result;
+#ifdef Q_OS_UNIX
+    struct rusage usage {
+    };
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        result.cpuMsecs = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000 + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+#ifdef Q_OS_MACOS
+        result.peakRssKiB = usage.ru_maxrss / 1024;
+#else
+        result.peakRssKiB = usage.ru_maxrss;
+#endif
+    }
+#endif
+    return result;
+}
+
+static QByteArray syntheticFeed(int feedIndex, int itemCount)
+{
+    QByteArray result;
+    QXmlStreamWriter xml(&result);
+    xml.writeStartDocument();
+    xml.writeStartElement("rss");
+    xml.writeAttribute("version", "2.0");
+    xml.writeStartElement("channel");
+    xml.writeTextElement("title", QStringLiteral("Feed %1").arg(feedIndex));
+    xml.writeTextElement("link", QStringLiteral("https://feed-%1.example/").arg(feedIndex));
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    for (int i = 0; i < itemCount; ++i) {
+        const QString link = QStringLiteral("https://feed-%1.example/article-%2").arg(feedIndex).arg(i);
+        xml.writeStartElement("item");
+        xml.writeTextElement("title", QStringLiteral("Article %1 of feed %2").arg(i).arg(feedIndex));
+        xml.writeTextElement("link", link);
+        xml.writeTextElement("guid", link);
+        xml.writeTextElement("pubDate", now.addSecs(-3600 * i).toString(Qt::RFC2822Date));
+        xml.writeTextElement("description", QStringLiteral("<p>%1</p>").arg(QStringLiteral("Lorem ipsum dolor sit amet. ").repeated(20)));
+        xml.writeEndElement();
+    }
+    xml.writeEndElement();
+    xml.writeEndElement();
+    xml.writeEndDocument();
+    return result;
+}
+
+static QList<QUrl> writeSyntheticCorpus(const NetworkCorpus &corpus, int feedCount, int itemCount)
+{
+    QList<QUrl> result;
+    for (int i = 0; i < feedCount; ++i) {
+        const QUrl url(QStringLiteral("https://feed-%1.example/rss.xml").arg(i));
+        RecordedResponse response;
+        response.url = url;
+        response.statusCode = 200;
+        response.headers = {{"Content-Type", "application/rss+xml; charset=utf-8"}};
+        response.body = syntheticFeed(i, itemCount);
+        corpus.save(url, response);
+        result << url;
+    }
+    return result;
+}
+
+static bool writeOpml(const QString &path, const QList<QUrl> &urls)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        return false;
+    }
+    QXmlStreamWriter xml(&file);
+    xml.writeStartDocument();
+    xml.writeStartElement("opml");
+    xml.writeAttribute("version", "1.0");
+    xml.writeEmptyElement("head");
+    xml.writeStartElement("body");
+    for (const QUrl &url : urls) {
+        xml.writeEmptyElement("outline");
+        xml.writeAttribute("type", "rss");
+        xml.writeAttribute("text", url.host());
+        xml.writeAttribute("xmlUrl", url.toString());
+    }
+    xml.writeEndElement();
+    xml.writeEndElement();
+    xml.writeEndDocument();
+    return true;
+}
+
+template<typename Predicate>
+static bool waitFor(Predicate predicate, int timeout)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!predicate()) {
+        if (timer.hasExpired(timeout)) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents, 10);
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser commandLine;
+    commandLine.addHelpOption();
+    const QCommandLineOption corpusOption("corpus", "Replay the recorded corpus in <dir> instead of a synthetic one.", "dir");
+    const QCommandLineOption opmlOption("opml", "Subscribe to the feeds in <file> (default: every url in the corpus).", "file");
+    const QCommandLineOption feedsOption("feeds", "Number of feeds in the synthetic corpus.", "count", QString::number(kDefaultFeedCount));
+    const QCommandLineOption itemsOption("items", "Number of items in each synthetic feed.", "count", QString::number(kDefaultItemCount));
+    const QCommandLineOption latencyOption("latency", "Delay each response by <msecs>.", "msecs", "0");
+    const QCommandLineOption bandwidthOption("bandwidth", "Deliver each response at <bytes> per second.", "bytes", "0");
+    commandLine.addOptions({corpusOption, opmlOption, feedsOption, itemsOption, latencyOption, bandwidthOption});
+    commandLine.process(app);
+
+    QTemporaryDir workDir;
+    if (!workDir.isValid()) {
+        qCritical() << "could not create a working directory";
+        return 1;
+    }
+
+    const QString corpusDir = commandLine.isSet(corpusOption) ? commandLine.value(corpusOption) : workDir.filePath("corpus");
+    const NetworkCorpus corpus(corpusDir);
+    QString opmlPath = commandLine.value(opmlOption);
+    if (opmlPath.isEmpty()) {
+        const QList<QUrl> urls = commandLine.isSet(corpusOption) ? corpus.urls()
+                                                                 : writeSyntheticCorpus(corpus, commandLine.value(feedsOption).toInt(), commandLine.value(itemsOption).toInt());
+        opmlPath = workDir.filePath("feeds.opml");
+        if (!writeOpml(opmlPath, urls)) {
+            qCritical() << "could not write" << opmlPath;
+            return 1;
+        }
+    }
+
+    auto *replay = new ReplayNetworkAccessManager(corpusDir);
+    replay->setLatency(commandLine.value(latencyOption).toInt());
+    replay->setBandwidth(commandLine.value(bandwidthOption).toLongLong());
+    NetworkAccessManager::setInstance(replay);
+
+    Context context(new SqliteStorage::StorageImpl(workDir.filePath("bench.db")));
+    context.updatePacer()->setWindow(0);
+    waitFor(
+        [&context] {
+            return context.feedListComplete();
+        },
+        kSetupTimeout);
+
+    int addedCount{0};
+    QObject::connect(&context, &Context::feedAdded, &app, [&addedCount] {
+        ++addedCount;
+    });
+    context.importOpml(QUrl::fromLocalFile(opmlPath));
+    QElapsedTimer settleTimer;
+    settleTimer.start();
+    int lastCount{-1};
+    waitFor(
+        [&] {
+            // the import is done when no feeds have been added for a while
+            if (addedCount != lastCount) {
+                lastCount = addedCount;
+                settleTimer.restart();
+            }
+            return addedCount > 0 && settleTimer.hasExpired(1000);
+        },
+        kSetupTimeout);
+
+    bool finished{false};
+    QObject::connect(&context, &Context::refreshFinished, &app, [&finished] {
+        finished = true;
+    });
+    const ResourceUsage before = resourceUsage();
+    QElapsedTimer wallTimer;
+    wallTimer.start();
+    context.requestUpdate();
+    waitFor(
+        [&finished] {
+            return finished;
+        },
+        std::numeric_limits<int>::max());
+    const qint64 wallMsecs = wallTimer.elapsed();
+    const ResourceUsage after = resourceUsage();
+
+    const QJsonObject &stats = context.lastRefreshStats();
+    QTextStream out(stdout);
+    out << "feeds:     " << stats.value("feedCount").toInteger() << " (" << stats.value("failedCount").toInteger() << " failed)\n"
+        << "wall time: " << wallMsecs << " ms\n"
+        << "cpu time:  " << after.cpuMsecs - before.cpuMsecs << " ms\n"
+        << "peak rss:  " << after.peakRssKiB / 1024 << " MiB\n";
+    return 0;
+}
@@ -7,6 +7,7 @@ class MockStorage : public FeedCore::Storage
 {
 public:
     QList<MockFeed *> m_feeds;
+    int m_pendingTasks{0};
 
     QFuture<FeedCore::ArticleRef> getAll() override
     {
@@ -82,4 +83,9 @@ public:
     {
         return getAll();
     }
+
+    int pendingTasks() const override
+    {
+        return m_pendingTasks;
+    }
 };
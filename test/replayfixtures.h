@@ -0,0 +1,70 @@
+#pragma once
+#include "networkreplay.h"
+#include "updatablefeed.h"
+#include <QSignalSpy>
+#include <QtTest>
+
+/**
+ * An UpdatableFeed that records the ids of the articles it is updated with
+ */
+class RecordingFeed : public FeedCore::UpdatableFeed
+{
+public:
+    RecordingFeed()
+        : UpdatableFeed(nullptr)
+    {
+    }
+    QStringList articleIds;
+
+    QFuture<FeedCore::ArticleRef> getArticles(bool /* unreadFilter */) override
+    {
+        return FeedCore::Future::yield<FeedCore::ArticleRef>(this, [](auto & /* op */) {});
+    }
+
+private:
+    QFuture<void> updateSourceArticle(const Syndication::ItemPtr &article) override
+    {
+        articleIds << article->id();
+        return QtFuture::makeReadyVoidFuture();
+    }
+
+    void expire(const QDateTime & /* olderThan */) override
+    {
+    }
+};
+
+/**
+ * Update /feed/ and wait for the update to finish
+ */
+inline void updateFeed(FeedCore::Feed &feed)
+{
+    QSignalSpy statusSpy(&feed, &FeedCore::Feed::statusChanged);
+    feed.updater()->start();
+    QTRY_VERIFY(statusSpy.count() >= 2);
+    QCOMPARE(feed.status(), FeedCore::Feed::Idle);
+}
+
+/**
+ * Save a response for /url/ in the corpus at /directory/
+ */
+inline void addResponse(const QString &directory,
+                        const QUrl &url,
+                        int statusCode,
+                        const QList<QNetworkReply::RawHeaderPair> &headers,
+                        const QByteArray &body = QByteArray())
+{
+    FeedCore::RecordedResponse response;
+    response.url = url;
+    response.statusCode = statusCode;
+    response.headers = headers;
+    response.body = body;
+    QVERIFY(FeedCore::NetworkCorpus(directory).save(url, response));
+}
+
+/**
+ * Save a successful response for the feed at /url/ in the corpus at /directory/
+ */
+inline void addFeed(const QString &directory, const QUrl &url, const QByteArray &body, const QByteArray &contentType = "application/atom+xml")
+{
+    addResponse(directory, url, 200, {{"Content-Type", contentType}}, body);
+}
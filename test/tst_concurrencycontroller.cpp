@@ -0,0 +1,85 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "concurrencycontroller.h"
+#include <QtTest>
+
+using namespace FeedCore;
+
+static constexpr const qint64 kLatency = 100;
+static constexpr const qint64 kBytes = 10000;
+
+class testConcurrencyController : public QObject
+{
+    Q_OBJECT
+
+    // record enough healthy responses to end several windows
+    static void recordHealthy(ConcurrencyController &controller, qint64 &timestamp, int count, bool limited)
+    {
+        for (int i = 0; i < count; ++i) {
+            timestamp += 10;
+            controller.recordResponse(kLatency, kBytes, limited, timestamp);
+        }
+    }
+
+private slots:
+    void testGrowsWhileRequestsWait()
+    {
+        ConcurrencyController controller;
+        qint64 timestamp{0};
+        recordHealthy(controller, timestamp, 200, true);
+        QVERIFY(controller.limit() > ConcurrencyController::kInitialLimit);
+    }
+
+    void testStaysPutWithoutWaitingRequests()
+    {
+        ConcurrencyController controller;
+        qint64 timestamp{0};
+        recordHealthy(controller, timestamp, 200, false);
+        QCOMPARE(controller.limit(), ConcurrencyController::kInitialLimit);
+    }
+
+    void testShrinksOnCongestion()
+    {
+        ConcurrencyController controller;
+        qint64 timestamp{0};
+        for (int i = 0; i < 500; ++i) {
+            controller.recordCongestion(true, ++timestamp);
+        }
+        QCOMPARE(controller.limit(), ConcurrencyController::kDefaultMinimum);
+    }
+
+    void testShrinksWhenLatencyRises()
+    {
+        ConcurrencyController controller;
+        qint64 timestamp{0};
+        recordHealthy(controller, timestamp, 16, false);
+        const int limit = controller.limit();
+        for (int i = 0; i < 16; ++i) {
+            timestamp += 10;
+            controller.recordResponse(kLatency * 5, kBytes, true, timestamp);
+        }
+        QVERIFY(controller.limit() < limit);
+    }
+
+    void testRespectsBounds()
+    {
+        ConcurrencyController controller;
+        controller.setMaximum(10);
+        QCOMPARE(controller.limit(), 10);
+        qint64 timestamp{0};
+        recordHealthy(controller, timestamp, 200, true);
+        QCOMPARE(controller.limit(), 10);
+
+        controller.setMinimum(20);
+        QCOMPARE(controller.minimum(), 20);
+        QCOMPARE(controller.maximum(), 20);
+        QCOMPARE(controller.limit(), 20);
+    }
+};
+
+QTEST_MAIN(testConcurrencyController)
+
+#include "tst_concurrencycontroller.moc"
@@ -0,0 +1,149 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "provisionalfeed.h"
+#include "replayfixtures.h"
+#include <QTemporaryDir>
+
+using namespace FeedCore;
+
+static QByteArray atomFeed(const QStringList &entryIds)
+{
+    QByteArray result(
+        "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+        "<feed xmlns=\"http://www.w3.org/2005/Atom\">"
+        "  <title>Test Feed</title>"
+        "  <id>urn:uuid:60a76c80-d399-11d9-b93C-0003939e0af6</id>"
+        "  <updated>2023-01-01T12:00:00Z</updated>");
+    for (const QString &id : entryIds) {
+        result += QStringLiteral(
+                      "<entry>"
+                      "  <title>%1</title>"
+                      "  <link href=\"https://example.org/%1\"/>"
+                      "  <id>%1</id>"
+                      "  <updated>2023-01-01T12:00:00Z</updated>"
+                      "</entry>")
+                      .arg(id)
+                      .toUtf8();
+    }
+    result += "</feed>";
+    return result;
+}
+
+/*
+ * Serves the "#delta" entry of the corpus to requests that ask for a delta feed, if there is one
+ */
+class DeltaReplayNetworkAccessManager : public ReplayNetworkAccessManager
+{
+public:
+    explicit DeltaReplayNetworkAccessManager(const QString &directory)
+        : ReplayNetworkAccessManager(directory)
+        , m_corpus(directory)
+    {
+    }
+    QList<QByteArray> acceptHeaders;
+
+protected:
+    QNetworkReply *startRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData) override
+    {
+        acceptHeaders << request.rawHeader("A-IM");
+        QUrl deltaUrl = request.url();
+        deltaUrl.setFragment("delta");
+        if (!request.hasRawHeader("A-IM") || !m_corpus.load(deltaUrl)) {
+            return ReplayNetworkAccessManager::startRequest(op, request, outgoingData);
+        }
+        QNetworkRequest deltaRequest(request);
+        deltaRequest.setUrl(deltaUrl);
+        return ReplayNetworkAccessManager::startRequest(op, deltaRequest, outgoingData);
+    }
+
+private:
+    NetworkCorpus m_corpus;
+};
+
+class testDeltaFeed : public QObject
+{
+    Q_OBJECT
+
+    std::unique_ptr<QTemporaryDir> m_dir;
+    QPointer<DeltaReplayNetworkAccessManager> m_nam;
+    const QUrl m_feedUrl{"https://example.org/feed.xml"};
+
+    void addResponse(const QUrl &url, int statusCode, const QByteArray &body)
+    {
+        QList<QNetworkReply::RawHeaderPair> headers = {{"Content-Type", "application/atom+xml"}};
+        if (statusCode == 226) {
+            headers.append({"IM", "feed"});
+        }
+        ::addResponse(m_dir->path(), url, statusCode, headers, body);
+    }
+
+    QUrl deltaUrl() const
+    {
+        QUrl result = m_feedUrl;
+        result.setFragment("delta");
+        return result;
+    }
+
+private slots:
+    void init()
+    {
+        m_dir = std::make_unique<QTemporaryDir>();
+        m_nam = new DeltaReplayNetworkAccessManager(m_dir->path());
+        NetworkAccessManager::setInstance(m_nam.get());
+    }
+
+    void testDeltaFeedIsApplied()
+    {
+        addResponse(m_feedUrl, 200, atomFeed({"old-1", "old-2", "new-1"}));
+        addResponse(deltaUrl(), 226, atomFeed({"new-1"}));
+
+        RecordingFeed feed;
+        feed.setUrl(m_feedUrl);
+        updateFeed(feed);
+        QCOMPARE(m_nam->acceptHeaders, QList<QByteArray>{"feed"});
+        QCOMPARE(feed.articleIds, QStringList{"new-1"});
+        QCOMPARE(feed.updater()->stats().deltaResponses, 1);
+    }
+
+    void testServerThatIgnoresDeltaRequest()
+    {
+        addResponse(m_feedUrl, 200, atomFeed({"old-1", "new-1"}));
+
+        RecordingFeed feed;
+        feed.setUrl(m_feedUrl);
+        updateFeed(feed);
+        QCOMPARE(m_nam->acceptHeaders, QList<QByteArray>{"feed"});
+        QCOMPARE(feed.articleIds, QStringList({"old-1", "new-1"}));
+    }
+
+    void testUnusableDeltaFallsBackToWholeFeed()
+    {
+        addResponse(m_feedUrl, 200, atomFeed({"old-1", "new-1"}));
+        addResponse(deltaUrl(), 226, "not a feed");
+
+        RecordingFeed feed;
+        feed.setUrl(m_feedUrl);
+        updateFeed(feed);
+        QCOMPARE(m_nam->acceptHeaders, QList<QByteArray>({"feed", QByteArray()}));
+        QCOMPARE(feed.articleIds, QStringList({"old-1", "new-1"}));
+        QCOMPARE(feed.flags() & Feed::IsWebPageFlag, 0);
+    }
+
+    void testPreviewDoesNotAskForDelta()
+    {
+        addResponse(m_feedUrl, 200, atomFeed({"old-1", "new-1"}));
+        addResponse(deltaUrl(), 226, atomFeed({"new-1"}));
+
+        ProvisionalFeed feed;
+        feed.setUrl(m_feedUrl);
+        updateFeed(feed);
+        QCOMPARE(m_nam->acceptHeaders, QList<QByteArray>{QByteArray()});
+        QCOMPARE(feed.unreadCount(), 2);
+    }
+};
+
+QTEST_MAIN(testDeltaFeed)
+#include "tst_deltafeed.moc"
@@ -0,0 +1,79 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "articlelinkextractor.h"
+#include "htmldecoder.h"
+#include <QtTest>
+
+using namespace FeedCore;
+
+class testHtmlDecoder : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testCharset_data()
+    {
+        QTest::addColumn<QByteArray>("html");
+        QTest::addColumn<QByteArray>("contentType");
+        QTest::addColumn<QByteArray>("expected");
+
+        QTest::newRow("undeclared") << QByteArray("<html><body>text</body></html>") << QByteArray() << QByteArray();
+        QTest::newRow("header") << QByteArray("<html></html>") << QByteArray("text/html; charset=ISO-8859-1") << QByteArray("iso-8859-1");
+        QTest::newRow("quoted header") << QByteArray("<html></html>") << QByteArray("text/html; charset=\"Shift_JIS\"") << QByteArray("shift_jis");
+        QTest::newRow("meta charset") << QByteArray("<html><head><meta charset=\"windows-1252\">") << QByteArray("text/html") << QByteArray("windows-1252");
+        QTest::newRow("meta http-equiv") << QByteArray("<head><META HTTP-EQUIV=\"Content-Type\" CONTENT=\"text/html; charset=koi8-r\">")
+                                         << QByteArray() << QByteArray("koi8-r");
+        QTest::newRow("header wins") << QByteArray("<meta charset=\"windows-1252\">") << QByteArray("text/html; charset=utf-8") << QByteArray("utf-8");
+        QTest::newRow("bom wins") << QByteArray("\xEF\xBB\xBF<meta charset=\"windows-1252\">") << QByteArray("text/html; charset=koi8-r")
+                                  << QByteArray("utf-8");
+        QTest::newRow("meta utf-16") << QByteArray("<meta charset=\"utf-16\">") << QByteArray() << QByteArray("utf-8");
+        QTest::newRow("meta too late") << QByteArray(2000, ' ') + QByteArray("<meta charset=\"koi8-r\">") << QByteArray() << QByteArray();
+    }
+
+    void testCharset()
+    {
+        QFETCH(QByteArray, html);
+        QFETCH(QByteArray, contentType);
+        QFETCH(QByteArray, expected);
+        QCOMPARE(HtmlDecoder::charset(html, contentType), expected);
+    }
+
+    void testUtf8IsNotCopied()
+    {
+        const QByteArray html("<html><body>caf\xC3\xA9</body></html>");
+        const QByteArray &result = HtmlDecoder::toUtf8(html, "text/html; charset=utf-8");
+        QCOMPARE(result.constData(), html.constData());
+        QCOMPARE(HtmlDecoder::toString(html), QString::fromUtf8(html));
+    }
+
+    void testBomIsRemoved()
+    {
+        QCOMPARE(HtmlDecoder::toUtf8("\xEF\xBB\xBF<p>text</p>"), QByteArray("<p>text</p>"));
+        QCOMPARE(HtmlDecoder::toString("\xEF\xBB\xBF<p>text</p>"), QStringLiteral("<p>text</p>"));
+    }
+
+    void testLatin1IsDecoded()
+    {
+        const QByteArray html("<html><head><meta charset=\"iso-8859-1\"></head><body>caf\xE9</body></html>");
+        QVERIFY(HtmlDecoder::toString(html).contains(QStringLiteral("café")));
+        QVERIFY(HtmlDecoder::toUtf8(html).contains("caf\xC3\xA9"));
+    }
+
+    void testLinkTitlesAreDecoded()
+    {
+        const QByteArray html(
+            "<html><head><meta charset=\"windows-1252\"></head><body>"
+            "<a href=\"/2024/01/02/article\">Caf\xE9 opens</a>"
+            "</body></html>");
+        ArticleLinkExtractor extractor(HtmlDecoder::toUtf8(html), QUrl("https://example.com/"));
+        extractor.walk();
+        const auto &links = extractor.articleLinks();
+        QCOMPARE(links.size(), 1);
+        QCOMPARE(links[0].linkText, QStringLiteral("Café opens"));
+    }
+};
+
+QTEST_MAIN(testHtmlDecoder)
+#include "tst_htmldecoder.moc"
@@ -0,0 +1,170 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "networkreplay.h"
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest>
+
+using namespace FeedCore;
+
+// more than enough requests to fill every connection slot
+static constexpr const int kRequestCount = 200;
+
+// counts the requests that actually reach the (replayed) network
+class CountingNetworkAccessManager : public ReplayNetworkAccessManager
+{
+public:
+    using ReplayNetworkAccessManager::ReplayNetworkAccessManager;
+    int startCount{0};
+
+protected:
+    QNetworkReply *startRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData) override
+    {
+        startCount++;
+        return ReplayNetworkAccessManager::startRequest(op, request, outgoingData);
+    }
+};
+
+class testNetworkAccessManager : public QObject
+{
+    Q_OBJECT
+
+    std::unique_ptr<QTemporaryDir> m_dir;
+    std::unique_ptr<CountingNetworkAccessManager> m_nam;
+
+    static QUrl urlForIndex(int i)
+    {
+        return QUrl(QStringLiteral("https://example.com/%1").arg(i));
+    }
+
+private slots:
+    void init()
+    {
+        m_dir = std::make_unique<QTemporaryDir>();
+        const NetworkCorpus corpus(m_dir->path());
+        for (int i = 0; i < kRequestCount; ++i) {
+            RecordedResponse response;
+            response.url = urlForIndex(i);
+            response.statusCode = 200;
+            response.headers = {{"X-Index", QByteArray::number(i)}};
+            response.body = QByteArray::number(i);
+            corpus.save(response.url, response);
+        }
+        m_nam = std::make_unique<CountingNetworkAccessManager>(m_dir->path());
+        m_nam->setLatency(10);
+    }
+
+    void cleanup()
+    {
+        m_nam.reset();
+    }
+
+    void testDeferredRepliesForwardResponse()
+    {
+        QList<QNetworkReply *> replies;
+        for (int i = 0; i < kRequestCount; ++i) {
+            replies << m_nam->get(QNetworkRequest(urlForIndex(i)));
+        }
+        QSignalSpy lastFinished(replies.last(), &QNetworkReply::finished);
+        QSignalSpy lastMetaData(replies.last(), &QNetworkReply::metaDataChanged);
+        QVERIFY(lastFinished.wait());
+        QVERIFY(!lastMetaData.isEmpty());
+        QCOMPARE(replies.last()->rawHeader("X-Index"), QByteArray::number(kRequestCount - 1));
+        QCOMPARE(replies.last()->readAll(), QByteArray::number(kRequestCount - 1));
+        qDeleteAll(replies);
+    }
+
+    void testWhenStartedHandsOffRealReply()
+    {
+        QList<QNetworkReply *> replies;
+        for (int i = 0; i < kRequestCount; ++i) {
+            replies << m_nam->get(QNetworkRequest(urlForIndex(i)));
+        }
+        QNetworkReply *deferred = replies.takeLast();
+        QPointer<QNetworkReply> deferredPointer(deferred);
+        QNetworkReply *started{nullptr};
+        NetworkAccessManager::whenStarted(deferred, this, [&started](QNetworkReply *reply) {
+            started = reply;
+        });
+        QTRY_VERIFY(started != nullptr);
+        QVERIFY(started != deferred);
+        QSignalSpy finished(started, &QNetworkReply::finished);
+        QVERIFY(finished.wait());
+        QCOMPARE(started->readAll(), QByteArray::number(kRequestCount - 1));
+        QTRY_VERIFY(deferredPointer.isNull());
+        delete started;
+        qDeleteAll(replies);
+    }
+
+    void testWhenStartedReportsAbortBeforeStart()
+    {
+        QList<QNetworkReply *> replies;
+        for (int i = 0; i < kRequestCount; ++i) {
+            replies << m_nam->get(QNetworkRequest(urlForIndex(i)));
+        }
+        QNetworkReply *deferred = replies.last();
+        QNetworkReply *started{nullptr};
+        NetworkAccessManager::whenStarted(deferred, this, [&started](QNetworkReply *reply) {
+            started = reply;
+        });
+        QSignalSpy finished(deferred, &QNetworkReply::finished);
+        deferred->abort();
+        QCOMPARE(started, deferred);
+        QCOMPARE(finished.size(), 1);
+        QCOMPARE(deferred->error(), QNetworkReply::OperationCanceledError);
+        qDeleteAll(replies);
+    }
+
+    void testWhenStartedWithImmediateReply()
+    {
+        QNetworkReply *reply = m_nam->get(QNetworkRequest(urlForIndex(0)));
+        QNetworkReply *started{nullptr};
+        NetworkAccessManager::whenStarted(reply, this, [&started](QNetworkReply *startedReply) {
+            started = startedReply;
+        });
+        QCOMPARE(started, reply);
+        delete reply;
+    }
+
+    void testIdenticalRequestsShareOneReply()
+    {
+        std::unique_ptr<QNetworkReply> first(m_nam->get(QNetworkRequest(urlForIndex(1))));
+        std::unique_ptr<QNetworkReply> second(m_nam->get(QNetworkRequest(urlForIndex(1))));
+        QSignalSpy firstFinished(first.get(), &QNetworkReply::finished);
+        QSignalSpy secondFinished(second.get(), &QNetworkReply::finished);
+        QTRY_VERIFY(!firstFinished.isEmpty() && !secondFinished.isEmpty());
+        QCOMPARE(m_nam->startCount, 1);
+        QCOMPARE(second->rawHeader("X-Index"), QByteArray("1"));
+        QCOMPARE(second->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 200);
+        QCOMPARE(first->readAll(), QByteArray("1"));
+        QCOMPARE(second->readAll(), QByteArray("1"));
+    }
+
+    void testDifferentHeadersDontShare()
+    {
+        QNetworkRequest htmlRequest(urlForIndex(1));
+        htmlRequest.setRawHeader("Accept", "text/html");
+        std::unique_ptr<QNetworkReply> first(m_nam->get(QNetworkRequest(urlForIndex(1))));
+        std::unique_ptr<QNetworkReply> second(m_nam->get(htmlRequest));
+        QCOMPARE(m_nam->startCount, 2);
+    }
+
+    void testAbortedLeaderDoesNotCancelFollowers()
+    {
+        std::unique_ptr<QNetworkReply> first(m_nam->get(QNetworkRequest(urlForIndex(1))));
+        std::unique_ptr<QNetworkReply> second(m_nam->get(QNetworkRequest(urlForIndex(1))));
+        QSignalSpy secondFinished(second.get(), &QNetworkReply::finished);
+        first->abort();
+        QCOMPARE(first->error(), QNetworkReply::OperationCanceledError);
+        QVERIFY(secondFinished.wait());
+        QCOMPARE(second->error(), QNetworkReply::NoError);
+        QCOMPARE(second->readAll(), QByteArray("1"));
+    }
+};
+
+QTEST_MAIN(testNetworkAccessManager)
+
+#include "tst_networkaccessmanager.moc"
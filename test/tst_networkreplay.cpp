@@ -0,0 +1,93 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "networkreplay.h"
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QtTest>
+
+using namespace FeedCore;
+
+class testNetworkReplay : public QObject
+{
+    Q_OBJECT
+
+    std::unique_ptr<QTemporaryDir> m_dir;
+
+    QNetworkReply *get(ReplayNetworkAccessManager &nam, const QUrl &url)
+    {
+        QNetworkReply *reply = nam.get(QNetworkRequest(url));
+        QSignalSpy finished(reply, &QNetworkReply::finished);
+        if (!finished.wait()) {
+            qCritical() << "reply did not finish";
+        }
+        return reply;
+    }
+
+private slots:
+    void init()
+    {
+        m_dir = std::make_unique<QTemporaryDir>();
+    }
+
+    void testReplayServesRecordedResponse()
+    {
+        const QUrl requestUrl("https://example.com/feed");
+        const QUrl finalUrl("https://example.com/feed.xml");
+        RecordedResponse response;
+        response.url = finalUrl;
+        response.statusCode = 200;
+        response.headers = {{"Content-Type", "application/atom+xml"}, {"ETag", "\"\xe9t\xe9\""}};
+        response.body = "<feed/>";
+        QVERIFY(NetworkCorpus(m_dir->path()).save(requestUrl, response));
+        QCOMPARE(NetworkCorpus(m_dir->path()).urls(), QList<QUrl>{requestUrl});
+
+        ReplayNetworkAccessManager nam(m_dir->path());
+        std::unique_ptr<QNetworkReply> reply(get(nam, requestUrl));
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QCOMPARE(reply->url(), finalUrl);
+        QCOMPARE(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 200);
+        QCOMPARE(reply->rawHeader("ETag"), QByteArray("\"\xe9t\xe9\""));
+        QCOMPARE(reply->readAll(), QByteArray("<feed/>"));
+    }
+
+    void testMissingUrlFails()
+    {
+        ReplayNetworkAccessManager nam(m_dir->path());
+        std::unique_ptr<QNetworkReply> reply(get(nam, QUrl("https://example.com/missing")));
+        QCOMPARE(reply->error(), QNetworkReply::ContentNotFoundError);
+        QCOMPARE(reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt(), 404);
+    }
+
+    void testLatencyAndBandwidth()
+    {
+        const QUrl url("https://example.com/feed.xml");
+        RecordedResponse response;
+        response.url = url;
+        response.statusCode = 200;
+        response.body = QByteArray(1000, 'x');
+        QVERIFY(NetworkCorpus(m_dir->path()).save(url, response));
+
+        ReplayNetworkAccessManager nam(m_dir->path());
+        nam.setLatency(50);
+        nam.setBandwidth(10000);
+        QElapsedTimer timer;
+        timer.start();
+        std::unique_ptr<QNetworkReply> reply(nam.get(QNetworkRequest(url)));
+        QSignalSpy readyRead(reply.get(), &QIODevice::readyRead);
+        QSignalSpy finished(reply.get(), &QNetworkReply::finished);
+        QVERIFY(finished.wait());
+
+        // 50ms of latency plus 1000 bytes at 10000 bytes/sec
+        QVERIFY(timer.elapsed() >= 150);
+        QVERIFY(readyRead.size() > 1);
+        QCOMPARE(reply->readAll(), response.body);
+    }
+};
+
+QTEST_MAIN(testNetworkReplay)
+
+#include "tst_networkreplay.moc"
@@ -0,0 +1,145 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "provisionalfeed.h"
+#include "replayfixtures.h"
+#include <QTemporaryDir>
+
+using namespace FeedCore;
+
+static const QByteArray kAtomFeed(
+    "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+    "<feed xmlns=\"http://www.w3.org/2005/Atom\">"
+    "  <title>Test Feed</title>"
+    "  <id>urn:uuid:60a76c80-d399-11d9-b93C-0003939e0af6</id>"
+    "  <updated>2023-01-01T12:00:00Z</updated>"
+    "  <entry>"
+    "    <title>Sample Article</title>"
+    "    <link href=\"https://example.org/article\"/>"
+    "    <id>article-id</id>"
+    "    <updated>2023-01-01T12:00:00Z</updated>"
+    "  </entry>"
+    "</feed>");
+
+class CountingReplayNetworkAccessManager : public ReplayNetworkAccessManager
+{
+public:
+    using ReplayNetworkAccessManager::ReplayNetworkAccessManager;
+    QHash<QUrl, int> requestCounts;
+
+protected:
+    QNetworkReply *startRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData) override
+    {
+        requestCounts[request.url()]++;
+        return ReplayNetworkAccessManager::startRequest(op, request, outgoingData);
+    }
+};
+
+class testPermanentRedirect : public QObject
+{
+    Q_OBJECT
+
+    std::unique_ptr<QTemporaryDir> m_dir;
+    QPointer<CountingReplayNetworkAccessManager> m_nam;
+
+    void addRedirect(const QUrl &from, const QUrl &to, int statusCode, const QByteArray &cacheControl = QByteArray())
+    {
+        QList<QNetworkReply::RawHeaderPair> headers = {{"Location", to.toEncoded()}};
+        if (!cacheControl.isEmpty()) {
+            headers.append({"Cache-Control", cacheControl});
+        }
+        addResponse(m_dir->path(), from, statusCode, headers);
+    }
+
+private slots:
+    void init()
+    {
+        m_dir = std::make_unique<QTemporaryDir>();
+        m_nam = new CountingReplayNetworkAccessManager(m_dir->path());
+        NetworkAccessManager::setInstance(m_nam.get());
+        UpdatableFeed::setPermanentRedirectThreshold(2);
+    }
+
+    void cleanup()
+    {
+        // the instance owns the network access manager, so this deletes it
+        NetworkAccessManager::setInstance(nullptr);
+        UpdatableFeed::setPermanentRedirectThreshold(UpdatableFeed::kDefaultPermanentRedirectThreshold);
+    }
+
+    void testUrlChangesAfterConsistentPermanentRedirects()
+    {
+        const QUrl oldUrl("https://old.example/feed");
+        const QUrl newUrl("https://new.example/feed");
+        addRedirect(oldUrl, newUrl, 301);
+        addFeed(m_dir->path(), newUrl, kAtomFeed);
+
+        ProvisionalFeed feed;
+        feed.setUrl(oldUrl);
+        updateFeed(feed);
+        QCOMPARE(feed.url(), oldUrl);
+        QCOMPARE(feed.redirectUrl(), newUrl);
+        QCOMPARE(feed.redirectCount(), 1);
+
+        updateFeed(feed);
+        QCOMPARE(feed.url(), newUrl);
+        QCOMPARE(feed.redirectCount(), 0);
+
+        updateFeed(feed);
+        QCOMPARE(m_nam->requestCounts.value(oldUrl), 2);
+        QCOMPARE(m_nam->requestCounts.value(newUrl), 3);
+    }
+
+    void testChainStopsLearningAtTemporaryRedirect()
+    {
+        const QUrl oldUrl("https://chain.example/feed");
+        const QUrl movedUrl("https://chain.example/moved");
+        const QUrl mirrorUrl("https://mirror.example/feed");
+        addRedirect(oldUrl, movedUrl, 308);
+        addRedirect(movedUrl, mirrorUrl, 302);
+        addFeed(m_dir->path(), mirrorUrl, kAtomFeed);
+
+        ProvisionalFeed feed;
+        feed.setUrl(oldUrl);
+        updateFeed(feed);
+        updateFeed(feed);
+        QCOMPARE(feed.url(), movedUrl);
+    }
+
+    void testTemporaryRedirectIsCachedForItsLifetime()
+    {
+        const QUrl feedUrl("https://temporary.example/feed");
+        const QUrl targetUrl("https://temporary.example/today");
+        addRedirect(feedUrl, targetUrl, 307, "max-age=3600");
+        addFeed(m_dir->path(), targetUrl, kAtomFeed);
+
+        ProvisionalFeed feed;
+        feed.setUrl(feedUrl);
+        updateFeed(feed);
+        updateFeed(feed);
+        QCOMPARE(feed.url(), feedUrl);
+        QCOMPARE(feed.redirectCount(), 0);
+        QCOMPARE(m_nam->requestCounts.value(feedUrl), 1);
+        QCOMPARE(m_nam->requestCounts.value(targetUrl), 2);
+    }
+
+    void testUncacheableTemporaryRedirectIsFollowedEveryTime()
+    {
+        const QUrl feedUrl("https://uncached.example/feed");
+        const QUrl targetUrl("https://uncached.example/today");
+        addRedirect(feedUrl, targetUrl, 302);
+        addFeed(m_dir->path(), targetUrl, kAtomFeed);
+
+        ProvisionalFeed feed;
+        feed.setUrl(feedUrl);
+        updateFeed(feed);
+        updateFeed(feed);
+        QCOMPARE(feed.url(), feedUrl);
+        QCOMPARE(m_nam->requestCounts.value(feedUrl), 2);
+    }
+};
+
+QTEST_MAIN(testPermanentRedirect)
+#include "tst_permanentredirect.moc"
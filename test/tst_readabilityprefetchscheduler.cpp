@@ -0,0 +1,184 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "mockarticle.h"
+#include "mockfeed.h"
+#include "readability/readability.h"
+#include "readability/readabilityprefetchscheduler.h"
+#include "readability/readabilityresult.h"
+#include "readability/readablecontentcache.h"
+#include <QStandardPaths>
+#include <QtTest>
+
+using namespace FeedCore;
+
+class TestResult : public ReadabilityResult
+{
+public:
+    using ReadabilityResult::ReadabilityResult;
+
+    void finish(qint64 bytes, qint64 parseMsecs)
+    {
+        m_bytes = bytes;
+        m_parseMsecs = parseMsecs;
+        emit finished("<p>readable</p>");
+        deleteLater();
+    }
+};
+
+class TestReadability : public Readability
+{
+public:
+    QList<QUrl> fetched;
+    QList<QPointer<TestResult>> results;
+
+    ReadabilityResult *fetch(const QUrl &url, Priority priority) override
+    {
+        Q_UNUSED(priority);
+        fetched << url;
+        auto *result = new TestResult(this);
+        results << result;
+        return result;
+    }
+};
+
+class TestFeed : public MockFeed
+{
+public:
+    using Feed::setStatus;
+
+    TestFeed()
+    {
+        setFlags(UseReadableContentFlag);
+    }
+};
+
+class TestArticle : public MockArticle
+{
+public:
+    TestArticle(Feed *feed, const QUrl &url, const QDateTime &date)
+        : MockArticle(feed)
+    {
+        setUrl(url);
+        setDate(date);
+    }
+};
+
+class testReadabilityPrefetchScheduler : public QObject
+{
+    Q_OBJECT
+    QSharedPointer<TestFeed> m_monitor;
+    QScopedPointer<TestFeed> m_feed1;
+    QScopedPointer<TestFeed> m_feed2;
+    QScopedPointer<TestReadability> m_readability;
+    QScopedPointer<ReadabilityPrefetchScheduler> m_scheduler;
+
+    ArticleRef makeArticle(Feed *feed, const QString &url, int age = 0)
+    {
+        return ArticleRef(new TestArticle(feed, QUrl(url), QDateTime::currentDateTime().addSecs(-age)));
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+    }
+
+    void init()
+    {
+        ReadableContentCache::clear().waitForFinished();
+        m_monitor.reset(new TestFeed);
+        m_feed1.reset(new TestFeed);
+        m_feed2.reset(new TestFeed);
+        m_readability.reset(new TestReadability);
+        m_scheduler.reset(new ReadabilityPrefetchScheduler(m_readability.get(), m_monitor));
+        m_scheduler->setSettleDelay(0);
+    }
+
+    void cleanup()
+    {
+        m_scheduler.reset();
+        m_readability.reset();
+    }
+
+    void testWaitsForUpdatesToSettle()
+    {
+        m_scheduler->setSettleDelay(50);
+        m_monitor->setStatus(Feed::Updating);
+        m_scheduler->enqueue(makeArticle(m_feed1.get(), "https://example.com/a"));
+        QTest::qWait(100);
+        QVERIFY(m_readability->fetched.isEmpty());
+
+        m_monitor->setStatus(Feed::Idle);
+        QVERIFY(m_readability->fetched.isEmpty());
+        QTRY_COMPARE(m_readability->fetched.size(), 1);
+        QCOMPARE(m_scheduler->pendingCount(), 0);
+    }
+
+    void testPrefersOpenedFeeds()
+    {
+        m_monitor->setStatus(Feed::Updating);
+        m_scheduler->enqueue(makeArticle(m_feed1.get(), "https://example.com/new", 0));
+        m_scheduler->enqueue(makeArticle(m_feed1.get(), "https://example.com/old", 60));
+        m_scheduler->enqueue(makeArticle(m_feed2.get(), "https://example.com/opened", 120));
+        m_scheduler->noteFeedOpened(m_feed2.get());
+        m_monitor->setStatus(Feed::Idle);
+
+        QTRY_COMPARE(m_readability->fetched.size(), 2);
+        QCOMPARE(m_readability->fetched[0], QUrl("https://example.com/opened"));
+        QCOMPARE(m_readability->fetched[1], QUrl("https://example.com/new"));
+        QCOMPARE(m_scheduler->pendingCount(), 1);
+
+        m_readability->results[0]->finish(100, 10);
+        QTRY_COMPARE(m_readability->fetched.size(), 3);
+        QCOMPARE(m_readability->fetched[2], QUrl("https://example.com/old"));
+    }
+
+    void testSkipsReadArticles()
+    {
+        const ArticleRef &read = makeArticle(m_feed1.get(), "https://example.com/read");
+        read->setRead(true);
+        m_scheduler->enqueue(read);
+        m_scheduler->enqueue(makeArticle(m_feed1.get(), "https://example.com/unread", 60));
+        QTRY_COMPARE(m_readability->fetched.size(), 1);
+        QCOMPARE(m_readability->fetched[0], QUrl("https://example.com/unread"));
+        QCOMPARE(m_scheduler->pendingCount(), 0);
+    }
+
+    void testStopsWhenOverBudget()
+    {
+        m_scheduler->setMaxBytesPerHour(1000);
+        m_scheduler->enqueue(makeArticle(m_feed1.get(), "https://example.com/large"));
+        QTRY_COMPARE(m_readability->fetched.size(), 1);
+        m_readability->results[0]->finish(2000, 10);
+
+        m_scheduler->enqueue(makeArticle(m_feed1.get(), "https://example.com/next"));
+        QTest::qWait(50);
+        QCOMPARE(m_readability->fetched.size(), 1);
+        QCOMPARE(m_scheduler->pendingCount(), 1);
+        QCOMPARE(m_scheduler->bytesInLastHour(), 2000);
+        QCOMPARE(m_scheduler->parseMsecsInLastHour(), 10);
+
+        m_scheduler->setMaxBytesPerHour(10000);
+        QTRY_COMPARE(m_readability->fetched.size(), 2);
+    }
+
+    void testUsesCachedContent()
+    {
+        ReadableContentCache::Entry entry;
+        entry.url = QUrl("https://example.com/cached");
+        entry.fetched = QDateTime::currentDateTime();
+        entry.content = "<p>cached</p>";
+        ReadableContentCache::insert(entry);
+
+        QSignalSpy prefetched(m_scheduler.get(), &ReadabilityPrefetchScheduler::prefetched);
+        m_scheduler->enqueue(makeArticle(m_feed1.get(), "https://example.com/cached"));
+        QTRY_COMPARE(prefetched.count(), 1);
+        QVERIFY(m_readability->fetched.isEmpty());
+    }
+};
+
+QTEST_MAIN(testReadabilityPrefetchScheduler)
+#include "tst_readabilityprefetchscheduler.moc"
@@ -0,0 +1,115 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "readability/readablecontentcache.h"
+#include <QStandardPaths>
+#include <QtTest>
+
+using namespace FeedCore;
+
+static ReadableContentCache::Entry makeEntry(const QUrl &url, const QString &content)
+{
+    ReadableContentCache::Entry entry;
+    entry.url = url;
+    entry.fetched = QDateTime::currentDateTime();
+    entry.etag = "\"abc\"";
+    entry.content = content;
+    return entry;
+}
+
+class testReadableContentCache : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+    }
+
+    void init()
+    {
+        ReadableContentCache::clear().waitForFinished();
+        ReadableContentCache::setMaximumCacheSize(ReadableContentCache::kDefaultMaximumCacheSize);
+    }
+
+    void testRoundTrip()
+    {
+        const QUrl url("https://example.com/article");
+        ReadableContentCache::insert(makeEntry(url, "<p>Readable</p>")).waitForFinished();
+        const auto &entry = ReadableContentCache::lookup(url).result();
+        QVERIFY(entry.isFresh());
+        QCOMPARE(entry.content, QStringLiteral("<p>Readable</p>"));
+        QCOMPARE(entry.etag, QByteArray("\"abc\""));
+
+        QVERIFY(ReadableContentCache::remove(url));
+        QVERIFY(!ReadableContentCache::lookup(url).result().isValid());
+    }
+
+    void testEquivalentUrlsShareEntry()
+    {
+        ReadableContentCache::insert(makeEntry(QUrl("https://example.com:443/a/../article?id=1&utm_source=feed#comments"), "content"));
+        QCOMPARE(ReadableContentCache::lookup(QUrl("https://example.com/article?id=1")).result().content, QStringLiteral("content"));
+        QVERIFY(!ReadableContentCache::lookup(QUrl("https://example.com/article?id=2")).result().isValid());
+    }
+
+    void testOldEntryIsStale()
+    {
+        const QUrl url("https://example.com/old");
+        auto entry = makeEntry(url, "content");
+        entry.fetched = QDateTime::currentDateTime().addDays(-ReadableContentCache::kMaxAgeDays - 1);
+        ReadableContentCache::insert(entry);
+        QVERIFY(ReadableContentCache::lookup(url).result().isValid());
+        QVERIFY(!ReadableContentCache::lookup(url).result().isFresh());
+    }
+
+    void testValidatorsDoNotIncludeContent()
+    {
+        const QUrl url("https://example.com/article");
+        ReadableContentCache::insert(makeEntry(url, "<p>Readable</p>")).waitForFinished();
+        const auto &validators = ReadableContentCache::validators(url).result();
+        QVERIFY(validators.isValid());
+        QCOMPARE(validators.etag, QByteArray("\"abc\""));
+        QVERIFY(validators.content.isEmpty());
+    }
+
+    void testRevalidateKeepsContent()
+    {
+        const QUrl url("https://example.com/old");
+        auto entry = makeEntry(url, "content");
+        entry.fetched = QDateTime::currentDateTime().addDays(-ReadableContentCache::kMaxAgeDays - 1);
+        ReadableContentCache::insert(entry);
+
+        entry.fetched = QDateTime::currentDateTime();
+        entry.content.clear();
+        ReadableContentCache::revalidate(entry);
+        const auto &revalidated = ReadableContentCache::lookup(url).result();
+        QVERIFY(revalidated.isFresh());
+        QCOMPARE(revalidated.content, QStringLiteral("content"));
+    }
+
+    void testLeastRecentlyUsedIsEvicted()
+    {
+        // random text, so that it doesn't compress away
+        QString content;
+        for (int i = 0; i < 1000; ++i) {
+            content += QChar('a' + QRandomGenerator::global()->bounded(26));
+        }
+        ReadableContentCache::setMaximumCacheSize(10000);
+        for (int i = 0; i < 20; ++i) {
+            const QUrl url(QStringLiteral("https://example.com/%1").arg(i));
+            ReadableContentCache::insert(makeEntry(url, content));
+
+            // the store orders accesses even within the same millisecond, so /0 stays the most recently used
+            ReadableContentCache::lookup(QUrl("https://example.com/0")).waitForFinished();
+        }
+        QVERIFY(ReadableContentCache::cacheSize() <= 10000);
+        QVERIFY(ReadableContentCache::lookup(QUrl("https://example.com/0")).result().isValid());
+        QVERIFY(!ReadableContentCache::lookup(QUrl("https://example.com/1")).result().isValid());
+        QVERIFY(ReadableContentCache::lookup(QUrl("https://example.com/19")).result().isValid());
+    }
+};
+
+QTEST_MAIN(testReadableContentCache)
+#include "tst_readablecontentcache.moc"
@@ -0,0 +1,70 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "context.h"
+#include "mockstorage.h"
+#include "updatepacer.h"
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QSignalSpy>
+#include <QtTest>
+using namespace FeedCore;
+
+class testRefreshStats : public QObject
+{
+    Q_OBJECT
+    QPointer<MockStorage> m_mockStorage;
+    QScopedPointer<MockFeed> m_mockFeed1;
+    QScopedPointer<MockFeed> m_mockFeed2;
+    QScopedPointer<FeedCore::Context> m_context;
+
+private slots:
+    void init()
+    {
+        m_mockFeed1.reset(new MockFeed);
+        m_mockFeed2.reset(new MockFeed);
+        m_mockStorage = new MockStorage;
+        m_mockStorage->m_feeds = {m_mockFeed1.get(), m_mockFeed2.get()};
+        m_context.reset(new Context(m_mockStorage));
+        m_context->updatePacer()->setWindow(0);
+
+        if (!QTest::qWaitFor([this] {
+                return m_context->feedListComplete();
+            })) {
+            qCritical() << "Feed list did not complete";
+        }
+    }
+
+    void cleanup()
+    {
+        m_context.reset();
+        m_mockFeed1.reset();
+        m_mockFeed2.reset();
+    }
+
+    void testRefreshStatsCoverAllFeeds()
+    {
+        QSignalSpy refreshFinished(m_context.get(), &FeedCore::Context::refreshFinished);
+        m_context->requestUpdate();
+        QVERIFY(QTest::qWaitFor([this] {
+            return m_mockFeed1->m_updater.m_call_count == 1 && m_mockFeed2->m_updater.m_call_count == 1;
+        }));
+
+        m_mockFeed1->m_updater.finish();
+        QVERIFY(refreshFinished.isEmpty());
+        QVERIFY(m_mockFeed1->updater()->stats().succeeded);
+        m_mockFeed2->m_updater.setError("error");
+        QVERIFY(refreshFinished.length() == 1);
+
+        const QJsonObject &stats = m_context->lastRefreshStats();
+        QVERIFY(stats.value("feedCount").toInt() == 2);
+        QVERIFY(stats.value("failedCount").toInt() == 1);
+        QVERIFY(stats.value("feeds").toArray().size() == 2);
+    }
+};
+
+QTEST_MAIN(testRefreshStats)
+
+#include "tst_refreshstats.moc"
@@ -0,0 +1,113 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "sharedcache.h"
+#include <QStandardPaths>
+#include <QtTest>
+#include <memory>
+
+static QNetworkCacheMetaData makeMetaData(const QUrl &url)
+{
+    QNetworkCacheMetaData metaData;
+    metaData.setUrl(url);
+    metaData.setSaveToDisk(true);
+    metaData.setRawHeaders({{"Content-Type", "text/plain"}});
+    return metaData;
+}
+
+static void store(FeedCore::SharedCache &cache, const QUrl &url, const QByteArray &payload)
+{
+    QIODevice *device = cache.prepare(makeMetaData(url));
+    QVERIFY(device != nullptr);
+    device->write(payload);
+    cache.insert(device);
+}
+
+static QByteArray load(FeedCore::SharedCache &cache, const QUrl &url)
+{
+    std::unique_ptr<QIODevice> device(cache.data(url));
+    return device ? device->readAll() : QByteArray();
+}
+
+class testSharedCache : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled(true);
+    }
+
+    void init()
+    {
+        FeedCore::SharedCache().clear();
+        FeedCore::SharedCache::setMaximumCacheSize(FeedCore::SharedCache::kDefaultMaximumCacheSize);
+    }
+
+    void testSharedBetweenInstances()
+    {
+        const QUrl url("https://example.com/feed.xml");
+        FeedCore::SharedCache writer;
+        FeedCore::SharedCache reader;
+        store(writer, url, "payload");
+        QCOMPARE(reader.metaData(url).url(), url);
+        QCOMPARE(load(reader, url), QByteArray("payload"));
+        QVERIFY(reader.cacheSize() > 0);
+
+        QVERIFY(reader.remove(url));
+        QVERIFY(!writer.metaData(url).isValid());
+        QVERIFY(writer.data(url) == nullptr);
+    }
+
+    void testUpdateMetaDataKeepsPayload()
+    {
+        const QUrl url("https://example.com/feed.xml");
+        FeedCore::SharedCache cache;
+        store(cache, url, "payload");
+        QNetworkCacheMetaData metaData = makeMetaData(url);
+        metaData.setRawHeaders({{"ETag", "\"abc\""}});
+        cache.updateMetaData(metaData);
+        QCOMPARE(cache.metaData(url).rawHeaders(), metaData.rawHeaders());
+        QCOMPARE(load(cache, url), QByteArray("payload"));
+    }
+
+    void testDataIsReadFromDisk()
+    {
+        const QUrl url("https://example.com/feed.xml");
+        FeedCore::SharedCache cache;
+        store(cache, url, "payload");
+        std::unique_ptr<QIODevice> device(cache.data(url));
+        QVERIFY(qobject_cast<QFile *>(device.get()) != nullptr);
+        QCOMPARE(device->readAll(), QByteArray("payload"));
+    }
+
+    void testLeastRecentlyUsedIsEvicted()
+    {
+        const QByteArray payload(1000, 'x');
+        FeedCore::SharedCache cache;
+        FeedCore::SharedCache::setMaximumCacheSize(10000);
+        for (int i = 0; i < 8; ++i) {
+            store(cache, QUrl(QStringLiteral("https://example.com/%1").arg(i)), payload);
+            QTest::qWait(5);
+        }
+
+        // using the oldest entry makes it the most recently used
+        QCOMPARE(load(cache, QUrl("https://example.com/0")), payload);
+        QTest::qWait(5);
+        for (int i = 8; i < 12; ++i) {
+            store(cache, QUrl(QStringLiteral("https://example.com/%1").arg(i)), payload);
+            QTest::qWait(5);
+        }
+
+        QVERIFY(cache.cacheSize() <= FeedCore::SharedCache::maximumCacheSize());
+        QVERIFY(cache.metaData(QUrl("https://example.com/0")).isValid());
+        QVERIFY(!cache.metaData(QUrl("https://example.com/1")).isValid());
+        QVERIFY(cache.metaData(QUrl("https://example.com/11")).isValid());
+    }
+};
+
+QTEST_MAIN(testSharedCache)
+
+#include "tst_sharedcache.moc"
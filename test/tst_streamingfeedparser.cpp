@@ -0,0 +1,230 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "replayfixtures.h"
+#include "streamingfeedparser.h"
+#include <QTemporaryDir>
+#include <Syndication/ParserCollection>
+#include <Syndication/Person>
+
+using namespace FeedCore;
+
+static const QByteArray kRssFeed(
+    "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+    "<rss version=\"2.0\" xmlns:content=\"http://purl.org/rss/1.0/modules/content/\" xmlns:dc=\"http://purl.org/dc/elements/1.1/\">"
+    "<channel>"
+    "  <title>RSS Feed</title>"
+    "  <link>https://example.org/</link>"
+    "  <image><url>https://example.org/logo.png</url></image>"
+    "  <item>"
+    "    <title>First &amp; foremost</title>"
+    "    <link>https://example.org/first</link>"
+    "    <guid isPermaLink=\"false\">first-id</guid>"
+    "    <pubDate>Sun, 01 Jan 2023 12:00:00 GMT</pubDate>"
+    "    <description>&lt;p&gt;Summary&lt;/p&gt;</description>"
+    "    <content:encoded><![CDATA[<p>Full text</p>]]></content:encoded>"
+    "    <dc:creator>Jane Doe</dc:creator>"
+    "  </item>"
+    "  <item>"
+    "    <title>Second</title>"
+    "    <guid>https://example.org/second</guid>"
+    "    <author>john@example.org (John Doe)</author>"
+    "  </item>"
+    "</channel>"
+    "</rss>");
+
+static const QByteArray kAtomFeed(
+    "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+    "<feed xmlns=\"http://www.w3.org/2005/Atom\">"
+    "  <title>Atom Feed</title>"
+    "  <link href=\"https://example.org/\"/>"
+    "  <icon>/favicon.ico</icon>"
+    "  <entry>"
+    "    <title type=\"text\">1 &lt; 2</title>"
+    "    <link rel=\"self\" href=\"https://example.org/self\"/>"
+    "    <link href=\"/article\"/>"
+    "    <id>urn:article</id>"
+    "    <updated>2023-01-02T12:00:00Z</updated>"
+    "    <author><name>Jane Doe</name><email>jane@example.org</email></author>"
+    "    <content type=\"xhtml\"><div xmlns=\"http://www.w3.org/1999/xhtml\"><p>Hello<br/>world</p></div></content>"
+    "  </entry>"
+    "</feed>");
+
+static QByteArray rssFeed(int itemCount)
+{
+    QByteArray result("<rss version=\"2.0\"><channel><title>Big Feed</title>");
+    for (int i = 0; i < itemCount; ++i) {
+        result += QStringLiteral("<item><title>Item %1</title><guid>item-%1</guid></item>").arg(i).toUtf8();
+    }
+    result += "</channel></rss>";
+    return result;
+}
+
+class testStreamingFeedParser : public QObject
+{
+    Q_OBJECT
+
+    static QList<Syndication::ItemPtr> parseByteByByte(StreamingFeedParser &parser, const QByteArray &document)
+    {
+        QList<Syndication::ItemPtr> result;
+        for (const char byte : document) {
+            parser.addData(QByteArray(1, byte));
+            result << parser.takeItems();
+        }
+        parser.finish();
+        result << parser.takeItems();
+        return result;
+    }
+
+private slots:
+    void testRssByteByByte()
+    {
+        StreamingFeedParser parser;
+        const auto items = parseByteByByte(parser, kRssFeed);
+        QVERIFY(!parser.hasError());
+        QCOMPARE(parser.feed()->title(), QStringLiteral("RSS Feed"));
+        QCOMPARE(parser.feed()->link(), QStringLiteral("https://example.org/"));
+        QCOMPARE(parser.feed()->image()->url(), QStringLiteral("https://example.org/logo.png"));
+        QCOMPARE(items.size(), 2);
+
+        QCOMPARE(items[0]->id(), QStringLiteral("first-id"));
+        QCOMPARE(items[0]->title(), QStringLiteral("First &amp; foremost"));
+        QCOMPARE(items[0]->link(), QStringLiteral("https://example.org/first"));
+        QCOMPARE(items[0]->description(), QStringLiteral("<p>Summary</p>"));
+        QCOMPARE(items[0]->content(), QStringLiteral("<p>Full text</p>"));
+        QCOMPARE(items[0]->datePublished(), time_t(1672574400));
+        QCOMPARE(items[0]->dateUpdated(), items[0]->datePublished());
+        QCOMPARE(items[0]->authors().value(0)->name(), QStringLiteral("Jane Doe"));
+
+        QCOMPARE(items[1]->id(), QStringLiteral("https://example.org/second"));
+        QCOMPARE(items[1]->link(), QStringLiteral("https://example.org/second"));
+        QCOMPARE(items[1]->authors().value(0)->name(), QStringLiteral("John Doe"));
+        QCOMPARE(items[1]->authors().value(0)->email(), QStringLiteral("john@example.org"));
+    }
+
+    void testAtomByteByByte()
+    {
+        StreamingFeedParser parser(QUrl("https://example.org/feed.xml"));
+        const auto items = parseByteByByte(parser, kAtomFeed);
+        QVERIFY(!parser.hasError());
+        QCOMPARE(parser.feed()->title(), QStringLiteral("Atom Feed"));
+        QCOMPARE(parser.feed()->icon()->url(), QStringLiteral("https://example.org/favicon.ico"));
+        QCOMPARE(items.size(), 1);
+        QCOMPARE(items[0]->id(), QStringLiteral("urn:article"));
+        QCOMPARE(items[0]->title(), QStringLiteral("1 &lt; 2"));
+        QCOMPARE(items[0]->link(), QStringLiteral("https://example.org/article"));
+        QCOMPARE(items[0]->content(), QStringLiteral("<div><p>Hello<br/>world</p></div>"));
+        QCOMPARE(items[0]->dateUpdated(), time_t(1672660800));
+        QCOMPARE(items[0]->datePublished(), items[0]->dateUpdated());
+        QCOMPARE(items[0]->authors().value(0)->name(), QStringLiteral("Jane Doe"));
+        QCOMPARE(items[0]->authors().value(0)->email(), QStringLiteral("jane@example.org"));
+    }
+
+    void testHeadEndsAtFirstItem()
+    {
+        StreamingFeedParser parser;
+        parseByteByByte(parser, kAtomFeed);
+        QVERIFY(parser.head().contains("<icon>"));
+        QVERIFY(!parser.head().contains("</entry>"));
+    }
+
+    void testItemWithoutIdGetsHash()
+    {
+        const QByteArray document("<rss version=\"2.0\"><channel><item><title>No id</title></item><item><title>No id</title></item></channel></rss>");
+        const auto feed = StreamingFeedParser::parse(document);
+        QVERIFY(!feed.isNull());
+        QCOMPARE(feed->items().size(), 2);
+        QVERIFY(feed->items()[0]->id().startsWith("hash:"));
+        QCOMPARE(feed->items()[0]->id(), feed->items()[1]->id());
+    }
+
+    void testIdsMatchSyndication_data()
+    {
+        QTest::addColumn<QByteArray>("document");
+
+        QTest::newRow("rss") << QByteArray(
+            "<rss version=\"2.0\" xmlns:content=\"http://purl.org/rss/1.0/modules/content/\"><channel><title>Feed</title>"
+            "<item><title>Title only</title></item>"
+            "<item><title>Linked</title><link>https://example.org/linked</link></item>"
+            "<item><description>&lt;p&gt;Summary &amp;amp; more&lt;/p&gt;</description><content:encoded><![CDATA[<p>Full</p>]]></content:encoded></item>"
+            "<item><title>With guid</title><guid>guid-1</guid></item>"
+            "</channel></rss>");
+        QTest::newRow("atom") << QByteArray(
+            "<feed xmlns=\"http://www.w3.org/2005/Atom\"><title>Feed</title>"
+            "<entry><title>1 &lt; 2</title><link href=\"https://example.org/entry\"/></entry>"
+            "<entry><title type=\"html\">&lt;b&gt;Bold&lt;/b&gt;</title><summary>Summary</summary><content type=\"html\">&lt;p&gt;Full&lt;/p&gt;</content></entry>"
+            "<entry><title>With id</title><id>urn:entry</id></entry>"
+            "</feed>");
+    }
+
+    void testIdsMatchSyndication()
+    {
+        QFETCH(QByteArray, document);
+        const QString url = QStringLiteral("https://example.org/feed.xml");
+        const Syndication::FeedPtr expected = Syndication::parserCollection()->parse({document, url});
+        const Syndication::FeedPtr actual = StreamingFeedParser::parse(document, QUrl(url));
+        QVERIFY(!expected.isNull());
+        QVERIFY(!actual.isNull());
+        QCOMPARE(actual->items().size(), expected->items().size());
+        for (int i = 0; i < expected->items().size(); ++i) {
+            QCOMPARE(actual->items()[i]->id(), expected->items()[i]->id());
+        }
+    }
+
+    void testWebPageIsNotAFeed()
+    {
+        StreamingFeedParser parser;
+        parser.addData("<html><head><title>Not a feed</title></head>");
+        QVERIFY(!parser.isFeed());
+        QVERIFY(parser.hasError());
+        QVERIFY(StreamingFeedParser::parse("<html><body></body></html>").isNull());
+    }
+
+    void testTruncatedFeed()
+    {
+        StreamingFeedParser parser;
+        parser.addData(kRssFeed.left(kRssFeed.indexOf("</item>") + 7));
+        QVERIFY(parser.isFeed());
+        QVERIFY(!parser.hasError());
+        QCOMPARE(parser.takeItems().size(), 1);
+        parser.finish();
+        QVERIFY(parser.hasError());
+    }
+
+    void testParseMatchesIncremental()
+    {
+        const QByteArray document = rssFeed(1000);
+        const auto feed = StreamingFeedParser::parse(document);
+        QVERIFY(!feed.isNull());
+        QCOMPARE(feed->items().size(), 1000);
+        QCOMPARE(feed->items().last()->id(), QStringLiteral("item-999"));
+    }
+
+    void testLargeFeedIsStreamed()
+    {
+        QTemporaryDir dir;
+        const QUrl url("https://example.org/big.xml");
+        const QByteArray &body = rssFeed(250);
+        addFeed(dir.path(), url, body, "application/rss+xml");
+        auto *nam = new ReplayNetworkAccessManager(dir.path());
+        nam->setBandwidth(body.size() * 4);
+        NetworkAccessManager::setInstance(nam);
+        UpdatableFeed::setStreamingThreshold(1024);
+
+        RecordingFeed feed;
+        feed.setUrl(url);
+        for (int i = 0; i < 2; ++i) {
+            feed.articleIds.clear();
+            updateFeed(feed);
+            QCOMPARE(feed.articleIds.size(), 250);
+            QCOMPARE(feed.articleIds.last(), QStringLiteral("item-249"));
+            QCOMPARE(feed.updater()->stats().itemCount, 250);
+        }
+        UpdatableFeed::setStreamingThreshold(UpdatableFeed::kDefaultStreamingThreshold);
+    }
+};
+
+QTEST_MAIN(testStreamingFeedParser)
+#include "tst_streamingfeedparser.moc"
@@ -47,7 +47,7 @@ private slots:
         notQuiteStaleFeed.setLastUpdate(lastUpdate);
         notQuiteStaleFeed.setUpdateInterval(updateInterval);
         scheduler->schedule(&notQuiteStaleFeed);
-        scheduler->start(1);
+        scheduler->start();
         QVERIFY(notQuiteStaleFeed.status() == FeedCore::Feed::Idle);
         QSignalSpy waitForStatusChange(&notQuiteStaleFeed, &FeedCore::Feed::statusChanged);
         bool gotSignal = waitForStatusChange.wait();
@@ -74,7 +74,7 @@ private slots:
         feed2.setLastUpdate(lastUpdate);
         feed2.setUpdateInterval(longerUpdateInterval);
         scheduler->schedule(&feed2);
-        scheduler->start(1);
+        scheduler->start();
 
         QVERIFY(feed1.status() == FeedCore::Feed::Idle);
         QVERIFY(feed2.status() == FeedCore::Feed::Idle);
@@ -89,6 +89,30 @@ private slots:
         QVERIFY(feed2.status() == FeedCore::Feed::Idle);
     }
 
+    void testEarlierFeedUpdatedFirst()
+    {
+        const QDateTime lastUpdate = QDateTime::currentDateTime();
+
+        MockFeed laterFeed;
+        laterFeed.setLastUpdate(lastUpdate);
+        laterFeed.setUpdateInterval(30);
+        scheduler->schedule(&laterFeed);
+
+        MockFeed earlierFeed;
+        earlierFeed.setLastUpdate(lastUpdate);
+        earlierFeed.setUpdateInterval(1);
+        scheduler->schedule(&earlierFeed);
+        scheduler->start();
+
+        QSignalSpy waitForStatusChange(&earlierFeed, &FeedCore::Feed::statusChanged);
+        bool gotSignal = waitForStatusChange.wait();
+        QVERIFY(gotSignal);
+        QVERIFY(earlierFeed.status() == FeedCore::Feed::Updating);
+        QVERIFY(laterFeed.status() == FeedCore::Feed::Idle);
+        QVERIFY(laterFeed.m_updater.m_call_count == 0);
+        earlierFeed.m_updater.finish();
+    }
+
     void testFeedNotScheduledWhileBeingUpdated()
     {
         MockFeed feedWithShortUpdateInterval;
@@ -96,7 +120,7 @@ private slots:
         feedWithShortUpdateInterval.setLastUpdate(lastUpdate);
         feedWithShortUpdateInterval.setUpdateInterval(1);
         scheduler->schedule(&feedWithShortUpdateInterval);
-        scheduler->start(1);
+        scheduler->start();
 
         QSignalSpy waitForStatusChange(&feedWithShortUpdateInterval, &FeedCore::Feed::statusChanged);
         bool gotFirstSignal = waitForStatusChange.wait();
@@ -130,7 +154,7 @@ private slots:
         feed.setLastUpdate(lastUpdate);
         feed.setUpdateInterval(1);
         scheduler->schedule(&feed);
-        scheduler->start(1);
+        scheduler->start();
         feed.m_updater.start();
         scheduler->unschedule(&feed);
         feed.m_updater.finish();
@@ -149,7 +173,7 @@ private slots:
         feed.setLastUpdate(lastUpdate);
         feed.setUpdateInterval(1);
         scheduler->schedule(&feed);
-        scheduler->start(1);
+        scheduler->start();
         feed.m_updater.start(timestamp);
         feed.m_updater.finish();
         QVERIFY(feed.lastUpdate() == timestamp);
@@ -172,7 +196,7 @@ private slots:
         feed.setLastUpdate(lastUpdate);
         feed.setUpdateInterval(1);
         scheduler->schedule(&feed);
-        scheduler->start(1);
+        scheduler->start();
         QVERIFY(feed.status() == FeedCore::Feed::Updating);
         feed.m_updater.setError("error");
         QVERIFY(feed.status() == FeedCore::Feed::Error);
@@ -192,7 +216,7 @@ private slots:
         feed.setLastUpdate(lastUpdate);
         feed.setUpdateInterval(1);
         scheduler->schedule(&feed);
-        scheduler->start(1);
+        scheduler->start();
         QVERIFY(feed.status() == FeedCore::Feed::Updating);
         feed.m_updater.setError("error");
         QVERIFY(feed.status() == FeedCore::Feed::Error);
@@ -202,6 +226,91 @@ private slots:
         QVERIFY(feed.m_updater.m_call_count == 2);
     }
 
+    void testRetryDelayBacksOffAfterRepeatedErrors()
+    {
+        const QDateTime timestamp = QDateTime::currentDateTime();
+        MockFeed feed;
+        feed.setLastUpdate(timestamp.addSecs(-10));
+        feed.setUpdateInterval(60);
+
+        feed.m_updater.start(timestamp);
+        feed.m_updater.setError("error");
+        QVERIFY(feed.failureCount() == 1);
+        QVERIFY(feed.retryTime() == timestamp.addSecs(60));
+
+        feed.m_updater.start(timestamp);
+        feed.m_updater.setError("error");
+        QVERIFY(feed.failureCount() == 2);
+        QVERIFY(feed.retryTime() == timestamp.addSecs(120));
+
+        feed.m_updater.start(timestamp);
+        feed.m_updater.setError("error");
+        QVERIFY(feed.failureCount() == 3);
+        QVERIFY(feed.retryTime() == timestamp.addSecs(240));
+
+        feed.m_updater.start(timestamp);
+        feed.m_updater.finish();
+        QVERIFY(feed.failureCount() == 0);
+        QVERIFY(!feed.retryTime().isValid());
+    }
+
+    void testRetryAfterDelaysRetry()
+    {
+        const QDateTime timestamp = QDateTime::currentDateTime();
+        const QDateTime retryAfter = timestamp.addSecs(3600);
+        MockFeed feed;
+        feed.setLastUpdate(timestamp.addSecs(-10));
+        feed.setUpdateInterval(1);
+        scheduler->schedule(&feed);
+        scheduler->start();
+        QVERIFY(feed.status() == FeedCore::Feed::Updating);
+        feed.m_updater.setError("error", retryAfter);
+        QVERIFY(feed.retryTime() == retryAfter);
+
+        scheduler->clearErrors();
+        QVERIFY(feed.status() == FeedCore::Feed::Error);
+        QVERIFY(feed.m_updater.m_call_count == 1);
+    }
+
+    void testBackoffSurvivesReload()
+    {
+        const QDateTime timestamp = QDateTime::currentDateTime();
+        MockFeed feed;
+        feed.setLastUpdate(timestamp.addSecs(-10));
+        feed.setUpdateInterval(1);
+        feed.setFailureCount(3);
+        feed.setRetryTime(timestamp.addSecs(3600));
+        scheduler->start();
+        scheduler->schedule(&feed, timestamp);
+        QVERIFY(feed.status() == FeedCore::Feed::Idle);
+        QVERIFY(feed.m_updater.m_call_count == 0);
+    }
+
+    void testAdaptiveIntervalFollowsPublishingRate()
+    {
+        const QDateTime timestamp = QDateTime::currentDateTime();
+        QList<QDateTime> hourly;
+        for (int i = 1; i <= 10; ++i) {
+            hourly << timestamp.addSecs(-i * 3600);
+        }
+        QVERIFY(FeedCore::Scheduler::adaptiveUpdateInterval(hourly, timestamp) == 3600);
+    }
+
+    void testAdaptiveIntervalIsBounded()
+    {
+        using FeedCore::Scheduler;
+        const QDateTime timestamp = QDateTime::currentDateTime();
+        QList<QDateTime> busy;
+        for (int i = 1; i <= 10; ++i) {
+            busy << timestamp.addSecs(-i);
+        }
+        QVERIFY(Scheduler::adaptiveUpdateInterval(busy, timestamp) == Scheduler::kMinAdaptiveInterval);
+
+        const QList<QDateTime> dormant{timestamp.addYears(-1)};
+        QVERIFY(Scheduler::adaptiveUpdateInterval(dormant, timestamp) == Scheduler::kMaxAdaptiveInterval);
+        QVERIFY(Scheduler::adaptiveUpdateInterval({}, timestamp) == Scheduler::kMaxAdaptiveInterval);
+    }
+
     void testFeedsWithSameUpdateIntervalAreUpdatedTogether()
     {
         const QDateTime timestamp = QDateTime::currentDateTime();
@@ -0,0 +1,95 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "mockfeed.h"
+#include "scheduler.h"
+#include "updatehints.h"
+#include <QTimeZone>
+#include <QtTest>
+
+using FeedCore::UpdateHints;
+
+static const QByteArray kHintedFeed = R"(<?xml version="1.0"?>
+<rss version="2.0" xmlns:sy="http://purl.org/rss/1.0/modules/syndication/">
+  <channel>
+    <title>Hinted Feed</title>
+    <ttl>90</ttl>
+    <sy:updatePeriod>hourly</sy:updatePeriod>
+    <sy:updateFrequency>2</sy:updateFrequency>
+    <skipHours><hour>0</hour><hour>1</hour></skipHours>
+    <skipDays><day>Sunday</day></skipDays>
+    <item><title>Item</title><ttl>5</ttl></item>
+  </channel>
+</rss>)";
+
+class testUpdateHints : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testReadsChannelHints()
+    {
+        const QDateTime timestamp = QDateTime::currentDateTime();
+        const UpdateHints hints = UpdateHints::fromResponse(kHintedFeed, QDateTime(), timestamp);
+        QVERIFY(hints.notBefore == timestamp.addSecs(90 * 60));
+        QVERIFY(hints.skipHours == 0b11);
+        QVERIFY(hints.skipDays == 1 << (Qt::Sunday - 1));
+    }
+
+    void testCacheExpiryRaisesFloor()
+    {
+        const QDateTime timestamp = QDateTime::currentDateTime();
+        const UpdateHints hints = UpdateHints::fromResponse(kHintedFeed, timestamp.addSecs(3 * 60 * 60), timestamp);
+        QVERIFY(hints.notBefore == timestamp.addSecs(3 * 60 * 60));
+
+        const UpdateHints clamped = UpdateHints::fromResponse(QByteArray(), timestamp.addDays(30), timestamp);
+        QVERIFY(clamped.notBefore == timestamp.addDays(1));
+    }
+
+    void testNextAllowedTimeSkipsHoursAndDays()
+    {
+        UpdateHints hints;
+        hints.skipHours = 0b11;
+        hints.skipDays = 1 << (Qt::Sunday - 1);
+
+        // Saturday 2024-06-01, 23:30 UTC -> skips Sunday entirely
+        const QDateTime saturdayNight(QDate(2024, 6, 1), QTime(23, 30), QTimeZone::utc());
+        QVERIFY(hints.nextAllowedTime(saturdayNight) == saturdayNight);
+        const QDateTime sundayMorning(QDate(2024, 6, 2), QTime(0, 30), QTimeZone::utc());
+        QVERIFY(hints.nextAllowedTime(sundayMorning) == QDateTime(QDate(2024, 6, 3), QTime(2, 0), QTimeZone::utc()));
+    }
+
+    void testParseHttpDate()
+    {
+        const QDateTime date = UpdateHints::parseHttpDate("Wed, 21 Oct 2015 07:28:00 GMT");
+        QVERIFY(date == QDateTime(QDate(2015, 10, 21), QTime(7, 28), QTimeZone::utc()));
+        QVERIFY(!UpdateHints::parseHttpDate("soon").isValid());
+    }
+
+    void testSchedulerRespectsHintsForInheritedInterval()
+    {
+        const QDateTime timestamp = QDateTime::currentDateTime();
+        MockFeed feed;
+        feed.setLastUpdate(timestamp.addSecs(-10));
+        feed.setUpdateInterval(1);
+        UpdateHints hints;
+        hints.notBefore = timestamp.addSecs(3600);
+        feed.setUpdateHints(hints);
+
+        FeedCore::Scheduler scheduler;
+        scheduler.start();
+        scheduler.schedule(&feed, timestamp);
+        QVERIFY(feed.status() == FeedCore::Feed::Idle);
+
+        // a user-chosen interval takes precedence over the hints
+        feed.setUpdateMode(FeedCore::Feed::OverrideUpdateMode);
+        scheduler.unschedule(&feed);
+        scheduler.schedule(&feed, timestamp);
+        QVERIFY(feed.status() == FeedCore::Feed::Updating);
+    }
+};
+
+QTEST_MAIN(testUpdateHints)
+
+#include "tst_updatehints.moc"
@@ -0,0 +1,94 @@
+/**
+ * SPDX-FileCopyrightText: 2026 Connor Carney <hello@connorcarney.com>
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "mockfeed.h"
+#include "mockstorage.h"
+#include "updatepacer.h"
+#include <QCoreApplication>
+#include <QSignalSpy>
+#include <QtTest>
+
+static constexpr const int kLongWindow = 60000;
+
+class testUpdatePacer : public QObject
+{
+    Q_OBJECT
+    MockStorage *storage{nullptr};
+    FeedCore::UpdatePacer *pacer{nullptr};
+
+private slots:
+    void init()
+    {
+        storage = new MockStorage;
+        pacer = new FeedCore::UpdatePacer(storage);
+    }
+
+    void cleanup()
+    {
+        delete pacer;
+        delete storage;
+    }
+
+    void testPacedUpdatesStartWithinWindow()
+    {
+        pacer->setWindow(500);
+        MockFeed feeds[3];
+        for (int i = 0; i < 3; ++i) {
+            feeds[i].setUrl(QUrl(QString("https://feed-%1.example/").arg(i)));
+            feeds[i].m_updater.startPaced(pacer);
+            QVERIFY(feeds[i].status() == FeedCore::Feed::Updating);
+        }
+        QVERIFY(pacer->pendingCount() == 3);
+        QVERIFY(QTest::qWaitFor([&feeds] {
+            return feeds[0].m_updater.m_call_count == 1 && feeds[1].m_updater.m_call_count == 1 && feeds[2].m_updater.m_call_count == 1;
+        }));
+        QVERIFY(pacer->pendingCount() == 0);
+    }
+
+    void testAbortWithdrawsPendingUpdate()
+    {
+        pacer->setWindow(kLongWindow);
+        MockFeed feed;
+        feed.setUrl(QUrl("https://feed.example/"));
+        feed.m_updater.startPaced(pacer);
+        QVERIFY(feed.status() == FeedCore::Feed::Updating);
+        feed.m_updater.abort();
+        QVERIFY(feed.status() == FeedCore::Feed::Idle);
+        QVERIFY(pacer->pendingCount() == 0);
+        QVERIFY(feed.m_updater.m_call_count == 0);
+    }
+
+    void testStartJumpsQueue()
+    {
+        pacer->setWindow(kLongWindow);
+        MockFeed feed;
+        feed.setUrl(QUrl("https://feed.example/"));
+        feed.m_updater.startPaced(pacer);
+        QVERIFY(feed.m_updater.m_call_count == 0);
+        feed.m_updater.start();
+        QVERIFY(feed.m_updater.m_call_count == 1);
+        QVERIFY(pacer->pendingCount() == 0);
+    }
+
+    void testBacklogHoldsUpdates()
+    {
+        pacer->setWindow(0);
+        storage->m_pendingTasks = pacer->maxBacklog() + 1;
+        MockFeed feed;
+        feed.setUrl(QUrl("https://feed.example/"));
+        feed.m_updater.startPaced(pacer);
+        QTest::qWait(500);
+        QVERIFY(feed.m_updater.m_call_count == 0);
+
+        storage->m_pendingTasks = 0;
+        QVERIFY(QTest::qWaitFor([&feed] {
+            return feed.m_updater.m_call_count == 1;
+        }));
+    }
+};
+
+QTEST_MAIN(testUpdatePacer)
+
+#include "tst_updatepacer.moc"